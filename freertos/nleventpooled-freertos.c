@@ -78,6 +78,14 @@ int nlevent_pool_create(void *aPoolMemory, int32_t aPoolMemorySize, nlevent_pool
     return retval;
 }
 
+/* The pool is a FreeRTOS queue of pointers to events of a single size;
+ * size classes are not supported.
+ */
+int nlevent_pool_create_sized(void *aPoolMemory, int32_t aPoolMemorySize, const nlevent_pool_size_class_t *aSizeClasses, size_t aSizeClassCount, nlevent_pool_t *aPoolObj)
+{
+    return NLER_ERROR_NOT_IMPLEMENTED;
+}
+
 void nlevent_pool_destroy(nlevent_pool_t *aPool)
 {
 }
@@ -95,6 +103,22 @@ nlevent_pooled_t *nlevent_pool_get_event(nlevent_pool_t *aPool)
     return retval;
 }
 
+nlevent_pooled_t *nlevent_pool_get_event_sized(nlevent_pool_t *aPool, size_t aSize)
+{
+    nlevent_pooled_t       *retval = NULL;
+
+    if (aSize <= sizeof(nlevent_pooled_t))
+    {
+        retval = nlevent_pool_get_event(aPool);
+    }
+    else
+    {
+        NL_LOG_CRIT(lrERPOOLED, "event pool (%p) has no events of %u bytes\n", aPool, (unsigned)aSize);
+    }
+
+    return retval;
+}
+
 void nlevent_pool_recycle_event(nlevent_pool_t *aPool, nlevent_pooled_t *aEvent)
 {
     portBASE_TYPE   err;
@@ -23,6 +23,7 @@
  *
  */
 
+#include "nlercfg.h"
 #include "nlereventqueue.h"
 #include "FreeRTOS.h"
 #include "task.h"
@@ -105,6 +106,66 @@ void nleventqueue_disable_event_counting(nleventqueue_t *aEventQueue)
 #endif
 }
 
+/* A FreeRTOS queue is the native queue object itself and has nowhere
+ * to keep a policy, watermarks or statistics, nor a way to displace or
+ * search its pending events; only the default behavior is supported.
+ * There are no file descriptors to poll, either.
+ */
+int nleventqueue_set_overflow_policy(nleventqueue_t *aEventQueue, nleventqueue_overflow_policy_t aPolicy)
+{
+    int retval = NLER_ERROR_NOT_IMPLEMENTED;
+
+    (void)aEventQueue;
+
+    if (aPolicy == NLER_EVENTQUEUE_OVERFLOW_FAIL)
+    {
+        retval = NLER_SUCCESS;
+    }
+    else if (aPolicy > NLER_EVENTQUEUE_OVERFLOW_CONFLATE)
+    {
+        retval = NLER_ERROR_BAD_INPUT;
+    }
+
+    return retval;
+}
+
+int nleventqueue_set_watermarks(nleventqueue_t *aEventQueue, uint32_t aLowWatermark, uint32_t aHighWatermark, nleventqueue_watermark_handler_t aHandler, void *aClosure)
+{
+    (void)aEventQueue;
+    (void)aLowWatermark;
+    (void)aHighWatermark;
+    (void)aClosure;
+
+    return ((aHandler == NULL) ? NLER_SUCCESS : NLER_ERROR_NOT_IMPLEMENTED);
+}
+
+int nleventqueue_set_drop_handler(nleventqueue_t *aEventQueue, nleventqueue_drop_handler_t aHandler, void *aClosure)
+{
+    (void)aEventQueue;
+    (void)aHandler;
+    (void)aClosure;
+
+    // only NLER_EVENTQUEUE_OVERFLOW_FAIL is supported, so no event is
+    // ever dropped.
+
+    return NLER_SUCCESS;
+}
+
+int nleventqueue_get_stats(nleventqueue_t *aEventQueue, nleventqueue_stats_t *aOutStats)
+{
+    (void)aEventQueue;
+    (void)aOutStats;
+
+    return NLER_ERROR_NOT_IMPLEMENTED;
+}
+
+int nleventqueue_get_pollable_fd(nleventqueue_t *aEventQueue)
+{
+    (void)aEventQueue;
+
+    return NLER_ERROR_NOT_IMPLEMENTED;
+}
+
 #if NLER_ASSERT_ON_FULL_QUEUE
 static void dump_event_contents(nleventqueue_t *aEventQueue, bool aFromIsr)
 {
@@ -145,19 +206,37 @@ static void dump_event_contents(nleventqueue_t *aEventQueue, bool aFromIsr)
 }
 #endif
 
-int nleventqueue_post_event(nleventqueue_t *aEventQueue, const nl_event_t *aEvent)
+/* FreeRTOS queues have no separate urgent storage; urgent events are
+ * instead sent to the front of the queue. They therefore share the
+ * queue capacity and, amongst themselves, are received newest first.
+ */
+static int nleventqueue_freertos_post_event(nleventqueue_t *aEventQueue, const nl_event_t *aEvent, bool aUrgent, TickType_t aTimeoutTicks)
 {
     int             retval = NLER_SUCCESS;
     portBASE_TYPE   err;
 #if NLER_FEATURE_SIMULATEABLE_TIME
     nleventqueue_freertos_t *sim_queue_info = (nleventqueue_freertos_t *)&aEventQueue->uxDummy8;
 #endif
-    err = xQueueSendToBack((QueueHandle_t) aEventQueue, &aEvent, 0);
+    if (aUrgent)
+    {
+        err = xQueueSendToFront((QueueHandle_t) aEventQueue, &aEvent, 0);
+    }
+    else
+    {
+        err = xQueueSendToBack((QueueHandle_t) aEventQueue, &aEvent, aTimeoutTicks);
+    }
 
-    if (err != pdTRUE)
+    if ((err != pdTRUE) && (aTimeoutTicks != 0))
+    {
+        // a producer that asked to wait for space is being throttled
+        // rather than losing events; don't complain about it.
+
+        retval = NLER_ERROR_NO_RESOURCE;
+    }
+    else if (err != pdTRUE)
     {
-        NL_LOG_CRIT(lrERQUEUE, "attempt to post event %d (%p) to full queue %p from task %s\n",
-                aEvent->mType, aEvent, aEventQueue,
+        NL_LOG_CRIT(lrERQUEUE, "attempt to post %sevent %d (%p) to full queue %p from task %s\n",
+                (aUrgent ? "urgent " : ""), aEvent->mType, aEvent, aEventQueue,
                     nltask_get_current() ? nltask_get_name(nltask_get_current()) : "NONE");
         retval = NLER_ERROR_NO_RESOURCE;
 
@@ -181,6 +260,72 @@ int nleventqueue_post_event(nleventqueue_t *aEventQueue, const nl_event_t *aEven
     return retval;
 }
 
+int nleventqueue_post_event(nleventqueue_t *aEventQueue, const nl_event_t *aEvent)
+{
+    return nleventqueue_freertos_post_event(aEventQueue, aEvent, false, 0);
+}
+
+int nleventqueue_post_event_with_timeout(nleventqueue_t *aEventQueue, const nl_event_t *aEvent, nl_time_ms_t aTimeoutMS)
+{
+    return nleventqueue_freertos_post_event(aEventQueue, aEvent, false, nl_time_ms_to_delay_time_native(aTimeoutMS));
+}
+
+int nleventqueue_post_event_urgent(nleventqueue_t *aEventQueue, const nl_event_t *aEvent)
+{
+    return nleventqueue_freertos_post_event(aEventQueue, aEvent, true, 0);
+}
+
+uint32_t nleventqueue_post_events(nleventqueue_t *aEventQueue, const nl_event_t * const *aEvents, uint32_t aCount)
+{
+    uint32_t        retval = 0;
+#if NLER_FEATURE_SIMULATEABLE_TIME
+    nleventqueue_freertos_t *sim_queue_info = (nleventqueue_freertos_t *)&aEventQueue->uxDummy8;
+#endif
+
+    if ((aEvents == NULL) || (aCount == 0))
+    {
+        return retval;
+    }
+
+    /* FreeRTOS queues offer no bulk send; with the scheduler suspended,
+     * the consumer is readied by the first event but only switched to
+     * once the whole batch is in.
+     */
+    vTaskSuspendAll();
+
+    while ((retval < aCount) && (xQueueSendToBack((QueueHandle_t) aEventQueue, &aEvents[retval], 0) == pdTRUE))
+    {
+        retval++;
+    }
+
+    xTaskResumeAll();
+
+    if (retval < aCount)
+    {
+        NL_LOG_CRIT(lrERQUEUE, "attempt to post %u events (%d first) to full queue %p from task %s\n",
+                    (unsigned)(aCount - retval), aEvents[retval]->mType, aEventQueue,
+                    nltask_get_current() ? nltask_get_name(nltask_get_current()) : "NONE");
+
+#if NLER_ASSERT_ON_FULL_QUEUE
+        NLER_ASSERT(0);
+#endif
+    }
+
+#if NLER_FEATURE_SIMULATEABLE_TIME
+    if (sim_queue_info->count_events)
+    {
+        uint32_t i;
+
+        for (i = 0; i < retval; i++)
+        {
+            nleventqueue_sim_count_inc();
+        }
+    }
+#endif
+
+    return retval;
+}
+
 int nleventqueue_post_event_from_isr(nleventqueue_t *aEventQueue, const nl_event_t *aEvent)
 {
     int             retval = NLER_SUCCESS;
@@ -258,6 +403,68 @@ nl_event_t *nleventqueue_get_event_with_timeout(nleventqueue_t *aEventQueue, nl_
     return nleventqueue_get_event_with_timeout_native(aEventQueue, nl_time_ms_to_delay_time_native(aTimeoutMS));
 }
 
+uint32_t nleventqueue_get_events(nleventqueue_t *aEventQueue, nl_event_t **aOutEvents, uint32_t aMaxEvents, nl_time_ms_t aTimeoutMS)
+{
+    nl_time_native_t    timeout = nl_time_ms_to_delay_time_native(aTimeoutMS);
+    uint32_t            retval = 0;
+
+    /* FreeRTOS queues offer no bulk receive; block only for the first
+     * event and then drain whatever else is already pending.
+     */
+    while ((aOutEvents != NULL) && (retval < aMaxEvents))
+    {
+        aOutEvents[retval] = nleventqueue_get_event_with_timeout_native(aEventQueue, timeout);
+
+        if (aOutEvents[retval] == NULL)
+        {
+            break;
+        }
+
+        retval++;
+        timeout = 0;
+    }
+
+    return retval;
+}
+
+int nleventqueue_select(nleventqueue_t **aEventQueues, size_t aQueueCount, nl_time_ms_t aTimeoutMS)
+{
+    const TickType_t    timeout = nl_time_ms_to_delay_time_native(aTimeoutMS);
+    const TickType_t    start = xTaskGetTickCount();
+    size_t              i;
+    int                 retval = NLER_ERROR_NO_RESOURCE;
+
+    if ((aEventQueues == NULL) || (aQueueCount == 0) || (aQueueCount > NLER_EVENTQUEUE_SELECT_MAX))
+    {
+        return NLER_ERROR_BAD_INPUT;
+    }
+
+    /* Queue sets would require every queue to be added to the set while
+     * empty and configUSE_QUEUE_SETS to be enabled, so this instead
+     * rechecks the queues once per tick.
+     */
+    while (true)
+    {
+        for (i = 0; (i < aQueueCount) && (retval == NLER_ERROR_NO_RESOURCE); i++)
+        {
+            if (uxQueueMessagesWaiting((QueueHandle_t)aEventQueues[i]) > 0)
+            {
+                retval = (int)i;
+            }
+        }
+
+        if ((retval != NLER_ERROR_NO_RESOURCE) ||
+            ((timeout != portMAX_DELAY) && ((xTaskGetTickCount() - start) >= timeout)))
+        {
+            break;
+        }
+
+        vTaskDelay(1);
+    }
+
+    return retval;
+}
+
 uint32_t nleventqueue_get_count(nleventqueue_t *aEventQueue)
 {
     uint32_t retval;
@@ -0,0 +1,232 @@
+/*
+ *
+ *    Copyright (c) 2026 Project nler Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Buffer chains. Bulk data such as audio frames, log chunks or
+ *      packets is held in chains of fixed-size segments taken from a
+ *      buffer pool, such that it may be handed between tasks, split and
+ *      trimmed without being copied.
+ *
+ *      As with events, a chain is passed by pointer, typically in the
+ *      mBuffer field of an NL_EVENT_T_BUFFER event or in the mPayload
+ *      field of a pooled event. Whoever holds a reference to a chain is
+ *      responsible for freeing it or handing it on.
+ *
+ */
+
+#ifndef NL_ER_BUFFER_H
+#define NL_ER_BUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "nlerevent.h"
+#include "nlerlock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Buffer segment. A chain is a list of segments linked through mNext
+ * and is referred to by its first segment.
+ *
+ * Each segment counts its references, the chain linking to it being
+ * one of them. Freeing a chain releases a reference to its first
+ * segment and, once that segment is no longer referenced, moves on to
+ * the next, such that chains may share their tails.
+ *
+ * The data of a segment may live in the storage of another segment once
+ * a chain has been split in the middle of that segment; the storage
+ * returns to the pool once no segment uses it.
+ *
+ * Adjusting, trimming and splitting modify segments in place and are
+ * only for the holder of the sole reference to a chain.
+ */
+typedef struct nl_buffer_s
+{
+    struct nl_buffer_s      *mNext;             /**< Next segment of the chain, or NULL. */
+    uint8_t                 *mData;             /**< First byte of data in this segment. */
+    uint16_t                 mLength;           /**< Bytes of data in this segment. */
+    int32_t                  mRefCount;         /**< References to this segment. */
+    int32_t                  mStorageRefCount;  /**< Segments using this segment's storage. Treat as opaque. */
+    struct nl_buffer_s      *mOwner;            /**< Segment whose storage mData points into. Treat as opaque. */
+    struct nl_buffer_pool_s *mPool;             /**< Pool the segment returns to. Treat as opaque. */
+} nl_buffer_t;
+
+/** Buffer pool. Treat as opaque.
+ */
+typedef struct nl_buffer_pool_s
+{
+    nllock_t                 mLock;
+    nl_buffer_t             *mFree;
+    uint16_t                 mSegmentSize;
+} nl_buffer_pool_t;
+
+/** Buffer event. Carries a chain, the reference to which passes to the
+ * recipient along with the event.
+ */
+typedef struct nl_event_buffer_s
+{
+    NL_DECLARE_EVENT;                   /**< Common event fields. */
+    nl_buffer_t         *mBuffer;       /**< Chain carried by the event. */
+} nl_event_buffer_t;
+
+/** Create a buffer pool.
+ *
+ * @param[in, out] aPoolMemory A block of memory from which all of the
+ * segments will be carved. As many segments as can fit in that memory
+ * will be available in the pool.
+ *
+ * @param[in] aPoolMemorySize Size in bytes of aPoolMemory.
+ *
+ * @param[in] aSegmentSize Bytes of data, headroom included, that each
+ * segment holds. Must be at most UINT16_MAX.
+ *
+ * @param[out] aPool The pool to create.
+ *
+ * @return NLER_SUCCESS if the pool was created, NLER_ERROR_BAD_INPUT if
+ * aPoolMemory cannot hold a single segment, otherwise an error code.
+ */
+int nl_buffer_pool_create(void *aPoolMemory, size_t aPoolMemorySize, size_t aSegmentSize, nl_buffer_pool_t *aPool);
+
+/** Destroy a buffer pool. Chains still taken from it must not be used
+ * afterwards.
+ *
+ * @param[in, out] aPool The pool to destroy.
+ */
+void nl_buffer_pool_destroy(nl_buffer_pool_t *aPool);
+
+/** Allocate a chain with room for a given number of bytes of data. The
+ * chain has as many segments as the data requires and its length is set
+ * to aLength; the content of the data is undefined.
+ *
+ * @param[in] aPool The pool to take segments from.
+ *
+ * @param[in] aLength Bytes of data the chain must hold.
+ *
+ * @param[in] aHeadroom Bytes to leave ahead of the data in the first
+ * segment, for headers later prepended with nl_buffer_adjust_header().
+ * Must be less than the pool segment size.
+ *
+ * @return the chain, or NULL if the pool has too few segments left.
+ */
+nl_buffer_t *nl_buffer_alloc(nl_buffer_pool_t *aPool, size_t aLength, size_t aHeadroom);
+
+/** Take an additional reference to a chain, for instance before posting
+ * it to a second task. Each reference is released by nl_buffer_free().
+ *
+ * @param[in] aBuffer The chain.
+ */
+void nl_buffer_ref(nl_buffer_t *aBuffer);
+
+/** Release a reference to a chain. Segments no longer referenced return
+ * to their pool.
+ *
+ * @param[in] aBuffer The chain, which may be NULL.
+ */
+void nl_buffer_free(nl_buffer_t *aBuffer);
+
+/** Get the number of bytes of data in a chain.
+ *
+ * @param[in] aBuffer The chain.
+ *
+ * @return the total of the lengths of its segments.
+ */
+size_t nl_buffer_length(const nl_buffer_t *aBuffer);
+
+/** Append a chain to another. The reference to aTail passes to aHead.
+ *
+ * @param[in, out] aHead The chain to append to.
+ *
+ * @param[in] aTail The chain to append.
+ */
+void nl_buffer_cat(nl_buffer_t *aHead, nl_buffer_t *aTail);
+
+/** Move the start of the data in the first segment of a chain.
+ *
+ * @param[in, out] aBuffer The chain.
+ *
+ * @param[in] aDelta Bytes by which to extend the data into the headroom
+ * if positive, or to drop from its front if negative.
+ *
+ * @return NLER_SUCCESS if the data was moved, NLER_ERROR_NO_RESOURCE if
+ * the headroom is too small, or NLER_ERROR_BAD_INPUT if the first
+ * segment holds too little data.
+ */
+int nl_buffer_adjust_header(nl_buffer_t *aBuffer, int32_t aDelta);
+
+/** Shorten a chain, releasing the segments no longer needed.
+ *
+ * @param[in, out] aBuffer The chain.
+ *
+ * @param[in] aLength Bytes of data to keep. Chains no longer than this
+ * are left alone.
+ */
+void nl_buffer_trim(nl_buffer_t *aBuffer, size_t aLength);
+
+/** Split a chain in two. When the split falls inside a segment, the data
+ * after it is not copied; a segment taken from the pool of that segment
+ * refers to it instead.
+ *
+ * @param[in, out] aBuffer The chain, which keeps the first aOffset bytes
+ * of data.
+ *
+ * @param[in] aOffset Bytes of data to keep in aBuffer. Must be non-zero.
+ *
+ * @return the chain holding the rest of the data, or NULL if there is
+ * none or no segment was left to refer to it, in which case aBuffer is
+ * left alone.
+ */
+nl_buffer_t *nl_buffer_split(nl_buffer_t *aBuffer, size_t aOffset);
+
+/** Copy data into a chain.
+ *
+ * @param[in, out] aBuffer The chain.
+ *
+ * @param[in] aOffset Offset in the chain data at which to copy.
+ *
+ * @param[in] aData The data to copy.
+ *
+ * @param[in] aLength Bytes to copy.
+ *
+ * @return the number of bytes copied, which is less than aLength if the
+ * chain is too short.
+ */
+size_t nl_buffer_write(nl_buffer_t *aBuffer, size_t aOffset, const void *aData, size_t aLength);
+
+/** Copy data out of a chain.
+ *
+ * @param[in] aBuffer The chain.
+ *
+ * @param[in] aOffset Offset in the chain data from which to copy.
+ *
+ * @param[out] aData Where to copy the data.
+ *
+ * @param[in] aLength Bytes to copy.
+ *
+ * @return the number of bytes copied, which is less than aLength if the
+ * chain is too short.
+ */
+size_t nl_buffer_read(const nl_buffer_t *aBuffer, size_t aOffset, void *aData, size_t aLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NL_ER_BUFFER_H */
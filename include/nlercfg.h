@@ -44,6 +44,35 @@ extern "C" {
 #define NLER_TIMER_STACK_SIZE 1024
 #endif
 
+/**
+ * Number of timer tasks, or shards, the event timer service runs.
+ * Each has its own queue and timer wheel and serves the timers whose
+ * return queue hashes to it, so starting and cancelling timers from
+ * different tasks need not serialize on a single timer task.
+ */
+#ifndef NLER_TIMER_SHARDS
+#define NLER_TIMER_SHARDS 1
+#endif
+
+/**
+ * Number of expirations a timer task collects in one pass before
+ * delivering them, grouped by return queue, with one batched post per
+ * queue. A burst of simultaneous expirations then costs each consumer
+ * one wakeup per batch rather than one per timer.
+ */
+#ifndef NLER_TIMER_BATCH_SIZE
+#define NLER_TIMER_BATCH_SIZE 16
+#endif
+
+/**
+ * Number of locks resendable timers are spread across by address. A
+ * start, cancel or receive of one timer then only contends with those
+ * of the timers sharing its lock, rather than with those of all.
+ */
+#ifndef NLER_RESENDABLE_TIMER_LOCKS
+#define NLER_RESENDABLE_TIMER_LOCKS 8
+#endif
+
 /**
  * If platforms have not defined optional assert delegate, just trap/fault
  */
@@ -59,6 +88,68 @@ extern "C" {
 #define NLER_ASSERT_ON_FULL_QUEUE 0
 #endif
 
+/**
+ * Maximum number of event queues a task may wait on at once with
+ * nleventqueue_select().
+ */
+#ifndef NLER_EVENTQUEUE_SELECT_MAX
+#define NLER_EVENTQUEUE_SELECT_MAX 8
+#endif
+
+/**
+ * Number of events each event queue can hold in its urgent lane, in
+ * addition to the queue memory supplied by the creator.
+ */
+#ifndef NLER_EVENTQUEUE_URGENT_DEPTH
+#define NLER_EVENTQUEUE_URGENT_DEPTH 4
+#endif
+
+/**
+ * Keep the per-queue statistics reported by nleventqueue_get_stats().
+ * This costs a timestamp per post and per get along with a 32-bit
+ * word of storage per queue slot.
+ */
+#ifndef NLER_EVENTQUEUE_STATS
+#define NLER_EVENTQUEUE_STATS 1
+#endif
+
+/**
+ * Number of per-task caches, or magazines, kept in front of each event
+ * pool where the platform supports them. Tasks are spread across the
+ * magazines; set to 0 to have every task use the shared free list.
+ */
+#ifndef NLER_EVENT_POOL_MAGAZINES
+#define NLER_EVENT_POOL_MAGAZINES 8
+#endif
+
+/**
+ * Number of events each event pool magazine can hold. Half as many
+ * move between a magazine and the shared free list at a time. The
+ * default fills a 64-byte cache line.
+ */
+#ifndef NLER_EVENT_POOL_MAGAZINE_SIZE
+#define NLER_EVENT_POOL_MAGAZINE_SIZE 14
+#endif
+
+/**
+ * Number of levels of the timer wheel. Each level covers
+ * 2^NLER_TIMER_WHEEL_SLOT_BITS times the span of the one below it;
+ * timers further out than the top level covers are parked in its last
+ * slot until they come within range.
+ */
+#ifndef NLER_TIMER_WHEEL_LEVELS
+#define NLER_TIMER_WHEEL_LEVELS 4
+#endif
+
+/**
+ * Log2 of the number of slots in each level of the timer wheel, at
+ * most 6. The default spans 2^24 native ticks over 256 slots; smaller
+ * values trade memory for more cascading.
+ */
+#ifndef NLER_TIMER_WHEEL_SLOT_BITS
+#define NLER_TIMER_WHEEL_SLOT_BITS 6
+#endif
+
 #ifdef __cplusplus
 }
 #endif
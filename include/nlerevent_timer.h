@@ -19,9 +19,9 @@
 /**
  *    @file
  *     Timer events. A timer event is sent to the current task after
- *     the specified timeout. It can be restarted or cancelled, but
- *     these operations must only be called from the same task that
- *     receives the event.
+ *     the specified timeout. It must only be started or restarted
+ *     from the same task that receives the event, but may be
+ *     cancelled from any task.
  *
  */
 
@@ -38,6 +38,21 @@
 extern "C" {
 #endif
 
+/** How a timer started with nl_event_timer_start_at() repeats. Repeating
+ * timers keep to deadlines a whole number of periods from the first,
+ * however late each expiry is handled.
+ *
+ * A timer posted to a queue has at most one event queued at a time, so
+ * for it both repeating modes count the periods missed as overruns, see
+ * nl_event_timer_get_overrun(). The modes differ for callback timers.
+ */
+typedef enum
+{
+    NL_EVENT_TIMER_ONE_SHOT = 0,        /**< Expire once */
+    NL_EVENT_TIMER_REPEAT_SKIP,         /**< Repeat; periods missed while late are skipped */
+    NL_EVENT_TIMER_REPEAT_CATCH_UP      /**< Repeat; a callback timer is called for each period missed while late */
+} nl_event_timer_mode_t;
+
 /** Timer event. Should be initialized using nl_init_event_timer.
  *  Implementation is opaque to the user but defined here so
  *  that the users can provide the memory for timers.
@@ -47,9 +62,9 @@ extern "C" {
 typedef struct
 {
 #ifdef DEBUG
-    uint32_t hidden[10];
+    uint32_t hidden[12];
 #else
-    uint32_t hidden[9];
+    uint32_t hidden[11];
 #endif
 } nl_event_timer_t;
 
@@ -62,23 +77,15 @@ typedef struct
     /* check for 64-bit simulators */
 #if UINTPTR_MAX == 0xffffffff
 #ifdef DEBUG
-#if NLER_FEATURE_SIMULATEABLE_TIME
-    uint32_t hidden[9];
-#else  // NLER_FEATURE_SIMULATEABLE_TIME
-    uint32_t hidden[8];
-#endif // NLER_FEATURE_SIMULATEABLE_TIME
+    uint32_t hidden[16];
 #else  // DEBUG
-    uint32_t hidden[7];
+    uint32_t hidden[15];
 #endif // DEBUG
 #elif UINTPTR_MAX == 0xffffffffffffffff
 #ifdef DEBUG
-#if NLER_FEATURE_SIMULATEABLE_TIME
-    uint32_t hidden[16];
-#else  // NLER_FEATURE_SIMULATEABLE_TIME
-    uint32_t hidden[14];
-#endif // NLER_FEATURE_SIMULATEABLE_TIME
+    uint32_t hidden[26];
 #else  // DEBUG
-    uint32_t hidden[12];
+    uint32_t hidden[24];
 #endif // DEBUG
 #else  // UINTPTR_MAX
     #error Unknown size of ptr
@@ -89,6 +96,8 @@ typedef struct
  * application if the timer service is desired. Generally this is called after
  * nl_er_init() so that log messages are caught.
  *
+ * One timer task is started per NLER_TIMER_SHARDS, all at the same priority.
+ *
  * @param[in] aPriority Task priority for the system timer. Applications can
  * set the priority to whatever is appropriate given the other tasks the
  * application controls.
@@ -100,7 +109,8 @@ void nl_timer_start(nltask_priority_t aPriority);
  *
  * @pre Timer has already been started with nl_timer_start()
  *
- * @return Timer event queue reperesenting the timer service.
+ * @return Timer event queue reperesenting the timer service. With more
+ * than one of NLER_TIMER_SHARDS, this is the queue of the first shard.
  */
 nleventqueue_t *nl_get_timer_queue(void);
 
@@ -115,9 +125,30 @@ nleventqueue_t *nl_get_timer_queue(void);
  * @param[in] aHandlerArg argument to pass to callback function
  *
  * @param[in] aQueue eventqueue to post the event to when the timeout has expired
+ *
+ * A timer that was started must not be initialized again until it
+ * may be reused, see nl_event_timer_cancel().
  */
 void nl_event_timer_init(nl_event_timer_t *aTimer, nl_eventhandler_t aHandler, void *aHandlerArg, nleventqueue_t *aQueue);
 
+/** Initialize a callback timer. Rather than being posted to a queue,
+ * the timer event is handed to aHandler directly on the timer task as
+ * it expires, saving a queue hop and a context switch per expiry.
+ *
+ * The handler must be short and must not block, since it holds up
+ * every other timer, nor start or cancel timers. Its timer events are
+ * never queued, so nl_event_timer_is_valid() is not called for them.
+ * Under the swtimer implementation the handler runs in the swtimer's
+ * context instead.
+ *
+ * @param[in, out] aTimer the timer event to initialize
+ *
+ * @param[in] aHandler callback function to run on expiry. *Must not be NULL*.
+ *
+ * @param[in] aHandlerArg argument to pass to callback function
+ */
+void nl_event_timer_init_callback(nl_event_timer_t *aTimer, nl_eventhandler_t aHandler, void *aHandlerArg);
+
 /** Start or restart a timer.
  *
  * If the timer is not yet running, a timer event will be posted to the event queue
@@ -129,6 +160,8 @@ void nl_event_timer_init(nl_event_timer_t *aTimer, nl_eventhandler_t aHandler, v
  * timer cannot be restarted using this API.  This is checked by a NLER_ASSERT.
  * For swtimer implementation, starting will implicitly call nl_event_timer_cancel.
  *
+ * A repeating timer repeats every aTimeoutMS as NL_EVENT_TIMER_REPEAT_SKIP.
+ *
  * @param[in] aTimer the timer event to start.
  *
  * @param[in] aTimeoutMS Time in milliseconds from now at which the timeout
@@ -138,10 +171,65 @@ void nl_event_timer_init(nl_event_timer_t *aTimer, nl_eventhandler_t aHandler, v
  */
 void nl_event_timer_start(nl_event_timer_t *aTimer, nl_time_ms_t aTimeoutMS, bool aRepeating);
 
+/** Start or restart a timer that may expire late by up to aSlackMS.
+ *
+ * As nl_event_timer_start(), except that the timer engine is free to
+ * post the timer event anywhere from aTimeoutMS to aTimeoutMS plus
+ * aSlackMS after the current time. Expiries are aligned within that
+ * window such that timers with overlapping windows tend to fire
+ * together, saving wakeups of both the timer task and the receivers.
+ * Repeating timers apply the slack to every period.
+ *
+ * The swtimer implementation ignores aSlackMS.
+ *
+ * @param[in] aTimer the timer event to start.
+ *
+ * @param[in] aTimeoutMS Time in milliseconds from now at which the timeout
+ * should occur.
+ *
+ * @param[in] aSlackMS Time in milliseconds by which the timeout may be
+ * delayed.
+ *
+ * @param[in] aRepeating whether the timer is repeating or not.
+ */
+void nl_event_timer_start_with_slack(nl_event_timer_t *aTimer, nl_time_ms_t aTimeoutMS, nl_time_ms_t aSlackMS, bool aRepeating);
+
+/** Start or restart a timer at an absolute deadline.
+ *
+ * The timer event is posted once native time, as returned by
+ * nl_get_time_native(), reaches aDeadline, or at once if it already
+ * has. A repeating timer is then posted at aDeadline plus each
+ * multiple of aPeriodMS, so the handling latency of one expiry does
+ * not push back the next.
+ *
+ * The swtimer implementation schedules relative to the current time
+ * and treats both repeating modes alike.
+ *
+ * @param[in] aTimer the timer event to start.
+ *
+ * @param[in] aDeadline Native time at which the timeout should occur.
+ *
+ * @param[in] aPeriodMS Period in milliseconds of a repeating timer.
+ *
+ * @param[in] aMode whether and how the timer repeats.
+ */
+void nl_event_timer_start_at(nl_event_timer_t *aTimer, nl_time_native_t aDeadline, nl_time_ms_t aPeriodMS, nl_event_timer_mode_t aMode);
+
 /** Cancel a timer that was previously started.
  * The timer event will be marked as cancelled so any instance
  *  of it on an event queue will be considered invalid.
  *
+ * Cancelling is lock-free, never waits and may be done from any task.
+ * It posts nothing to the timer task: a run the timer task has armed
+ * is left in its wheel, and dropped as stale when the timer task next
+ * passes it, on a restart or at its deadline.
+ *
+ * The timer may be started again at once. Its memory may be reused,
+ * or the timer initialized again, once any of its events still queued
+ * have been received and, if it was cancelled ahead of a deadline, the
+ * timer task has passed that deadline. A one-shot timer that expired
+ * may be reused once its event has been received.
+ *
  * @param[in] aTimer the timer event to cancel.
  */
 void nl_event_timer_cancel(nl_event_timer_t *aTimer);
@@ -162,6 +250,23 @@ void nl_event_timer_cancel(nl_event_timer_t *aTimer);
  */
 bool nl_event_timer_is_valid(nl_event_timer_t *aTimer);
 
+/** Returns the overrun count of the timer event last checked by
+ * nl_event_timer_is_valid().
+ *
+ * A timer has at most one event on its queue at a time. Expiries while
+ * that event is pending, periods a repeating timer skips, and events
+ * that did not fit on the queue are instead counted against the event,
+ * as with POSIX timer_getoverrun(). The queue depth thus stays bounded
+ * when the receiver falls behind, while the receiver can still account
+ * for every period.
+ *
+ * @param[in] aTimer the timer event just checked.
+ *
+ * @return the number of expiries missed before the event, saturating
+ * at UINT16_MAX, or 0 if the event was not valid.
+ */
+uint32_t nl_event_timer_get_overrun(nl_event_timer_t *aTimer);
+
 #ifdef __cplusplus
 }
 #endif
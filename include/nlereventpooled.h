@@ -25,6 +25,9 @@
 #ifndef NL_ER_EVENT_POOLED_H
 #define NL_ER_EVENT_POOLED_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "nlerevent.h"
 #include "nlereventqueue.h"
 
@@ -49,6 +52,30 @@ typedef struct nlevent_pooled_s
     void                *mPayload;      /**< Additional data. */
 } nlevent_pooled_t;
 
+/** Multicast event. A pooled event that is posted to several queues at
+ * once with nlevent_multicast_post() and shared, rather than copied,
+ * between their consumers. It returns to its pool once the last of them
+ * has dispatched it with nl_dispatch_event(), so consumers must treat it
+ * as read-only and must not hold on to it past dispatch.
+ */
+typedef struct nlevent_multicast_s
+{
+    NL_DECLARE_EVENT;                   /**< Common event fields. */
+    nleventqueue_t      *mReturnQueue;  /**< Return response queue. */
+    void                *mPayload;      /**< Additional data. */
+    nlevent_pool_t      *mPool;         /**< Pool the event returns to. */
+    int32_t              mRefCount;     /**< Consumers yet to release the event. */
+} nlevent_multicast_t;
+
+/** Event pool size class. Events larger than nlevent_pooled_t must
+ * still begin with its fields.
+ */
+typedef struct nlevent_pool_size_class_s
+{
+    size_t              mEventSize;     /**< Size in bytes of each event in the class. */
+    uint32_t            mEventCount;    /**< Number of events in the class. */
+} nlevent_pool_size_class_t;
+
 /** Create event pool.
  *
  * @param[in, out] aPoolMemory A block of memory from which all of the pooled
@@ -65,6 +92,27 @@ typedef struct nlevent_pooled_s
 
 int nlevent_pool_create(void *aPoolMemory, int32_t aPoolMemorySize, nlevent_pool_t *aPoolObj);
 
+/** Create an event pool with several event size classes.
+ *
+ * @param[in, out] aPoolMemory A block of memory from which all of the pooled
+ * events will be pulled. It is divided between the classes, in order, and
+ * must be large enough to hold all of their events.
+ *
+ * @param[in] aPoolMemorySize Size in bytes of aPoolMemory.
+ *
+ * @param[in] aSizeClasses The size classes, in increasing order of event
+ * size. Each event size must be at least sizeof(nlevent_pooled_t).
+ *
+ * @param[in] aSizeClassCount The number of entries in aSizeClasses.
+ *
+ * @param[in] aPoolObj pointer to storage used for the event pool object
+ *
+ * @return NLER_SUCCESS if the event pool is created succesfully,
+ * NLER_ERROR_NOT_IMPLEMENTED if the platform does not support size
+ * classes, otherwise an error code.
+ */
+int nlevent_pool_create_sized(void *aPoolMemory, int32_t aPoolMemorySize, const nlevent_pool_size_class_t *aSizeClasses, size_t aSizeClassCount, nlevent_pool_t *aPoolObj);
+
 /** Destroy the event pool.
  *
  * @param[in, out] aPool Event pool to destroy.
@@ -79,7 +127,19 @@ void nlevent_pool_destroy(nlevent_pool_t *aPool);
  */
 nlevent_pooled_t *nlevent_pool_get_event(nlevent_pool_t *aPool);
 
-/** Recycle an event to the pool.
+/** Get an event of at least a given size from the event pool. The event
+ * comes from the smallest class it fits in that has events left.
+ *
+ * @param[in] aPool Pool from which to get an event.
+ *
+ * @param[in] aSize Size in bytes the event must have.
+ *
+ * @return An event if there are large enough events in the pool, NULL
+ * otherwise.
+ */
+nlevent_pooled_t *nlevent_pool_get_event_sized(nlevent_pool_t *aPool, size_t aSize);
+
+/** Recycle an event, of any size, to the pool.
  *
  * @param[in, out] aPool The event pool to recycle the event to.
  *
@@ -87,6 +147,45 @@ nlevent_pooled_t *nlevent_pool_get_event(nlevent_pool_t *aPool);
  */
 void nlevent_pool_recycle_event(nlevent_pool_t *aPool, nlevent_pooled_t *aEvent);
 
+/** Get a multicast event from the event pool. The pool must have a size
+ * class large enough for nlevent_multicast_t. The event is initialized
+ * as an NL_EVENT_T_MULTICAST event with no handler; the caller may set
+ * mHandler, mHandlerClosure, mReturnQueue and mPayload before posting it.
+ *
+ * @param[in] aPool Pool from which to get the event.
+ *
+ * @return An event if there are large enough events in the pool, NULL
+ * otherwise.
+ */
+nlevent_multicast_t *nlevent_pool_get_multicast_event(nlevent_pool_t *aPool);
+
+/** Post a multicast event to several queues. Ownership of the event
+ * passes to the queues: it is recycled to its pool once dispatched by
+ * every queue it was posted to, or at once if it could not be posted to
+ * any. The queues must not use an overflow policy that discards events.
+ *
+ * @param[in] aEvent The event to post.
+ *
+ * @param[in] aEventQueues The queues to post the event to.
+ *
+ * @param[in] aQueueCount The number of entries in aEventQueues.
+ *
+ * @return NLER_SUCCESS if the event was posted to every queue,
+ * NLER_ERROR_BAD_INPUT if the arguments are invalid, in which case the
+ * caller keeps the event, otherwise the error of the last queue that
+ * could not take it.
+ */
+int nlevent_multicast_post(nlevent_multicast_t *aEvent, nleventqueue_t * const *aEventQueues, size_t aQueueCount);
+
+/** Release one consumer's reference to a multicast event, recycling it
+ * once none remain. nl_dispatch_event() does this after calling the
+ * handler; call it directly only for an event taken from a queue and
+ * discarded without being dispatched.
+ *
+ * @param[in] aEvent The event to release.
+ */
+void nlevent_multicast_release(nlevent_multicast_t *aEvent);
+
 #ifdef __cplusplus
 }
 #endif
@@ -25,6 +25,7 @@
 #ifndef NL_ER_EVENT_QUEUE_H
 #define NL_ER_EVENT_QUEUE_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
 #include "nlerevent.h"
@@ -40,6 +41,69 @@ extern "C" {
  * to be used for the queue storage. Queues are used as FIFOs.
  */
 
+/** Policies for handling a post to a full queue.
+ */
+typedef enum
+{
+    NLER_EVENTQUEUE_OVERFLOW_FAIL = 0,      /**< Reject the new event with NLER_ERROR_NO_RESOURCE (default) */
+    NLER_EVENTQUEUE_OVERFLOW_DROP_OLDEST,   /**< Discard the oldest pending event to make room; the caller owns the event dropped, see nleventqueue_set_drop_handler() */
+    NLER_EVENTQUEUE_OVERFLOW_DROP_NEWEST,   /**< Discard the new event */
+    NLER_EVENTQUEUE_OVERFLOW_CONFLATE       /**< Discard the new event if it is already pending, else reject it */
+} nleventqueue_overflow_policy_t;
+
+/** Watermark notification function pointer.
+ *
+ * Called in the context of the task whose post or get moved the queue
+ * depth across a watermark, with the queue locked such that successive
+ * notifications are never reordered. It must not block or operate on
+ * the same queue.
+ *
+ * @param[in] aAboveHighWatermark true if the depth has risen to the high
+ * watermark, false if it has since fallen back to the low watermark.
+ *
+ * @param[in] aClosure Data supplied to nleventqueue_set_watermarks().
+ */
+typedef void (*nleventqueue_watermark_handler_t)(bool aAboveHighWatermark, void *aClosure);
+
+/** Drop notification function pointer.
+ *
+ * Called for each event an overflow policy discards, in the context of
+ * the task whose post discarded it and possibly with the queue locked.
+ * It must not block or operate on the same queue.
+ *
+ * The queue no longer refers to the event, which is the handler's to
+ * release: a pooled event to recycle, say, or a timer event to hand to
+ * its receiving task for nl_event_timer_is_valid(), without which the
+ * timer takes it to be still queued.
+ *
+ * @param[in] aEvent The event discarded.
+ *
+ * @param[in] aClosure Data supplied to nleventqueue_set_drop_handler().
+ */
+typedef void (*nleventqueue_drop_handler_t)(nl_event_t *aEvent, void *aClosure);
+
+/** Number of buckets in the sojourn-time histogram of an event queue.
+ */
+#define NLER_EVENTQUEUE_SOJOURN_BUCKETS 24
+
+/** A snapshot of event queue statistics, accumulated since the queue was
+ * created.
+ */
+typedef struct nleventqueue_stats_s
+{
+    uint32_t    mPosts;         /**< Events queued */
+    uint32_t    mGets;          /**< Events received */
+    uint32_t    mRejections;    /**< Events refused, or discarded by the overflow policy, on a full queue */
+    uint32_t    mPeakDepth;     /**< Greatest number of events pending at once */
+
+    /** Received events by time spent pending. Bucket 0 counts events
+     * pending for under a microsecond and bucket i those pending for at
+     * least 2^(i-1) but under 2^i microseconds. The last bucket also
+     * counts all longer times.
+     */
+    uint32_t    mSojournHistogram[NLER_EVENTQUEUE_SOJOURN_BUCKETS];
+} nleventqueue_stats_t;
+
 /** Create an event queue.
  *
  * @param[in] aQueueMemory storage used to hold event pointers in the queue.
@@ -74,6 +138,73 @@ void nleventqueue_destroy(nleventqueue_t *aEventQueue);
  */
 void nleventqueue_disable_event_counting(nleventqueue_t *aEventQueue);
 
+/** Set the policy applied when an event is posted to a full queue.
+ *
+ * The policy lets a queue whose consumer falls behind shed load rather
+ * than fail its producers. Under NLER_EVENTQUEUE_OVERFLOW_CONFLATE, an
+ * event that is already pending in the queue is never queued a second
+ * time, whether or not the queue is full, which suits events that
+ * stand for "something changed" rather than carrying data.
+ *
+ * Events discarded by a policy are not delivered, and the post reports
+ * NLER_SUCCESS as though they were queued. Each is instead handed to
+ * the drop handler, see nleventqueue_set_drop_handler(), and without
+ * one is the caller's to release. The policy does not apply to the
+ * urgent lane.
+ *
+ * @param[in, out] aEventQueue The queue to configure.
+ *
+ * @param[in] aPolicy The overflow policy.
+ *
+ * @return NLER_SUCCESS if the policy was set, NLER_ERROR_BAD_INPUT for
+ * an unknown policy, or NLER_ERROR_NOT_IMPLEMENTED if the platform queue
+ * cannot support it.
+ */
+int nleventqueue_set_overflow_policy(nleventqueue_t *aEventQueue, nleventqueue_overflow_policy_t aPolicy);
+
+/** Request notification as the queue depth crosses watermarks.
+ *
+ * aHandler is called with true once the number of pending events rises
+ * to aHighWatermark and then with false once it falls back to
+ * aLowWatermark, such that an upstream task can throttle itself well
+ * before the queue overflows.
+ *
+ * @param[in, out] aEventQueue The queue to configure.
+ *
+ * @param[in] aLowWatermark depth at or below which the queue is no longer
+ * considered congested.
+ *
+ * @param[in] aHighWatermark depth at or above which the queue is
+ * considered congested. Must exceed aLowWatermark.
+ *
+ * @param[in] aHandler function to notify or NULL to stop notifications.
+ *
+ * @param[in] aClosure data passed to aHandler.
+ *
+ * @return NLER_SUCCESS if the watermarks were set, NLER_ERROR_BAD_INPUT if
+ * they are inconsistent, or NLER_ERROR_NOT_IMPLEMENTED if the platform
+ * queue cannot support them.
+ */
+int nleventqueue_set_watermarks(nleventqueue_t *aEventQueue, uint32_t aLowWatermark, uint32_t aHighWatermark, nleventqueue_watermark_handler_t aHandler, void *aClosure);
+
+/** Request notification of the events the overflow policy discards.
+ *
+ * Under NLER_EVENTQUEUE_OVERFLOW_DROP_OLDEST that is the pending event
+ * displaced, and under NLER_EVENTQUEUE_OVERFLOW_DROP_NEWEST the event
+ * posted, such that whoever owns them can release them. An event
+ * conflated is still pending and so is not dropped.
+ *
+ * @param[in, out] aEventQueue The queue to configure.
+ *
+ * @param[in] aHandler function to notify or NULL to stop notifications.
+ *
+ * @param[in] aClosure data passed to aHandler.
+ *
+ * @return NLER_SUCCESS if the handler was set, or
+ * NLER_ERROR_NOT_IMPLEMENTED if the platform queue cannot support it.
+ */
+int nleventqueue_set_drop_handler(nleventqueue_t *aEventQueue, nleventqueue_drop_handler_t aHandler, void *aClosure);
+
 /** Post an event to the tail of the queue.
  *
  * @param[in, out] aEventQueue The queue to post an event to. Because events
@@ -86,6 +217,62 @@ void nleventqueue_disable_event_counting(nleventqueue_t *aEventQueue);
  */
 int nleventqueue_post_event(nleventqueue_t *aEventQueue, const nl_event_t *aEvent);
 
+/** Post a batch of events to the tail of the queue.
+ *
+ * Each event is treated as by nleventqueue_post_event(), in order, but
+ * under a single acquisition of the queue and with at most one wakeup
+ * of its consumer, which amortizes the per-event locking and wakeup
+ * cost for producers that emit bursts.
+ *
+ * @param[in, out] aEventQueue The queue to post the events to.
+ *
+ * @param[in] aEvents array of pointers to the events to post.
+ *
+ * @param[in] aCount the number of events in aEvents.
+ *
+ * @return the number of events, from the start of aEvents, that were
+ * posted. Posting stops at the first event for which there is no space.
+ */
+uint32_t nleventqueue_post_events(nleventqueue_t *aEventQueue, const nl_event_t * const *aEvents, uint32_t aCount);
+
+/** Post an event to the tail of the queue, waiting for space if it is full.
+ *
+ * Rather than failing immediately on a full queue, the posting task is
+ * blocked until the consumer frees space or the timeout expires. This
+ * lets a fast producer be throttled to the rate of its consumer without
+ * dropping events.
+ *
+ * @param[in, out] aEventQueue The queue to post an event to.
+ *
+ * @param[in] aEvent pointer to the event to post to the queue.
+ *
+ * @param[in] aTimeoutMS timeout in milliseconds to wait for space in the
+ * queue. NLER_TIMEOUT_NOW behaves as nleventqueue_post_event().
+ *
+ * @return NLER_SUCCESS if the event was posted or NLER_ERROR_NO_RESOURCE if
+ * the timeout expired first.
+ */
+int nleventqueue_post_event_with_timeout(nleventqueue_t *aEventQueue, const nl_event_t *aEvent, nl_time_ms_t aTimeoutMS);
+
+/** Post an event to the urgent lane of the queue.
+ *
+ * Events in the urgent lane are always received before any events
+ * posted with nleventqueue_post_event(), so that, for example, an
+ * alarm or NL_EVENT_T_EXIT is not held up behind a backlog of routine
+ * work. Each queue has room for NLER_EVENTQUEUE_URGENT_DEPTH urgent
+ * events beyond the queue memory given at creation. On FreeRTOS,
+ * urgent events instead share that memory and are received newest
+ * first.
+ *
+ * @param[in, out] aEventQueue The queue to post an event to.
+ *
+ * @param[in] aEvent pointer to the event to post to the queue.
+ *
+ * @return NLER_SUCCESS if there was enough space in the urgent lane for the
+ * event.
+ */
+int nleventqueue_post_event_urgent(nleventqueue_t *aEventQueue, const nl_event_t *aEvent);
+
 /** Post an event to the tail of the queue from an ISR.
  *
  * @param[in, out] aEventQueue The queue to post an event to.
@@ -123,6 +310,89 @@ nl_event_t *nleventqueue_get_event_with_timeout(nleventqueue_t *aEventQueue, nl_
 #define nleventqueue_get_event(aEventQueue) \
     nleventqueue_get_event_with_timeout(aEventQueue, NLER_TIMEOUT_NEVER)
 
+/** Receive a batch of events from the queue with a timeout.
+ *
+ * Events are removed in FIFO order under a single acquisition of the
+ * queue, which amortizes the per-event locking and wakeup cost for
+ * consumers that drain bursts.
+ *
+ * @param[in] aEventQueue Queue from which to pull the events. If no
+ * events are currently in the queue the call will block until an event is
+ * posted or the timeout expires.
+ *
+ * @param[out] aOutEvents storage for at least aMaxEvents event pointers.
+ *
+ * @param[in] aMaxEvents the maximum number of events to receive.
+ *
+ * @param[in] aTimeoutMS timeout in milliseconds to wait for the first
+ * event. Once at least one event is received, the call does not block
+ * waiting for more.
+ *
+ * @return the number of events stored to aOutEvents or 0 if the timeout
+ * expires.
+ */
+uint32_t nleventqueue_get_events(nleventqueue_t *aEventQueue, nl_event_t **aOutEvents, uint32_t aMaxEvents, nl_time_ms_t aTimeoutMS);
+
+/** Wait until any of a set of queues has an event.
+ *
+ * The task blocks once, for the whole set, rather than polling each
+ * queue in turn. No event is removed; the caller subsequently gets the
+ * event from the indicated queue, typically with a timeout of
+ * NLER_TIMEOUT_NOW.
+ *
+ * @param[in] aEventQueues array of pointers to the queues to wait on. When
+ * more than one queue has pending events, the one earliest in the array is
+ * indicated, which lets callers prioritize, for example, a control queue
+ * over a data queue.
+ *
+ * @param[in] aQueueCount number of queues in aEventQueues, at most
+ * NLER_EVENTQUEUE_SELECT_MAX.
+ *
+ * @param[in] aTimeoutMS timeout in milliseconds to wait until giving up on
+ * any queue having an event.
+ *
+ * @return the index in aEventQueues of a queue with a pending event,
+ *         NLER_ERROR_NO_RESOURCE if the timeout expires, or
+ *         NLER_ERROR_BAD_INPUT if the set of queues is invalid.
+ */
+int nleventqueue_select(nleventqueue_t **aEventQueues, size_t aQueueCount, nl_time_ms_t aTimeoutMS);
+
+/** Get a snapshot of the statistics for a queue.
+ *
+ * Statistics are kept when NLER_EVENTQUEUE_STATS is enabled and are
+ * cheap enough to leave enabled in production builds. Comparing the
+ * snapshots of the queues in a system shows which is the bottleneck.
+ *
+ * @param[in] aEventQueue Queue from which to read the statistics.
+ *
+ * @param[out] aOutStats storage for the snapshot.
+ *
+ * @return NLER_SUCCESS if the snapshot was taken, NLER_ERROR_BAD_INPUT if
+ * aOutStats is NULL, or NLER_ERROR_NOT_IMPLEMENTED if statistics are not
+ * kept.
+ */
+int nleventqueue_get_stats(nleventqueue_t *aEventQueue, nleventqueue_stats_t *aOutStats);
+
+/** Get a file descriptor that is readable while the queue has events.
+ *
+ * This lets a queue be waited on from an external reactor, such as an
+ * epoll loop, alongside sockets and other descriptors, without a
+ * bridging task. When the descriptor polls readable, the reactor
+ * drains the queue with a timeout of NLER_TIMEOUT_NOW; the descriptor
+ * stays readable until the queue is empty.
+ *
+ * The descriptor is created on first use, is owned by the queue and is
+ * closed by nleventqueue_destroy(). It must only be polled, never read,
+ * written or closed.
+ *
+ * @param[in] aEventQueue Queue for which to get the descriptor.
+ *
+ * @return a non-negative file descriptor, NLER_ERROR_NO_RESOURCE if one
+ * could not be created, or NLER_ERROR_NOT_IMPLEMENTED on platforms
+ * without pollable queues.
+ */
+int nleventqueue_get_pollable_fd(nleventqueue_t *aEventQueue);
+
 /** Get number of events in a queue.
  *
  * @param[in] aEventQueue Queue from which to read the event count
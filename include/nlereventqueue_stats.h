@@ -0,0 +1,62 @@
+/*
+ *
+ *    Copyright (c) 2026 Project nler Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Event queue statistics accounting, shared by the build platform
+ *      event queue implementations.
+ *
+ */
+
+#ifndef NL_ER_EVENT_QUEUE_STATS_H
+#define NL_ER_EVENT_QUEUE_STATS_H
+
+#include "nlercfg.h"
+#include "nlereventqueue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if NLER_EVENTQUEUE_STATS
+
+/** Account for an event having been queued.
+ *
+ * @param[in,out] aStats  The statistics of the queue.
+ *
+ * @param[in]     aDepth  The number of events pending, including the
+ *                        one just queued.
+ */
+void nleventqueue_stats_record_post(nleventqueue_stats_t *aStats, size_t aDepth);
+
+/** Account for an event having been received.
+ *
+ * @param[in,out] aStats      The statistics of the queue.
+ *
+ * @param[in]     aSojournUS  The time, in microseconds, the event was
+ *                            pending.
+ */
+void nleventqueue_stats_record_get(nleventqueue_stats_t *aStats, uint32_t aSojournUS);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NL_ER_EVENT_QUEUE_STATS_H */
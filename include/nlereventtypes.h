@@ -46,6 +46,9 @@ typedef enum
     NL_EVENT_T_TIMER,           /**< Timer event */
     NL_EVENT_T_EXIT,            /**< Exit event */
     NL_EVENT_T_POOLED,          /**< Pooled event */
+    NL_EVENT_T_FD,              /**< Descriptor readiness event */
+    NL_EVENT_T_MULTICAST,       /**< Multicast pooled event */
+    NL_EVENT_T_BUFFER,          /**< Buffer chain event */
 
     /** First user defined event. The purpose of this sort of event is to allow
      * for quick and dirty definitions of private events that other modules
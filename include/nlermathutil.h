@@ -115,6 +115,17 @@ uint32_t nl_div_uint64_into_uint32_helper(uint64_t inDividend, uint32_t inInvers
  */
 uint32_t nl_udiv64_by_1000ULL (uint64_t inDividend);
 
+/** Hash a pointer into one of a number of buckets, such that objects
+ * laid out side by side in memory spread across the buckets.
+ *
+ * @param[in] inPointer the pointer to hash.
+ *
+ * @param[in] inBuckets the number of buckets, at least one.
+ *
+ * @result the bucket, less than inBuckets.
+ */
+uint32_t nl_hash_pointer(const void *inPointer, uint32_t inBuckets);
+
 #ifdef __cplusplus
 }
 #endif
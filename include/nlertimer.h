@@ -41,13 +41,16 @@
 #include "nlereventqueue.h"
 #include "nlertime.h"
 #include "nlertask.h"
+#include "nlertimerwheel.h"
 
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-/** Timer event. Should be initialized using nl_init_event_timer.
+/** Timer event. Should be initialized using NL_INIT_EVENT_TIMER or
+ * NL_INIT_EVENT_TIMER_STATIC, or else zeroed, before it is first
+ * started and then using nl_init_event_timer.
  */
 typedef struct nl_event_timer_s
 {
@@ -57,8 +60,22 @@ typedef struct nl_event_timer_s
     uint32_t            mFlags;         /**< Timer flags */
     nl_time_native_t    mTimeNow;       /**< For internal use by timer implementation */
     nl_time_native_t    mTimeoutNative; /**< For internal use by timer implementation */
+    nl_timer_wheel_link_t mWheelLink;   /**< For internal use by timer implementation */
+#if NLER_FEATURE_WAKE_TIMER
+    nl_timer_wheel_link_t mWakeLink;    /**< For internal use by timer implementation */
+#endif
 } nl_event_timer_t;
 
+/** @cond */
+#if NLER_FEATURE_WAKE_TIMER
+#define NL_INIT_EVENT_TIMER_WAKE_LINK(e)                          \
+    (e).mWakeLink.mNext = NULL;                                   \
+    (e).mWakeLink.mPrev = NULL;
+#else
+#define NL_INIT_EVENT_TIMER_WAKE_LINK(e)
+#endif
+/** @endcond */
+
 /** Initialize a timer event
  */
 #define NL_INIT_EVENT_TIMER(e, h, c, r)                           \
@@ -67,6 +84,9 @@ typedef struct nl_event_timer_s
     (e).mTimeoutMS    = 0;                                        \
     (e).mFlags        = 0;                                        \
     (e).mTimeNow      = 0;                                        \
+    (e).mWheelLink.mNext = NULL;                                  \
+    (e).mWheelLink.mPrev = NULL;                                  \
+    NL_INIT_EVENT_TIMER_WAKE_LINK(e)                              \
     (e).mTimeoutNative= 0
 
 /** Static initializing of event timer
@@ -84,12 +104,14 @@ typedef struct nl_event_timer_s
     .mTimeoutMS    = 0,                                         \
     .mFlags        = 0,                                         \
     .mTimeNow      = 0,                                         \
-    .mTimeoutNative= 0,
+    .mTimeoutNative= 0,                                         \
+    .mWheelLink    = { NULL, NULL, 0 },
 
 /** This timeout event has been cancelled. Set by timeout requester when the
  * timeout is no longer desired.  The timer may still however send the event
  * back in a timeout response if the timer was already in the process of timing
- * out when the timer was cancelled.
+ * out when the timer was cancelled. The timer notices the flag when the
+ * timeout falls due and only then lets go of the event.
  */
 #define NLER_TIMER_FLAG_CANCELLED   0x0001
 
@@ -103,13 +125,15 @@ typedef struct nl_event_timer_s
  * echo the event back once the cancel has been acknowledged. This is a closed
  * loop way of cancelling a timeout in the case that it is very important for
  * the user to track resources carefully. You are guaranteed to get the event
- * sent back to you unlike NLER_TIMER_FLAG_CANCELLED.
+ * sent back to you unlike NLER_TIMER_FLAG_CANCELLED. The echo is sent when the
+ * timeout falls due.
  */
 #define NLER_TIMER_FLAG_CANCEL_ECHO 0x0004
 
 #ifndef NLER_MAX_TIMER_EVENTS
-/** Maximum number of simultaneous timer events. This can be increased/decreased
- * by changing this define through the build system.
+/** Maximum number of timer events waiting in the timer event queue to be
+ * started. Any number of timers may be running at once. This can be
+ * increased/decreased by changing this define through the build system.
  */
 #define NLER_MAX_TIMER_EVENTS   4
 #endif
@@ -0,0 +1,156 @@
+/*
+ *
+ *    Copyright (c) 2026 Project nler Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Timer wheel. A hierarchical timing wheel, shared by the timer
+ *      implementations, that tracks any number of timers with O(1)
+ *      start and cancel and amortized O(1) expiry.
+ *
+ *      Timers are linked into the wheel through an nl_timer_wheel_link_t
+ *      embedded in them, so the wheel itself allocates nothing. Timers
+ *      due within 2^NLER_TIMER_WHEEL_SLOT_BITS ticks sit in a slot of
+ *      the lowest level, those further out in a slot of a higher level
+ *      whose timers are cascaded down as its turn comes up.
+ *
+ *      The wheel is not thread-safe; it belongs to the timer task.
+ *
+ */
+
+#ifndef NL_ER_TIMER_WHEEL_H
+#define NL_ER_TIMER_WHEEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "nlercfg.h"
+#include "nlertime.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if NLER_TIMER_WHEEL_SLOT_BITS > 6
+#error NLER_TIMER_WHEEL_SLOT_BITS must be at most 6
+#endif
+
+#define NLER_TIMER_WHEEL_SLOTS (1 << NLER_TIMER_WHEEL_SLOT_BITS)
+
+/** Wheel link. Embedded in each timer; it must be zeroed before the
+ * timer is first added to a wheel.
+ */
+typedef struct nl_timer_wheel_link_s
+{
+    struct nl_timer_wheel_link_s *mNext;    /**< Next link in the slot, NULL when not in a wheel */
+    struct nl_timer_wheel_link_s *mPrev;    /**< Previous link in the slot */
+    nl_time_native_t              mExpires; /**< Native time at which the timer expires */
+} nl_timer_wheel_link_t;
+
+/** Timer wheel. Treat as opaque.
+ */
+typedef struct nl_timer_wheel_s
+{
+    nl_timer_wheel_link_t   mSlots[NLER_TIMER_WHEEL_LEVELS][NLER_TIMER_WHEEL_SLOTS];
+    uint64_t                mOccupied[NLER_TIMER_WHEEL_LEVELS];
+    nl_time_native_t        mCurrent;   /**< Next tick to be processed */
+    uint32_t                mCount;     /**< Timers in the wheel */
+} nl_timer_wheel_t;
+
+/** Callback invoked for each expired timer. The link is no longer in
+ * the wheel and may be added back, for instance to repeat the timer.
+ */
+typedef void (*nl_timer_wheel_expire_t)(nl_timer_wheel_link_t *aLink, void *aClosure);
+
+/** Initialize an empty wheel.
+ *
+ * @param[out] aWheel  The wheel to initialize.
+ *
+ * @param[in]  aNow    The current native time.
+ */
+void nl_timer_wheel_init(nl_timer_wheel_t *aWheel, nl_time_native_t aNow);
+
+/** Add a timer to the wheel, first removing it if it is already there.
+ *
+ * @param[in, out] aWheel    The wheel.
+ *
+ * @param[in, out] aLink     The link of the timer.
+ *
+ * @param[in]      aExpires  Native time at which the timer expires.
+ *                           Times already past expire on the next call
+ *                           to nl_timer_wheel_advance().
+ */
+void nl_timer_wheel_add(nl_timer_wheel_t *aWheel, nl_timer_wheel_link_t *aLink, nl_time_native_t aExpires);
+
+/** Remove a timer from the wheel it is in, if any.
+ *
+ * @param[in, out] aWheel  The wheel.
+ *
+ * @param[in, out] aLink   The link of the timer.
+ */
+void nl_timer_wheel_remove(nl_timer_wheel_t *aWheel, nl_timer_wheel_link_t *aLink);
+
+/** Check whether a timer is in a wheel.
+ *
+ * @param[in] aLink  The link of the timer.
+ *
+ * @return true if the timer is in a wheel.
+ */
+bool nl_timer_wheel_is_pending(const nl_timer_wheel_link_t *aLink);
+
+/** Expire every timer due at or before a given time.
+ *
+ * @param[in, out] aWheel     The wheel.
+ *
+ * @param[in]      aNow       The current native time.
+ *
+ * @param[in]      aExpire    Called for each expired timer.
+ *
+ * @param[in]      aClosure   Passed to aExpire.
+ */
+void nl_timer_wheel_advance(nl_timer_wheel_t *aWheel, nl_time_native_t aNow, nl_timer_wheel_expire_t aExpire, void *aClosure);
+
+/** Get the time by which nl_timer_wheel_advance() must next be called.
+ * This is the earliest expiry or, for timers in the higher levels, the
+ * earliest time at which they are cascaded down.
+ *
+ * @param[in, out] aWheel  The wheel.
+ *
+ * @param[out]     aTime   The native time.
+ *
+ * @return false if the wheel is empty, true otherwise.
+ */
+bool nl_timer_wheel_next(nl_timer_wheel_t *aWheel, nl_time_native_t *aTime);
+
+/** Pick an expiry within a window of tolerated lateness. Of the times
+ * from aExpires to aExpires + aSlack, the one with the most trailing
+ * zero bits is chosen, such that timers whose windows overlap tend to
+ * be given the same expiry and fire on the same pass.
+ *
+ * @param[in] aExpires  Earliest native time at which to expire.
+ *
+ * @param[in] aSlack    Native time by which expiry may be delayed.
+ *
+ * @return the native time at which to expire.
+ */
+nl_time_native_t nl_timer_wheel_apply_slack(nl_time_native_t aExpires, nl_time_native_t aSlack);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NL_ER_TIMER_WHEEL_H */
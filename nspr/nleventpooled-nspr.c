@@ -21,112 +21,335 @@
  *      This file implements NLER pooled events under the Netscape
  *      Portable Runtime (NSPR) build platform.
  *
+ *      The caller's pool memory is divided between one or more size
+ *      classes, each carved into fixed-size blocks kept on a lock-free,
+ *      LIFO free list such that getting and recycling events costs no
+ *      heap traffic. Each list is threaded through a per-block array of
+ *      successor indices and its head packs the index of the first free
+ *      block, plus one such that zero means empty, with a tag bumped by
+ *      every update so a task holding a stale head can never swap it
+ *      back in. As no block on the list is written while the tag stands
+ *      still, a run of blocks may be taken or returned with a single
+ *      swap.
+ *
  */
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
+#include <nleratomicops.h>
 #include <nlererror.h>
 #include <nlerlog.h>
 #include <nlereventpooled.h>
 
-#include <nspr/prlock.h>
+#define kFreeListLinkBits   (sizeof (intptr_t) * 4)
+#define kFreeListLinkMask   ((((uintptr_t)1) << kFreeListLinkBits) - 1)
+
+#define kBlockAlignment     sizeof(uint64_t)
+
+typedef struct nlevent_pool_class_nspr_s
+{
+    intptr_t            mFreeHead;
+    uint8_t            *mEvents;
+    size_t              mEventSize;
+    uint32_t            mEventCount;
+    uint32_t           *mNext;
+} nlevent_pool_class_nspr_t;
 
 typedef struct nlevent_pool_nspr_s
 {
-    PRLock  *mLock;
-    int      mFreeEvents;
+    size_t              mClassCount;
+    nlevent_pool_class_nspr_t mClasses[];
 } nlevent_pool_nspr_t;
 
-int nlevent_pool_create(void *aPoolMemory, int32_t aPoolMemorySize, nlevent_pool_t *aPoolObj)
+static intptr_t nlevent_pool_nspr_make_head(intptr_t aPrevious, uint32_t aLink)
+{
+    const uintptr_t tag = ((uintptr_t)aPrevious >> kFreeListLinkBits) + 1;
+
+    return (intptr_t)((tag << kFreeListLinkBits) | aLink);
+}
+
+static uint32_t nlevent_pool_nspr_head_link(intptr_t aHead)
+{
+    return (uint32_t)((uintptr_t)aHead & kFreeListLinkMask);
+}
+
+/* Take up to aMax blocks from the front of the list. The run is read
+ * before it is claimed and may change under us, but then so will the
+ * tag and the swap will fail.
+ */
+static uint32_t nlevent_pool_nspr_pop(nlevent_pool_class_nspr_t *aClass, uint32_t *aOutBlocks, uint32_t aMax)
+{
+    intptr_t    head = aClass->mFreeHead;
+    intptr_t    expected;
+    uint32_t    link;
+    uint32_t    count;
+
+    do
+    {
+        expected = head;
+        link     = nlevent_pool_nspr_head_link(head);
+        count    = 0;
+
+        while ((link != 0) && (count < aMax))
+        {
+            aOutBlocks[count++] = link - 1;
+
+            link = aClass->mNext[link - 1];
+        }
+
+        if (count == 0)
+        {
+            break;
+        }
+
+        head = nl_er_atomic_cas(&aClass->mFreeHead, expected, nlevent_pool_nspr_make_head(expected, link));
+    }
+    while (head != expected);
+
+    return count;
+}
+
+/* Return aCount blocks, which the caller owns, to the front of the
+ * list.
+ */
+static void nlevent_pool_nspr_push(nlevent_pool_class_nspr_t *aClass, const uint32_t *aBlocks, uint32_t aCount)
 {
-    nlevent_pool_nspr_t         *lPool;
-    int                          retval = NLER_SUCCESS;
+    const uint32_t  last = aBlocks[aCount - 1];
+    intptr_t        head = aClass->mFreeHead;
+    intptr_t        expected;
+    uint32_t        i;
 
-    if ((aPoolMemory == NULL) || (aPoolMemorySize == 0) || (aPoolObj == NULL))
+    for (i = 0; (i + 1) < aCount; i++)
+    {
+        aClass->mNext[aBlocks[i]] = aBlocks[i + 1] + 1;
+    }
+
+    do
+    {
+        aClass->mNext[last] = nlevent_pool_nspr_head_link(head);
+
+        expected = head;
+
+        head = nl_er_atomic_cas(&aClass->mFreeHead, expected, nlevent_pool_nspr_make_head(expected, aBlocks[0] + 1));
+    }
+    while (head != expected);
+}
+
+static nlevent_pooled_t *nlevent_pool_nspr_class_get(nlevent_pool_class_nspr_t *aClass)
+{
+    nlevent_pooled_t   *retval = NULL;
+    uint32_t            block;
+
+    if (nlevent_pool_nspr_pop(aClass, &block, 1) == 1)
+    {
+        retval = (nlevent_pooled_t *)(aClass->mEvents + (block * aClass->mEventSize));
+    }
+
+    return retval;
+}
+
+static void nlevent_pool_nspr_class_put(nlevent_pool_class_nspr_t *aClass, uint32_t aBlock)
+{
+    nlevent_pool_nspr_push(aClass, &aBlock, 1);
+}
+
+int nlevent_pool_create_sized(void *aPoolMemory, int32_t aPoolMemorySize, const nlevent_pool_size_class_t *aSizeClasses, size_t aSizeClassCount, nlevent_pool_t *aPoolObj)
+{
+    nlevent_pool_nspr_t            *lPool;
+    nlevent_pool_class_nspr_t      *lClass;
+    uint32_t                       *lNext;
+    uintptr_t                       cursor;
+    uintptr_t                       last;
+    size_t                          size;
+    size_t                          blocks = 0;
+    size_t                          i;
+    uint32_t                        index;
+    int                             retval = NLER_SUCCESS;
+
+    if ((aPoolMemory == NULL) || (aPoolMemorySize <= 0) || (aSizeClasses == NULL) || (aSizeClassCount == 0) || (aPoolObj == NULL))
     {
         retval = NLER_ERROR_BAD_INPUT;
         goto done;
     }
 
-    lPool = (nlevent_pool_nspr_t *)calloc(1, sizeof(nlevent_pool_nspr_t));
+    // check the classes fit in the pool memory before committing to
+    // them; the link is the block index plus one and must fit beside
+    // the tag.
 
-    if (lPool != NULL)
-    {
-        lPool->mLock = PR_NewLock();
+    cursor = (uintptr_t)aPoolMemory;
+    last   = (uintptr_t)aPoolMemory + (uintptr_t)aPoolMemorySize;
 
-        if (lPool->mLock != NULL)
+    for (i = 0; i < aSizeClassCount; i++)
+    {
+        if ((aSizeClasses[i].mEventSize < sizeof(nlevent_pooled_t)) ||
+            ((i > 0) && (aSizeClasses[i].mEventSize <= aSizeClasses[i - 1].mEventSize)) ||
+            (aSizeClasses[i].mEventCount == 0) ||
+            (aSizeClasses[i].mEventCount >= kFreeListLinkMask))
         {
-            lPool->mFreeEvents = aPoolMemorySize / sizeof(nlevent_pooled_t);
-
-            *aPoolObj = (nlevent_pool_t)lPool;
+            retval = NLER_ERROR_BAD_INPUT;
+            goto done;
         }
-        else
-        {
-            NL_LOG_CRIT(lrERPOOLED, "failed to allocate event pool lock\n");
 
-            free(lPool);
+        size   = (aSizeClasses[i].mEventSize + kBlockAlignment - 1) & ~(kBlockAlignment - 1);
+        cursor = (cursor + kBlockAlignment - 1) & ~(kBlockAlignment - 1);
 
-            retval = NLER_ERROR_NO_RESOURCE;
+        if ((cursor > last) || (aSizeClasses[i].mEventCount > ((last - cursor) / size)))
+        {
+            retval = NLER_ERROR_BAD_INPUT;
+            goto done;
         }
+
+        cursor += aSizeClasses[i].mEventCount * size;
+        blocks += aSizeClasses[i].mEventCount;
     }
-	else
-	{
+
+    lPool = (nlevent_pool_nspr_t *)calloc(1, sizeof(nlevent_pool_nspr_t) + (aSizeClassCount * sizeof(nlevent_pool_class_nspr_t)) + (blocks * sizeof(uint32_t)));
+    if (lPool == NULL)
+    {
         retval = NLER_ERROR_NO_MEMORY;
-	}
+        goto done;
+    }
 
-done:
-    return (nlevent_pool_t)retval;
-}
+    lPool->mClassCount = aSizeClassCount;
 
-void nlevent_pool_destroy(nlevent_pool_t *aPool)
-{
-    nlevent_pool_nspr_t         *lPool = *(nlevent_pool_nspr_t **)aPool;
+    cursor = (uintptr_t)aPoolMemory;
+    lNext  = (uint32_t *)&lPool->mClasses[aSizeClassCount];
 
-    if (lPool != NULL)
+    for (i = 0; i < aSizeClassCount; i++)
     {
-        if (lPool->mLock != NULL)
+        lClass = &lPool->mClasses[i];
+        cursor = (cursor + kBlockAlignment - 1) & ~(kBlockAlignment - 1);
+
+        lClass->mEvents     = (uint8_t *)cursor;
+        lClass->mEventSize  = (aSizeClasses[i].mEventSize + kBlockAlignment - 1) & ~(kBlockAlignment - 1);
+        lClass->mEventCount = aSizeClasses[i].mEventCount;
+        lClass->mNext       = lNext;
+
+        // hand blocks out in address order to begin with.
+
+        for (index = 0; index < lClass->mEventCount; index++)
         {
-            PR_DestroyLock(lPool->mLock);
-            lPool->mLock = NULL;
+            lClass->mNext[index] = ((index + 1) < lClass->mEventCount) ? (index + 2) : 0;
         }
 
-        free(lPool);
+        lClass->mFreeHead = 1;
+
+        cursor += lClass->mEventCount * lClass->mEventSize;
+        lNext  += lClass->mEventCount;
     }
+
+    *aPoolObj = (nlevent_pool_t)lPool;
+
+ done:
+    if (retval != NLER_SUCCESS)
+    {
+        NL_LOG_CRIT(lrERPOOLED, "failed to create event pool from %p with size %d\n", aPoolMemory, aPoolMemorySize);
+    }
+
+    return (retval);
 }
 
-nlevent_pooled_t *nlevent_pool_get_event(nlevent_pool_t *aPool)
+int nlevent_pool_create(void *aPoolMemory, int32_t aPoolMemorySize, nlevent_pool_t *aPoolObj)
 {
-    nlevent_pooled_t            *retval = NULL;
-    nlevent_pool_nspr_t         *lPool = *(nlevent_pool_nspr_t **)aPool;
-    int                          freeevs;
+    nlevent_pool_size_class_t    lSizeClass;
+    uintptr_t                    first;
+    uintptr_t                    last;
+
+    lSizeClass.mEventSize  = sizeof(nlevent_pooled_t);
+    lSizeClass.mEventCount = 0;
+
+    // as many events as fit, once the memory is aligned.
+
+    if ((aPoolMemory != NULL) && (aPoolMemorySize > 0))
+    {
+        first = ((uintptr_t)aPoolMemory + kBlockAlignment - 1) & ~(kBlockAlignment - 1);
+        last  = (uintptr_t)aPoolMemory + (uintptr_t)aPoolMemorySize;
+
+        if (first < last)
+        {
+            lSizeClass.mEventSize  = (sizeof(nlevent_pooled_t) + kBlockAlignment - 1) & ~(kBlockAlignment - 1);
+            lSizeClass.mEventCount = (uint32_t)((last - first) / lSizeClass.mEventSize);
 
-    PR_Lock(lPool->mLock);
+            if (lSizeClass.mEventCount >= kFreeListLinkMask)
+            {
+                lSizeClass.mEventCount = kFreeListLinkMask - 1;
+            }
+        }
+    }
 
-    freeevs = --lPool->mFreeEvents;
+    return nlevent_pool_create_sized(aPoolMemory, aPoolMemorySize, &lSizeClass, 1, aPoolObj);
+}
 
-    PR_Unlock(lPool->mLock);
+void nlevent_pool_destroy(nlevent_pool_t *aPool)
+{
+    nlevent_pool_nspr_t    *lPool = *(nlevent_pool_nspr_t **)aPool;
 
-    if (freeevs >= 0)
+    if (lPool != NULL)
     {
-        retval = (nlevent_pooled_t *)malloc(sizeof(nlevent_pooled_t));
+        free(lPool);
     }
-    else
+}
+
+nlevent_pooled_t *nlevent_pool_get_event_sized(nlevent_pool_t *aPool, size_t aSize)
+{
+    nlevent_pooled_t            *retval = NULL;
+    nlevent_pool_nspr_t         *lPool = *(nlevent_pool_nspr_t **)aPool;
+    size_t                       i;
+
+    if (lPool != NULL)
     {
-        NL_LOG_DEBUG(lrERPOOLED, "no more events in event pool\n");
+        for (i = 0; (i < lPool->mClassCount) && (retval == NULL); i++)
+        {
+            if (lPool->mClasses[i].mEventSize >= aSize)
+            {
+                retval = nlevent_pool_nspr_class_get(&lPool->mClasses[i]);
+            }
+        }
+
+        if (retval == NULL)
+        {
+            NL_LOG_DEBUG(lrERPOOLED, "no more events of %u bytes in event pool\n", (unsigned)aSize);
+        }
     }
 
     return retval;
 }
 
+nlevent_pooled_t *nlevent_pool_get_event(nlevent_pool_t *aPool)
+{
+    return nlevent_pool_get_event_sized(aPool, sizeof(nlevent_pooled_t));
+}
+
 void nlevent_pool_recycle_event(nlevent_pool_t *aPool, nlevent_pooled_t *aEvent)
 {
-    nlevent_pool_nspr_t *lPool = *(nlevent_pool_nspr_t **)aPool;
+    nlevent_pool_nspr_t            *lPool = *(nlevent_pool_nspr_t **)aPool;
+    nlevent_pool_class_nspr_t      *lClass;
+    uintptr_t                       offset;
+    bool                            recycled = false;
+    size_t                          i;
 
-    PR_Lock(lPool->mLock);
+    if ((lPool != NULL) && (aEvent != NULL))
+    {
+        for (i = 0; (i < lPool->mClassCount) && !recycled; i++)
+        {
+            lClass = &lPool->mClasses[i];
+            offset = (uintptr_t)aEvent - (uintptr_t)lClass->mEvents;
 
-    lPool->mFreeEvents++;
+            if (((uint8_t *)aEvent >= lClass->mEvents) &&
+                (offset < (lClass->mEventCount * lClass->mEventSize)) &&
+                ((offset % lClass->mEventSize) == 0))
+            {
+                nlevent_pool_nspr_class_put(lClass, (uint32_t)(offset / lClass->mEventSize));
 
-    PR_Unlock(lPool->mLock);
+                recycled = true;
+            }
+        }
 
-    free(aEvent);
+        if (!recycled)
+        {
+            NL_LOG_CRIT(lrERPOOLED, "attempt to recycle event (%p) not from pool %p\n", aEvent, lPool);
+        }
+    }
 }
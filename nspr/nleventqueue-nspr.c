@@ -25,10 +25,12 @@
 
 #include <stdbool.h>
 #include <stdlib.h>
-#include <string.h>
+#include "nlercfg.h"
 #include "nlereventqueue.h"
 #include <nspr/prlock.h>
+#include <nspr/prcvar.h>
 #include <nspr/prio.h>
+#include <nspr/prinrval.h>
 #include "nlerlog.h"
 #include "nlererror.h"
 
@@ -36,21 +38,51 @@
 #include "nlereventqueue_sim.h"
 #endif
 
-/* the queueing used here is a simple sliding array rather
- * than a more efficient circular list. the goal is simplicity
- * and readablity. there is no point in making this efficient
- * at the cost of added complexity where it need not be. mmp
+#if NLER_EVENTQUEUE_STATS
+#include "nlereventqueue_stats.h"
+#endif
+
+/* the queueing used here is a circular array of mQueueSize
+ * event pointers, mQueueCount of which, starting at mQueueHead,
+ * are pending. removing an event is constant time regardless of
+ * queue depth. urgent events are kept in a second, smaller circular
+ * array that is always drained first. producers waiting for space
+ * block on mNotFull, which is only notified while any are waiting.
+ * when the queue is full, mOverflowPolicy decides the fate of a
+ * further event. watermark crossings are reported with the lock held
+ * so that notifications are never reordered. with statistics enabled,
+ * mPostTimes and mUrgentPostTimes parallel the two circular arrays and
+ * hold the interval at which each pending event was posted.
  */
 
 typedef struct nleventqueue_nspr_s
 {
     PRLock      *mLock;
+    PRCondVar   *mNotFull;
+    size_t      mSpaceWaiters;
     PRFileDesc  *mPollableEvent;
     nl_event_t  **mQueue;
     size_t      mQueueSize;
-    size_t      mQueueEnd;
+    size_t      mQueueHead;
+    size_t      mQueueCount;
+    nl_event_t  *mUrgent[NLER_EVENTQUEUE_URGENT_DEPTH];
+    size_t      mUrgentHead;
+    size_t      mUrgentCount;
+    nleventqueue_overflow_policy_t      mOverflowPolicy;
+    uint32_t    mLowWatermark;
+    uint32_t    mHighWatermark;
+    bool        mAboveHighWatermark;
+    nleventqueue_watermark_handler_t    mWatermarkHandler;
+    void        *mWatermarkClosure;
+    nleventqueue_drop_handler_t         mDropHandler;
+    void        *mDropClosure;
+#if NLER_EVENTQUEUE_STATS
+    PRIntervalTime  *mPostTimes;
+    PRIntervalTime  mUrgentPostTimes[NLER_EVENTQUEUE_URGENT_DEPTH];
+    nleventqueue_stats_t    mStats;
+#endif
 #if NLER_FEATURE_SIMULATEABLE_TIME
-    bool prev_get_successful;
+    size_t      prev_get_count;
 #endif
 } nleventqueue_nspr_t;
 
@@ -58,14 +90,25 @@ int nleventqueue_create(void *aQueueMemory, size_t aQueueMemorySize, nleventqueu
 {
     nleventqueue_nspr_t  *lQueue = NULL;
     size_t               qsize = aQueueMemorySize / sizeof(nl_event_t *);
+    size_t               lQueueObjSize = sizeof(nleventqueue_nspr_t);
     int                  retval = NLER_ERROR_FAILURE;
 
     if ((aQueueMemory != NULL) && (qsize > 0) && (aOutQueue != NULL))
     {
-        lQueue = (nleventqueue_nspr_t *)calloc(1, sizeof(nleventqueue_nspr_t));
+#if NLER_EVENTQUEUE_STATS
+        // the post times are allocated along with the queue object
+
+        lQueueObjSize += qsize * sizeof(PRIntervalTime);
+#endif
+
+        lQueue = (nleventqueue_nspr_t *)calloc(1, lQueueObjSize);
 
         if (lQueue != NULL)
         {
+#if NLER_EVENTQUEUE_STATS
+            lQueue->mPostTimes = (PRIntervalTime *)(lQueue + 1);
+#endif
+
             lQueue->mPollableEvent = PR_NewPollableEvent();
 
             if (lQueue->mPollableEvent != NULL)
@@ -73,10 +116,16 @@ int nleventqueue_create(void *aQueueMemory, size_t aQueueMemorySize, nleventqueu
                 lQueue->mLock = PR_NewLock();
 
                 if (lQueue->mLock != NULL)
+                {
+                    lQueue->mNotFull = PR_NewCondVar(lQueue->mLock);
+                }
+
+                if (lQueue->mNotFull != NULL)
                 {
                     lQueue->mQueue = (nl_event_t **)aQueueMemory;
                     lQueue->mQueueSize = qsize;
-                    lQueue->mQueueEnd = 0;
+                    lQueue->mQueueHead = 0;
+                    lQueue->mQueueCount = 0;
 
                     *aOutQueue = (nleventqueue_t)lQueue;
 
@@ -84,7 +133,7 @@ int nleventqueue_create(void *aQueueMemory, size_t aQueueMemorySize, nleventqueu
                 }
                 else
                 {
-                    NL_LOG_CRIT(lrERQUEUE, "failed to allocate lock for nspr event queue\n");
+                    NL_LOG_CRIT(lrERQUEUE, "failed to allocate lock or condition variable for nspr event queue\n");
                     retval = NLER_ERROR_NO_RESOURCE;
                 }
             }
@@ -102,7 +151,7 @@ int nleventqueue_create(void *aQueueMemory, size_t aQueueMemorySize, nleventqueu
         }
         else
         {
-            NL_LOG_CRIT(lrERQUEUE, "failed to allocate %d bytes for nspr event queue\n", sizeof(nleventqueue_nspr_t));
+            NL_LOG_CRIT(lrERQUEUE, "failed to allocate %d bytes for nspr event queue\n", lQueueObjSize);
             retval = NLER_ERROR_NO_MEMORY;
         }
     }
@@ -124,6 +173,11 @@ void nleventqueue_destroy(nleventqueue_t *aEventQueue)
         PR_DestroyPollableEvent(queue->mPollableEvent);
     }
 
+    if (queue->mNotFull != NULL)
+    {
+        PR_DestroyCondVar(queue->mNotFull);
+    }
+
     if (queue->mLock != NULL)
     {
         PR_DestroyLock(queue->mLock);
@@ -137,43 +191,399 @@ void nleventqueue_disable_event_counting(nleventqueue_t *aEventQueue)
     return;
 }
 
-int nleventqueue_post_event(nleventqueue_t *aEventQueue, const nl_event_t *aEvent)
+static void put_event_in_ring(nl_event_t **aRing, size_t aSize, size_t aHead, size_t *aCount, const nl_event_t *aEvent)
+{
+    size_t tail = aHead + *aCount;
+
+    if (tail >= aSize)
+        tail -= aSize;
+
+    aRing[tail] = (nl_event_t *)aEvent;
+    (*aCount)++;
+}
+
+static nl_event_t *take_event_from_ring(nl_event_t **aRing, size_t aSize, size_t *aHead, size_t *aCount)
+{
+    nl_event_t  *retval;
+
+    retval = aRing[*aHead];
+
+    (*aHead)++;
+
+    if (*aHead == aSize)
+        *aHead = 0;
+
+    (*aCount)--;
+
+    return retval;
+}
+
+static size_t count_events_in_queue(const nleventqueue_nspr_t *aQueue)
+{
+    return (aQueue->mUrgentCount + aQueue->mQueueCount);
+}
+
+int nleventqueue_set_overflow_policy(nleventqueue_t *aEventQueue, nleventqueue_overflow_policy_t aPolicy)
+{
+    nleventqueue_nspr_t    *queue = *(nleventqueue_nspr_t **)aEventQueue;
+
+    if (aPolicy > NLER_EVENTQUEUE_OVERFLOW_CONFLATE)
+        return NLER_ERROR_BAD_INPUT;
+
+    PR_Lock(queue->mLock);
+
+    queue->mOverflowPolicy = aPolicy;
+
+    PR_Unlock(queue->mLock);
+
+    return NLER_SUCCESS;
+}
+
+int nleventqueue_set_watermarks(nleventqueue_t *aEventQueue, uint32_t aLowWatermark, uint32_t aHighWatermark, nleventqueue_watermark_handler_t aHandler, void *aClosure)
+{
+    nleventqueue_nspr_t    *queue = *(nleventqueue_nspr_t **)aEventQueue;
+
+    if ((aHandler != NULL) && (aLowWatermark >= aHighWatermark))
+        return NLER_ERROR_BAD_INPUT;
+
+    PR_Lock(queue->mLock);
+
+    queue->mLowWatermark = aLowWatermark;
+    queue->mHighWatermark = aHighWatermark;
+    queue->mWatermarkHandler = aHandler;
+    queue->mWatermarkClosure = aClosure;
+    queue->mAboveHighWatermark = (count_events_in_queue(queue) >= aHighWatermark);
+
+    PR_Unlock(queue->mLock);
+
+    return NLER_SUCCESS;
+}
+
+int nleventqueue_set_drop_handler(nleventqueue_t *aEventQueue, nleventqueue_drop_handler_t aHandler, void *aClosure)
+{
+    nleventqueue_nspr_t    *queue = *(nleventqueue_nspr_t **)aEventQueue;
+
+    PR_Lock(queue->mLock);
+
+    queue->mDropHandler = aHandler;
+    queue->mDropClosure = aClosure;
+
+    PR_Unlock(queue->mLock);
+
+    return NLER_SUCCESS;
+}
+
+int nleventqueue_get_stats(nleventqueue_t *aEventQueue, nleventqueue_stats_t *aOutStats)
+{
+#if NLER_EVENTQUEUE_STATS
+    nleventqueue_nspr_t    *queue = *(nleventqueue_nspr_t **)aEventQueue;
+
+    if (aOutStats == NULL)
+        return NLER_ERROR_BAD_INPUT;
+
+    PR_Lock(queue->mLock);
+
+    *aOutStats = queue->mStats;
+
+    PR_Unlock(queue->mLock);
+
+    return NLER_SUCCESS;
+#else
+    return NLER_ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+// NSPR pollable events are signaled by writing to a pipe and must be
+// drained by whoever polls them, which does not map onto a descriptor
+// that tracks queue occupancy on its own.
+
+int nleventqueue_get_pollable_fd(nleventqueue_t *aEventQueue)
+{
+    (void)aEventQueue;
+
+    return NLER_ERROR_NOT_IMPLEMENTED;
+}
+
+#if NLER_EVENTQUEUE_STATS
+// timestamp and account for the event most recently put in the ring.
+// must be called with the queue lock held
+
+static void record_post_in_queue_stats(nleventqueue_nspr_t *aQueue, PRIntervalTime *aTimes, size_t aSize, size_t aHead, size_t aCount)
+{
+    aTimes[(aHead + aCount - 1) % aSize] = PR_IntervalNow();
+
+    nleventqueue_stats_record_post(&aQueue->mStats, count_events_in_queue(aQueue));
+}
+
+static void record_get_in_queue_stats(nleventqueue_nspr_t *aQueue, PRIntervalTime aPostTime)
+{
+    nleventqueue_stats_record_get(&aQueue->mStats, PR_IntervalToMicroseconds(PR_IntervalNow() - aPostTime));
+}
+#endif
+
+// must be called with the queue lock held
+
+static void check_queue_watermarks(nleventqueue_nspr_t *aQueue)
+{
+    const size_t count = count_events_in_queue(aQueue);
+
+    if (aQueue->mWatermarkHandler == NULL)
+        return;
+
+    if (!aQueue->mAboveHighWatermark && (count >= aQueue->mHighWatermark))
+    {
+        aQueue->mAboveHighWatermark = true;
+        aQueue->mWatermarkHandler(true, aQueue->mWatermarkClosure);
+    }
+    else if (aQueue->mAboveHighWatermark && (count <= aQueue->mLowWatermark))
+    {
+        aQueue->mAboveHighWatermark = false;
+        aQueue->mWatermarkHandler(false, aQueue->mWatermarkClosure);
+    }
+}
+
+static bool is_event_in_ring(nl_event_t **aRing, size_t aSize, size_t aHead, size_t aCount, const nl_event_t *aEvent)
+{
+    size_t i;
+
+    for (i = 0; i < aCount; i++)
+    {
+        if (aRing[(aHead + i) % aSize] == aEvent)
+            return true;
+    }
+
+    return false;
+}
+
+/* Hand an event discarded by the overflow policy to whoever owns it.
+ * Called with the queue lock held.
+ */
+static void drop_event_from_queue(nleventqueue_nspr_t *aQueue, const nl_event_t *aEvent)
+{
+    if (aQueue->mDropHandler != NULL)
+        aQueue->mDropHandler((nl_event_t *)aEvent, aQueue->mDropClosure);
+}
+
+/* Put one event in its lane, or dispose of it as the overflow policy
+ * dictates. Called with the queue lock held. A producer that may yet
+ * wait for space passes aMayWait, and is told NLER_ERROR_NO_RESOURCE
+ * rather than have the policy applied if the queue is full.
+ */
+static int put_event_in_queue(nleventqueue_nspr_t *aQueue, const nl_event_t *aEvent, bool aUrgent, bool aMayWait, bool *aOutQueued)
+{
+    int         retval = NLER_SUCCESS;
+    bool        queued = false;
+    nl_event_t  *displaced;
+
+    *aOutQueued = false;
+
+    if (!aUrgent && (aQueue->mOverflowPolicy == NLER_EVENTQUEUE_OVERFLOW_CONFLATE) &&
+        is_event_in_ring(aQueue->mQueue, aQueue->mQueueSize, aQueue->mQueueHead, aQueue->mQueueCount, aEvent))
+    {
+        return retval;
+    }
+
+    if (!aUrgent && aMayWait && (aQueue->mQueueCount == aQueue->mQueueSize))
+    {
+        return NLER_ERROR_NO_RESOURCE;
+    }
+
+    if (aUrgent && (aQueue->mUrgentCount < NLER_EVENTQUEUE_URGENT_DEPTH))
+    {
+        put_event_in_ring(aQueue->mUrgent, NLER_EVENTQUEUE_URGENT_DEPTH, aQueue->mUrgentHead, &aQueue->mUrgentCount, aEvent);
+        queued = true;
+
+#if NLER_EVENTQUEUE_STATS
+        record_post_in_queue_stats(aQueue, aQueue->mUrgentPostTimes, NLER_EVENTQUEUE_URGENT_DEPTH, aQueue->mUrgentHead, aQueue->mUrgentCount);
+#endif
+    }
+    else if (!aUrgent && (aQueue->mQueueCount < aQueue->mQueueSize))
+    {
+        put_event_in_ring(aQueue->mQueue, aQueue->mQueueSize, aQueue->mQueueHead, &aQueue->mQueueCount, aEvent);
+        queued = true;
+
+#if NLER_EVENTQUEUE_STATS
+        record_post_in_queue_stats(aQueue, aQueue->mPostTimes, aQueue->mQueueSize, aQueue->mQueueHead, aQueue->mQueueCount);
+#endif
+    }
+    else if (!aUrgent && (aQueue->mOverflowPolicy == NLER_EVENTQUEUE_OVERFLOW_DROP_OLDEST))
+    {
+        // the pollable event is already set for the displaced event
+
+        displaced = take_event_from_ring(aQueue->mQueue, aQueue->mQueueSize, &aQueue->mQueueHead, &aQueue->mQueueCount);
+        put_event_in_ring(aQueue->mQueue, aQueue->mQueueSize, aQueue->mQueueHead, &aQueue->mQueueCount, aEvent);
+
+#if NLER_EVENTQUEUE_STATS
+        record_post_in_queue_stats(aQueue, aQueue->mPostTimes, aQueue->mQueueSize, aQueue->mQueueHead, aQueue->mQueueCount);
+#endif
+
+        drop_event_from_queue(aQueue, displaced);
+    }
+    else if (aUrgent || (aQueue->mOverflowPolicy != NLER_EVENTQUEUE_OVERFLOW_DROP_NEWEST))
+    {
+        retval = NLER_ERROR_NO_RESOURCE;
+    }
+    else
+    {
+        drop_event_from_queue(aQueue, aEvent);
+    }
+
+#if NLER_EVENTQUEUE_STATS
+    if (!queued)
+        aQueue->mStats.mRejections++;
+#endif
+
+    *aOutQueued = queued;
+
+    return retval;
+}
+
+static int post_event_to_queue(nleventqueue_t *aEventQueue, const nl_event_t *aEvent, bool aUrgent, PRIntervalTime aTimeout)
 {
     int                     retval = NLER_SUCCESS;
     nleventqueue_nspr_t    *queue = *(nleventqueue_nspr_t **)aEventQueue;
+    const PRIntervalTime    start = PR_IntervalNow();
+    PRIntervalTime          elapsed;
+    bool                    queued = false;
+    bool                    waiting = (aTimeout != PR_INTERVAL_NO_WAIT);
 
     PR_Lock(queue->mLock);
 
-    if (queue->mQueueEnd < queue->mQueueSize)
+    // wait for space for as long as the event is neither queued nor
+    // conflated, then put it in or apply the policy once done waiting.
+
+    while (((retval = put_event_in_queue(queue, aEvent, aUrgent, waiting, &queued)) == NLER_ERROR_NO_RESOURCE) &&
+           !aUrgent && waiting)
     {
-        queue->mQueue[queue->mQueueEnd] = (nl_event_t *)aEvent;
-        queue->mQueueEnd++;
+        if (aTimeout == PR_INTERVAL_NO_TIMEOUT)
+        {
+            elapsed = 0;
+        }
+        else
+        {
+            elapsed = PR_IntervalNow() - start;
+
+            if (elapsed >= aTimeout)
+            {
+                waiting = false;
+                continue;
+            }
+        }
+
+        queue->mSpaceWaiters++;
 
+        PR_WaitCondVar(queue->mNotFull, (aTimeout == PR_INTERVAL_NO_TIMEOUT) ? aTimeout : (aTimeout - elapsed));
+
+        queue->mSpaceWaiters--;
+    }
+
+    if (queued)
+    {
         PR_SetPollableEvent(queue->mPollableEvent);
+
+        check_queue_watermarks(queue);
     }
-    else
+
+    PR_Unlock(queue->mLock);
+
+    if ((retval == NLER_ERROR_NO_RESOURCE) && (aTimeout == PR_INTERVAL_NO_WAIT))
     {
-        retval = NLER_ERROR_NO_RESOURCE;
+        //don't log while holding the lock. a producer that asked to
+        //wait for space is being throttled, so don't complain about it.
+
+        NL_LOG_CRIT(lrERQUEUE, "attempt to post %sevent (%d) to full queue %p with size %d\n",
+                     (aUrgent ? "urgent " : ""), aEvent->mType, queue->mQueue, queue->mQueueSize);
+
+#if NLER_ASSERT_ON_FULL_QUEUE
+        NLER_ASSERT(0);
+#endif
+
+    }
+#if NLER_FEATURE_SIMULATEABLE_TIME
+    else if (queued)
+    {
+        nleventqueue_sim_count_inc();
+    }
+#endif
+
+    return retval;
+}
+
+int nleventqueue_post_event(nleventqueue_t *aEventQueue, const nl_event_t *aEvent)
+{
+    return post_event_to_queue(aEventQueue, aEvent, false, PR_INTERVAL_NO_WAIT);
+}
+
+int nleventqueue_post_event_with_timeout(nleventqueue_t *aEventQueue, const nl_event_t *aEvent, nl_time_ms_t aTimeoutMS)
+{
+    return post_event_to_queue(aEventQueue, aEvent, false, nl_time_ms_to_delay_time_native(aTimeoutMS));
+}
+
+int nleventqueue_post_event_urgent(nleventqueue_t *aEventQueue, const nl_event_t *aEvent)
+{
+    return post_event_to_queue(aEventQueue, aEvent, true, PR_INTERVAL_NO_WAIT);
+}
+
+uint32_t nleventqueue_post_events(nleventqueue_t *aEventQueue, const nl_event_t * const *aEvents, uint32_t aCount)
+{
+    nleventqueue_nspr_t    *queue = *(nleventqueue_nspr_t **)aEventQueue;
+    bool                    queued;
+    bool                    signal = false;
+    uint32_t                retval = 0;
+#if NLER_FEATURE_SIMULATEABLE_TIME
+    uint32_t                queued_count = 0;
+#endif
+
+    if ((aEvents == NULL) || (aCount == 0))
+    {
+        return retval;
+    }
+
+    PR_Lock(queue->mLock);
+
+    while (retval < aCount)
+    {
+        if (put_event_in_queue(queue, aEvents[retval], false, false, &queued) != NLER_SUCCESS)
+        {
+            break;
+        }
+
+        if (queued)
+        {
+            signal = true;
+#if NLER_FEATURE_SIMULATEABLE_TIME
+            queued_count++;
+#endif
+        }
+
+        retval++;
+    }
+
+    if (signal)
+    {
+        PR_SetPollableEvent(queue->mPollableEvent);
+
+        check_queue_watermarks(queue);
     }
 
     PR_Unlock(queue->mLock);
 
-    if (retval == NLER_ERROR_NO_RESOURCE)
+    if (retval < aCount)
     {
         //don't log while holding the lock
 
-        NL_LOG_CRIT(lrERQUEUE, "attempt to post event (%d) to full queue %p with size %d\n",
-                     aEvent->mType, queue->mQueue, queue->mQueueSize);
+        NL_LOG_CRIT(lrERQUEUE, "attempt to post %u events (%d first) to full queue %p with size %d\n",
+                     (unsigned)(aCount - retval), aEvents[retval]->mType, queue->mQueue, queue->mQueueSize);
 
 #if NLER_ASSERT_ON_FULL_QUEUE
         NLER_ASSERT(0);
 #endif
-
     }
+
 #if NLER_FEATURE_SIMULATEABLE_TIME
-    else
+    while (queued_count-- > 0)
     {
-        nl_eventqueue_sim_count_inc();
+        nleventqueue_sim_count_inc();
     }
 #endif
 
@@ -184,12 +594,93 @@ static nl_event_t *remove_event_from_queue(nleventqueue_nspr_t *aQueue)
 {
     nl_event_t  *retval;
 
-    retval = aQueue->mQueue[0];
+    if (aQueue->mUrgentCount > 0)
+    {
+#if NLER_EVENTQUEUE_STATS
+        record_get_in_queue_stats(aQueue, aQueue->mUrgentPostTimes[aQueue->mUrgentHead]);
+#endif
+        retval = take_event_from_ring(aQueue->mUrgent, NLER_EVENTQUEUE_URGENT_DEPTH, &aQueue->mUrgentHead, &aQueue->mUrgentCount);
+    }
+    else
+    {
+#if NLER_EVENTQUEUE_STATS
+        record_get_in_queue_stats(aQueue, aQueue->mPostTimes[aQueue->mQueueHead]);
+#endif
+        retval = take_event_from_ring(aQueue->mQueue, aQueue->mQueueSize, &aQueue->mQueueHead, &aQueue->mQueueCount);
+    }
+
+    return retval;
+}
+
+static size_t remove_events_from_queue(nleventqueue_nspr_t *aQueue, nl_event_t **aOutEvents, size_t aMaxEvents)
+{
+    size_t      retval = 0;
+
+    PR_Lock(aQueue->mLock);
+
+    while ((retval < aMaxEvents) && (count_events_in_queue(aQueue) > 0))
+    {
+        aOutEvents[retval++] = remove_event_from_queue(aQueue);
+    }
+
+    if (retval > 0)
+    {
+        check_queue_watermarks(aQueue);
+    }
+
+    if ((retval > 0) && (aQueue->mSpaceWaiters > 0))
+    {
+        PR_NotifyAllCondVar(aQueue->mNotFull);
+    }
+
+    PR_Unlock(aQueue->mLock);
+
+    return retval;
+}
+
+static size_t get_events_from_queue(nleventqueue_nspr_t *aQueue, nl_event_t **aOutEvents, size_t aMaxEvents, PRIntervalTime aTimeout)
+{
+    size_t                  retval;
+    PRPollDesc              polldesc;
+    PRInt32                 active;
+
+#if NLER_FEATURE_SIMULATEABLE_TIME
+    PR_Lock(aQueue->mLock);
+
+    while (aQueue->prev_get_count > 0)
+    {
+        nleventqueue_sim_count_dec();
+        aQueue->prev_get_count--;
+    }
+
+    PR_Unlock(aQueue->mLock);
+#endif
+
+    retval = remove_events_from_queue(aQueue, aOutEvents, aMaxEvents);
+
+    while (retval == 0)
+    {
+        polldesc.fd = aQueue->mPollableEvent;
+        polldesc.in_flags = PR_POLL_READ | PR_POLL_EXCEPT;
+        polldesc.out_flags = 0;
 
-    aQueue->mQueueEnd--;
+        active = PR_Poll(&polldesc, 1, aTimeout);
+
+        if (active == 1)
+        {
+            PR_WaitForPollableEvent(aQueue->mPollableEvent);
+
+            retval = remove_events_from_queue(aQueue, aOutEvents, aMaxEvents);
+        }
+        else
+        {
+            break;
+        }
+    }
 
-    if (aQueue->mQueueEnd > 0)
-        memmove(aQueue->mQueue, &aQueue->mQueue[1], aQueue->mQueueEnd * sizeof(nl_event_t *));
+#if NLER_FEATURE_SIMULATEABLE_TIME
+    aQueue->prev_get_count = retval;
+#endif
 
     return retval;
 }
@@ -205,74 +696,122 @@ nl_event_t *nleventqueue_get_event_with_timeout_native(nleventqueue_t *aEventQue
 {
     nl_event_t              *retval = NULL;
     nleventqueue_nspr_t     *queue = *(nleventqueue_nspr_t **)aEventQueue;
-    PRPollDesc              polldesc;
-    PRInt32                 active;
 
-    PR_Lock(queue->mLock);
+    get_events_from_queue(queue, &retval, 1, aTimeoutNative);
 
-#if NLER_FEATURE_SIMULATEABLE_TIME
-    if (queue->prev_get_successful == true)
+    return retval;
+}
+
+nl_event_t *nleventqueue_get_event_with_timeout(nleventqueue_t *aEventQueue, nl_time_ms_t aTimeoutMS)
+{
+    return nleventqueue_get_event_with_timeout_native(aEventQueue, PR_MillisecondsToInterval(aTimeoutMS));
+}
+
+uint32_t nleventqueue_get_events(nleventqueue_t *aEventQueue, nl_event_t **aOutEvents, uint32_t aMaxEvents, nl_time_ms_t aTimeoutMS)
+{
+    nleventqueue_nspr_t     *queue = *(nleventqueue_nspr_t **)aEventQueue;
+    uint32_t                retval = 0;
+
+    if ((aOutEvents != NULL) && (aMaxEvents > 0))
     {
-        nl_eventqueue_sim_count_dec();
+        retval = get_events_from_queue(queue, aOutEvents, aMaxEvents, PR_MillisecondsToInterval(aTimeoutMS));
     }
-#endif
 
-    if (queue->mQueueEnd > 0)
+    return retval;
+}
+
+static int find_ready_queue(nleventqueue_t **aEventQueues, size_t aQueueCount)
+{
+    nleventqueue_nspr_t     *queue;
+    size_t                  i;
+    int                     retval = NLER_ERROR_NO_RESOURCE;
+
+    for (i = 0; (i < aQueueCount) && (retval == NLER_ERROR_NO_RESOURCE); i++)
     {
-        retval = remove_event_from_queue(queue);
+        queue = *(nleventqueue_nspr_t **)aEventQueues[i];
+
+        PR_Lock(queue->mLock);
+
+        if (count_events_in_queue(queue) > 0)
+        {
+            retval = (int)i;
+        }
+
+        PR_Unlock(queue->mLock);
     }
 
-    PR_Unlock(queue->mLock);
+    return retval;
+}
 
-    while (retval == NULL)
+int nleventqueue_select(nleventqueue_t **aEventQueues, size_t aQueueCount, nl_time_ms_t aTimeoutMS)
+{
+    PRPollDesc              polldescs[NLER_EVENTQUEUE_SELECT_MAX];
+    const PRIntervalTime    timeout = nl_time_ms_to_delay_time_native(aTimeoutMS);
+    const PRIntervalTime    start = PR_IntervalNow();
+    PRIntervalTime          elapsed;
+    PRInt32                 active;
+    size_t                  i;
+    int                     retval;
+
+    if ((aEventQueues == NULL) || (aQueueCount == 0) || (aQueueCount > NLER_EVENTQUEUE_SELECT_MAX))
     {
-        polldesc.fd = queue->mPollableEvent;
-        polldesc.in_flags = PR_POLL_READ | PR_POLL_EXCEPT;
-        polldesc.out_flags = 0;
+        return NLER_ERROR_BAD_INPUT;
+    }
 
-        active = PR_Poll(&polldesc, 1, aTimeoutNative);
+    retval = find_ready_queue(aEventQueues, aQueueCount);
 
-        if (active == 1)
+    while (retval == NLER_ERROR_NO_RESOURCE)
+    {
+        for (i = 0; i < aQueueCount; i++)
         {
-            PR_WaitForPollableEvent(queue->mPollableEvent);
+            polldescs[i].fd = (*(nleventqueue_nspr_t **)aEventQueues[i])->mPollableEvent;
+            polldescs[i].in_flags = PR_POLL_READ | PR_POLL_EXCEPT;
+            polldescs[i].out_flags = 0;
+        }
 
-            PR_Lock(queue->mLock);
+        if (timeout == PR_INTERVAL_NO_TIMEOUT)
+        {
+            active = PR_Poll(polldescs, aQueueCount, timeout);
+        }
+        else
+        {
+            elapsed = PR_IntervalNow() - start;
 
-            if (queue->mQueueEnd > 0)
+            if (elapsed >= timeout)
             {
-                retval = remove_event_from_queue(queue);
+                break;
             }
 
-            PR_Unlock(queue->mLock);
+            active = PR_Poll(polldescs, aQueueCount, timeout - elapsed);
         }
-        else
+
+        if (active <= 0)
         {
+            retval = find_ready_queue(aEventQueues, aQueueCount);
             break;
         }
-    }
 
-#if NLER_FEATURE_SIMULATEABLE_TIME
-    if (retval)
-    {
-        queue->prev_get_successful = true;
-    }
-    else
-    {
-        queue->prev_get_successful = false;
+        /* A pollable event may remain set after its queue has been
+         * drained without waiting on it; clear any that fired so they
+         * do not spin the poll, then recheck the queues themselves.
+         */
+        for (i = 0; i < aQueueCount; i++)
+        {
+            if (polldescs[i].out_flags != 0)
+            {
+                PR_WaitForPollableEvent(polldescs[i].fd);
+            }
+        }
+
+        retval = find_ready_queue(aEventQueues, aQueueCount);
     }
-#endif
 
     return retval;
 }
 
-nl_event_t *nleventqueue_get_event_with_timeout(nleventqueue_t *aEventQueue, nl_time_ms_t aTimeoutMS)
-{
-    return nleventqueue_get_event_with_timeout_native(aEventQueue, PR_MillisecondsToInterval(aTimeoutMS));
-}
-
 uint32_t nleventqueue_get_count(nleventqueue_t *aEventQueue)
 {
     const nleventqueue_nspr_t  *lEventQueue = *(nleventqueue_nspr_t **)aEventQueue;
 
-    return (lEventQueue->mQueueEnd);
+    return (count_events_in_queue(lEventQueue));
 }
@@ -0,0 +1,175 @@
+/*
+ *
+ *    Copyright (c) 2026 Project nler Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file declares the POSIX threads (pthreads)-specific event
+ *      loop, which lets a task wait on its event queue and on any
+ *      number of file descriptors at once.
+ *
+ *      Readiness of a registered descriptor is delivered as an
+ *      NL_EVENT_T_FD event dispatched, like queued events, through
+ *      nl_dispatch_event(), so sockets, pipes and timerfds need no
+ *      dedicated reader task posting into the queue on their behalf.
+ *
+ */
+
+#ifndef NL_ER_EVENT_LOOP_H
+#define NL_ER_EVENT_LOOP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nlerevent.h>
+#include <nlereventqueue.h>
+#include <nlertime.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NL_EVENT_LOOP_READABLE  0x1 /**< Descriptor may be read without blocking */
+#define NL_EVENT_LOOP_WRITABLE  0x2 /**< Descriptor may be written without blocking */
+#define NL_EVENT_LOOP_ERROR     0x4 /**< Descriptor has hung up or has a pending error */
+
+/** Descriptor readiness event. Initialize the common fields with
+ * NL_INIT_EVENT() using NL_EVENT_T_FD and set mFd and mInterest before
+ * passing the event to nl_event_loop_add_fd(). The loop sets mReady
+ * each time it dispatches the event.
+ */
+typedef struct nl_event_fd_s
+{
+    NL_DECLARE_EVENT
+    int                 mFd;        /**< Descriptor to watch */
+    uint32_t            mInterest;  /**< NL_EVENT_LOOP_READABLE and / or NL_EVENT_LOOP_WRITABLE */
+    uint32_t            mReady;     /**< Conditions observed, including NL_EVENT_LOOP_ERROR */
+} nl_event_fd_t;
+
+/** @cond */
+struct epoll_event;
+/** @endcond */
+
+/** Event loop state. Treat as opaque.
+ */
+typedef struct nl_event_loop_s
+{
+    int                 mPollFd;
+    nleventqueue_t      *mQueue;
+    nl_eventhandler_t   mDefaultHandler;
+    void                *mDefaultClosure;
+    struct epoll_event  *mPending;
+    int                 mPendingCount;
+    bool                mRunning;
+} nl_event_loop_t;
+
+/** Initialize an event loop for a queue.
+ *
+ * @param[in] aLoop            Loop to initialize.
+ *
+ * @param[in] aQueue           Queue whose events the loop dispatches. The
+ *                             loop becomes its only consumer.
+ *
+ * @param[in] aDefaultHandler  Handler for events, queued or descriptor,
+ *                             that do not carry their own. *Must not be
+ *                             NULL*.
+ *
+ * @param[in] aDefaultClosure  Closure passed to aDefaultHandler.
+ *
+ * @return NLER_SUCCESS on success, NLER_ERROR_NOT_IMPLEMENTED where
+ * the platform or queue cannot be polled, otherwise an error code.
+ */
+int nl_event_loop_init(nl_event_loop_t *aLoop, nleventqueue_t *aQueue, nl_eventhandler_t aDefaultHandler, void *aDefaultClosure);
+
+/** Release the resources held by an event loop. Registered descriptors
+ * are not closed.
+ *
+ * @param[in] aLoop  Loop to destroy.
+ */
+void nl_event_loop_destroy(nl_event_loop_t *aLoop);
+
+/** Start watching a descriptor. Watching is level triggered: the event
+ * is dispatched on every pass of the loop for as long as the condition
+ * holds.
+ *
+ * @param[in] aLoop   Loop to add the descriptor to.
+ *
+ * @param[in] aEvent  Readiness event for the descriptor. It must remain
+ *                    valid until removed with nl_event_loop_remove_fd().
+ *
+ * @return NLER_SUCCESS on success, otherwise an error code.
+ */
+int nl_event_loop_add_fd(nl_event_loop_t *aLoop, nl_event_fd_t *aEvent);
+
+/** Change the conditions watched for a descriptor to aEvent->mInterest.
+ *
+ * @param[in] aLoop   Loop the descriptor was added to.
+ *
+ * @param[in] aEvent  Readiness event previously added.
+ *
+ * @return NLER_SUCCESS on success, otherwise an error code.
+ */
+int nl_event_loop_modify_fd(nl_event_loop_t *aLoop, nl_event_fd_t *aEvent);
+
+/** Stop watching a descriptor. This may be called from any handler the
+ * loop dispatches, including that of aEvent itself; the event is not
+ * dispatched again once this returns.
+ *
+ * @param[in] aLoop   Loop the descriptor was added to.
+ *
+ * @param[in] aEvent  Readiness event previously added.
+ *
+ * @return NLER_SUCCESS on success, otherwise an error code.
+ */
+int nl_event_loop_remove_fd(nl_event_loop_t *aLoop, nl_event_fd_t *aEvent);
+
+/** Wait once for queued events or descriptor readiness and dispatch
+ * whatever is ready.
+ *
+ * @param[in] aLoop       Loop to run.
+ *
+ * @param[in] aTimeoutMS  Maximum time to wait for something to become
+ *                        ready.
+ *
+ * @return the number of events dispatched, which is 0 if the timeout
+ * expired, or an error code.
+ */
+int nl_event_loop_run_once(nl_event_loop_t *aLoop, nl_time_ms_t aTimeoutMS);
+
+/** Dispatch events until nl_event_loop_stop() is called from a
+ * handler.
+ *
+ * @param[in] aLoop  Loop to run.
+ *
+ * @return NLER_SUCCESS once stopped, otherwise an error code.
+ */
+int nl_event_loop_run(nl_event_loop_t *aLoop);
+
+/** Ask nl_event_loop_run() to return once it has dispatched the
+ * events already taken from the queue and descriptors. Other tasks
+ * wishing to stop a loop should post it an event whose handler calls
+ * this.
+ *
+ * @param[in] aLoop  Loop to stop.
+ */
+void nl_event_loop_stop(nl_event_loop_t *aLoop);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NL_ER_EVENT_LOOP_H */
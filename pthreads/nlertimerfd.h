@@ -0,0 +1,110 @@
+/*
+ *
+ *    Copyright (c) 2026 Project nler Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file declares the POSIX threads (pthreads)-specific timerfd
+ *      wait used by the timer task when built with
+ *      NLER_FEATURE_TIMER_USING_TIMERFD.
+ *
+ *      Rather than sleeping on its queue for a relative timeout that
+ *      is recomputed, and rounded to milliseconds, on every pass, the
+ *      timer task arms a timerfd with the absolute native time of its
+ *      earliest deadline and waits on that and on its queue together.
+ *      The kernel then wakes the task at the deadline itself, however
+ *      long the task took to get back to waiting.
+ *
+ */
+
+#ifndef NL_ER_TIMERFD_H
+#define NL_ER_TIMERFD_H
+
+#include <stdbool.h>
+
+#include <nlerevent.h>
+#include <nlereventqueue.h>
+#include <nlertime.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** timerfd wait state. Treat as opaque.
+ */
+typedef struct nl_timerfd_s
+{
+    int                 mTimerFd;
+    int                 mQueueFd;
+    nleventqueue_t      *mQueue;
+    nl_time_native_t    mDeadline;
+    bool                mArmed;
+} nl_timerfd_t;
+
+/** Initialize a timerfd wait for a queue.
+ *
+ * @param[in] aTimer  State to initialize.
+ *
+ * @param[in] aQueue  Queue waited on alongside the timerfd. The caller
+ *                    must be its only consumer.
+ *
+ * @return NLER_SUCCESS on success, NLER_ERROR_NOT_IMPLEMENTED where the
+ * platform or queue cannot be polled, otherwise an error code.
+ */
+int nl_timerfd_init(nl_timerfd_t *aTimer, nleventqueue_t *aQueue);
+
+/** Release the resources held by a timerfd wait.
+ *
+ * @param[in] aTimer  State to destroy.
+ */
+void nl_timerfd_destroy(nl_timerfd_t *aTimer);
+
+/** Arm the timerfd to expire once native time reaches aDeadline. A
+ * deadline already reached expires at once. Arming again with an
+ * unchanged deadline costs nothing.
+ *
+ * @param[in] aTimer     State to arm.
+ *
+ * @param[in] aDeadline  Absolute native time at which to expire.
+ *
+ * @return NLER_SUCCESS on success, otherwise an error code.
+ */
+int nl_timerfd_arm(nl_timerfd_t *aTimer, nl_time_native_t aDeadline);
+
+/** Disarm the timerfd such that only the queue can end the wait.
+ *
+ * @param[in] aTimer  State to disarm.
+ *
+ * @return NLER_SUCCESS on success, otherwise an error code.
+ */
+int nl_timerfd_disarm(nl_timerfd_t *aTimer);
+
+/** Wait until the queue holds an event or the timerfd expires. An
+ * expiry disarms the timerfd.
+ *
+ * @param[in] aTimer  State to wait on.
+ *
+ * @return the event taken from the queue, or NULL if the deadline was
+ * reached first.
+ */
+nl_event_t *nl_timerfd_get_event(nl_timerfd_t *aTimer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NL_ER_TIMERFD_H */
@@ -0,0 +1,407 @@
+/*
+ *
+ *    Copyright (c) 2026 Project nler Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements the POSIX threads (pthreads)-specific
+ *      event loop over epoll.
+ *
+ *      The queue is watched through its pollable descriptor alongside
+ *      the registered descriptors. Each pass takes at most a bounded
+ *      batch from the queue such that a busy queue cannot starve the
+ *      descriptors, nor the other way around.
+ *
+ */
+
+#include <nlereventloop.h>
+
+#include <errno.h>
+#include <limits.h>
+#include <stddef.h>
+
+#if defined(__linux__)
+#include <unistd.h>
+
+#include <sys/epoll.h>
+#endif
+
+#include <nlererror.h>
+
+#define kEventLoopMaxReady      16  /* descriptors taken per pass */
+#define kEventLoopQueueBudget   16  /* queued events taken per pass */
+
+#if defined(__linux__)
+
+static int nl_event_loop_pthreads_error(int aErrno)
+{
+    int retval;
+
+    switch (aErrno)
+    {
+
+    case EBADF:
+    case EINVAL:
+    case EPERM:
+        retval = NLER_ERROR_BAD_INPUT;
+        break;
+
+    case EEXIST:
+    case ENOENT:
+        retval = NLER_ERROR_BAD_STATE;
+        break;
+
+    case ENOMEM:
+        retval = NLER_ERROR_NO_MEMORY;
+        break;
+
+    case EMFILE:
+    case ENFILE:
+    case ENOSPC:
+        retval = NLER_ERROR_NO_RESOURCE;
+        break;
+
+    default:
+        retval = NLER_ERROR_FAILURE;
+        break;
+
+    }
+
+    return retval;
+}
+
+static uint32_t nl_event_loop_pthreads_to_epoll(uint32_t aInterest)
+{
+    uint32_t retval = 0;
+
+    if (aInterest & NL_EVENT_LOOP_READABLE)
+        retval |= EPOLLIN;
+
+    if (aInterest & NL_EVENT_LOOP_WRITABLE)
+        retval |= EPOLLOUT;
+
+    return retval;
+}
+
+static uint32_t nl_event_loop_pthreads_from_epoll(uint32_t aEvents)
+{
+    uint32_t retval = 0;
+
+    if (aEvents & EPOLLIN)
+        retval |= NL_EVENT_LOOP_READABLE;
+
+    if (aEvents & EPOLLOUT)
+        retval |= NL_EVENT_LOOP_WRITABLE;
+
+    if (aEvents & (EPOLLERR | EPOLLHUP))
+        retval |= NL_EVENT_LOOP_ERROR;
+
+    return retval;
+}
+
+static int nl_event_loop_pthreads_ctl(nl_event_loop_t *aLoop, int aOperation, nl_event_fd_t *aEvent)
+{
+    struct epoll_event  ev;
+    int                 retval = NLER_SUCCESS;
+
+    if ((aLoop == NULL) || (aEvent == NULL) || (aEvent->mFd < 0))
+    {
+        retval = NLER_ERROR_BAD_INPUT;
+        goto done;
+    }
+
+    ev.events   = nl_event_loop_pthreads_to_epoll(aEvent->mInterest);
+    ev.data.ptr = aEvent;
+
+    if (epoll_ctl(aLoop->mPollFd, aOperation, aEvent->mFd, &ev) != 0)
+    {
+        retval = nl_event_loop_pthreads_error(errno);
+    }
+
+ done:
+    return retval;
+}
+
+static int nl_event_loop_pthreads_drain_queue(nl_event_loop_t *aLoop)
+{
+    nl_event_t  *events[kEventLoopQueueBudget];
+    uint32_t    count;
+    uint32_t    i;
+
+    count = nleventqueue_get_events(aLoop->mQueue, events, kEventLoopQueueBudget, NLER_TIMEOUT_NOW);
+
+    for (i = 0; i < count; i++)
+    {
+        nl_dispatch_event(events[i], aLoop->mDefaultHandler, aLoop->mDefaultClosure);
+    }
+
+    return (int)count;
+}
+
+int nl_event_loop_init(nl_event_loop_t *aLoop, nleventqueue_t *aQueue, nl_eventhandler_t aDefaultHandler, void *aDefaultClosure)
+{
+    struct epoll_event  ev;
+    int                 queue_fd;
+    int                 retval = NLER_SUCCESS;
+
+    if ((aLoop == NULL) || (aQueue == NULL) || (aDefaultHandler == NULL))
+    {
+        retval = NLER_ERROR_BAD_INPUT;
+        goto done;
+    }
+
+    queue_fd = nleventqueue_get_pollable_fd(aQueue);
+
+    if (queue_fd < 0)
+    {
+        retval = queue_fd;
+        goto done;
+    }
+
+    aLoop->mPollFd = epoll_create1(EPOLL_CLOEXEC);
+
+    if (aLoop->mPollFd < 0)
+    {
+        retval = nl_event_loop_pthreads_error(errno);
+        goto done;
+    }
+
+    // the loop itself stands in for the queue in the ready list since
+    // it can never be mistaken for a readiness event.
+
+    ev.events   = EPOLLIN;
+    ev.data.ptr = aLoop;
+
+    if (epoll_ctl(aLoop->mPollFd, EPOLL_CTL_ADD, queue_fd, &ev) != 0)
+    {
+        retval = nl_event_loop_pthreads_error(errno);
+        goto close_poll;
+    }
+
+    aLoop->mQueue          = aQueue;
+    aLoop->mDefaultHandler = aDefaultHandler;
+    aLoop->mDefaultClosure = aDefaultClosure;
+    aLoop->mPending        = NULL;
+    aLoop->mPendingCount   = 0;
+    aLoop->mRunning        = false;
+
+    goto done;
+
+ close_poll:
+    close(aLoop->mPollFd);
+
+    aLoop->mPollFd = -1;
+
+ done:
+    return retval;
+}
+
+void nl_event_loop_destroy(nl_event_loop_t *aLoop)
+{
+    if ((aLoop != NULL) && (aLoop->mPollFd >= 0))
+    {
+        close(aLoop->mPollFd);
+
+        aLoop->mPollFd = -1;
+    }
+}
+
+int nl_event_loop_add_fd(nl_event_loop_t *aLoop, nl_event_fd_t *aEvent)
+{
+    return nl_event_loop_pthreads_ctl(aLoop, EPOLL_CTL_ADD, aEvent);
+}
+
+int nl_event_loop_modify_fd(nl_event_loop_t *aLoop, nl_event_fd_t *aEvent)
+{
+    return nl_event_loop_pthreads_ctl(aLoop, EPOLL_CTL_MOD, aEvent);
+}
+
+int nl_event_loop_remove_fd(nl_event_loop_t *aLoop, nl_event_fd_t *aEvent)
+{
+    int retval;
+    int i;
+
+    retval = nl_event_loop_pthreads_ctl(aLoop, EPOLL_CTL_DEL, aEvent);
+
+    if (retval == NLER_SUCCESS)
+    {
+        // the event may still be waiting its turn in the pass being
+        // dispatched; make sure it is skipped.
+
+        for (i = 0; i < aLoop->mPendingCount; i++)
+        {
+            if (aLoop->mPending[i].data.ptr == aEvent)
+            {
+                aLoop->mPending[i].data.ptr = NULL;
+            }
+        }
+    }
+
+    return retval;
+}
+
+int nl_event_loop_run_once(nl_event_loop_t *aLoop, nl_time_ms_t aTimeoutMS)
+{
+    struct epoll_event  ready[kEventLoopMaxReady];
+    nl_event_fd_t       *event;
+    int                 timeout;
+    int                 count;
+    int                 i;
+    int                 retval = 0;
+
+    if (aLoop == NULL)
+    {
+        retval = NLER_ERROR_BAD_INPUT;
+        goto done;
+    }
+
+    if (aTimeoutMS == NLER_TIMEOUT_NEVER)
+        timeout = -1;
+    else if (aTimeoutMS > INT_MAX)
+        timeout = INT_MAX;
+    else
+        timeout = (int)aTimeoutMS;
+
+    count = epoll_wait(aLoop->mPollFd, ready, kEventLoopMaxReady, timeout);
+
+    if (count < 0)
+    {
+        if (errno != EINTR)
+        {
+            retval = nl_event_loop_pthreads_error(errno);
+        }
+
+        goto done;
+    }
+
+    aLoop->mPending      = ready;
+    aLoop->mPendingCount = count;
+
+    for (i = 0; i < count; i++)
+    {
+        if (ready[i].data.ptr == aLoop)
+        {
+            retval += nl_event_loop_pthreads_drain_queue(aLoop);
+        }
+        else if (ready[i].data.ptr != NULL)
+        {
+            event = (nl_event_fd_t *)ready[i].data.ptr;
+
+            event->mReady = nl_event_loop_pthreads_from_epoll(ready[i].events);
+
+            nl_dispatch_event((nl_event_t *)event, aLoop->mDefaultHandler, aLoop->mDefaultClosure);
+
+            retval++;
+        }
+    }
+
+    aLoop->mPending      = NULL;
+    aLoop->mPendingCount = 0;
+
+ done:
+    return retval;
+}
+
+#else /* defined(__linux__) */
+
+int nl_event_loop_init(nl_event_loop_t *aLoop, nleventqueue_t *aQueue, nl_eventhandler_t aDefaultHandler, void *aDefaultClosure)
+{
+    (void)aQueue;
+    (void)aDefaultHandler;
+    (void)aDefaultClosure;
+
+    if (aLoop != NULL)
+    {
+        aLoop->mPollFd = -1;
+    }
+
+    return NLER_ERROR_NOT_IMPLEMENTED;
+}
+
+void nl_event_loop_destroy(nl_event_loop_t *aLoop)
+{
+    (void)aLoop;
+}
+
+int nl_event_loop_add_fd(nl_event_loop_t *aLoop, nl_event_fd_t *aEvent)
+{
+    (void)aLoop;
+    (void)aEvent;
+
+    return NLER_ERROR_NOT_IMPLEMENTED;
+}
+
+int nl_event_loop_modify_fd(nl_event_loop_t *aLoop, nl_event_fd_t *aEvent)
+{
+    (void)aLoop;
+    (void)aEvent;
+
+    return NLER_ERROR_NOT_IMPLEMENTED;
+}
+
+int nl_event_loop_remove_fd(nl_event_loop_t *aLoop, nl_event_fd_t *aEvent)
+{
+    (void)aLoop;
+    (void)aEvent;
+
+    return NLER_ERROR_NOT_IMPLEMENTED;
+}
+
+int nl_event_loop_run_once(nl_event_loop_t *aLoop, nl_time_ms_t aTimeoutMS)
+{
+    (void)aLoop;
+    (void)aTimeoutMS;
+
+    return NLER_ERROR_NOT_IMPLEMENTED;
+}
+
+#endif /* defined(__linux__) */
+
+int nl_event_loop_run(nl_event_loop_t *aLoop)
+{
+    int retval = NLER_SUCCESS;
+    int status;
+
+    if (aLoop == NULL)
+    {
+        retval = NLER_ERROR_BAD_INPUT;
+        goto done;
+    }
+
+    aLoop->mRunning = true;
+
+    while (aLoop->mRunning)
+    {
+        status = nl_event_loop_run_once(aLoop, NLER_TIMEOUT_NEVER);
+
+        if (status < 0)
+        {
+            retval = status;
+            break;
+        }
+    }
+
+    aLoop->mRunning = false;
+
+ done:
+    return retval;
+}
+
+void nl_event_loop_stop(nl_event_loop_t *aLoop)
+{
+    aLoop->mRunning = false;
+}
@@ -21,136 +21,528 @@
  *      This file implements NLER pooled events under the POSIX
  *      threads (pthreads) build platform.
  *
+ *      The caller's pool memory is divided between one or more size
+ *      classes, each carved into fixed-size blocks kept on a lock-free,
+ *      LIFO free list such that getting and recycling events costs no
+ *      heap traffic. Each list is threaded through a per-block array of
+ *      successor indices and its head packs the index of the first free
+ *      block, plus one such that zero means empty, with a tag bumped by
+ *      every update so a task holding a stale head can never swap it
+ *      back in. As no block on the list is written while the tag stands
+ *      still, a run of blocks may be taken or returned with a single
+ *      swap.
+ *
+ *      In front of each list sit NLER_EVENT_POOL_MAGAZINES small
+ *      caches, or magazines, each shared by the tasks whose slot maps
+ *      onto it. Tasks get and recycle events through their magazine,
+ *      which trades half of its capacity at a time with the list, and
+ *      only fall back on the list when their magazine is busy. A task
+ *      that finds both empty takes from the other magazines before
+ *      giving up, waiting for any that is busy rather than passing it
+ *      by, so cached events are never stranded.
+ *
  */
 
-#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include <nleratomicops.h>
+#include <nlercfg.h>
 #include <nlererror.h>
 #include <nlerlog.h>
 #include <nlereventpooled.h>
 
+#include "nlfutex-pthreads.h"
+
+#define kFreeListLinkBits   (sizeof (intptr_t) * 4)
+#define kFreeListLinkMask   ((((uintptr_t)1) << kFreeListLinkBits) - 1)
+
+#define kBlockAlignment     sizeof(uint64_t)
+
+#define kMagazineBatch      (NLER_EVENT_POOL_MAGAZINE_SIZE / 2)
+#define kCacheLineSize      64
+
+#if NLER_EVENT_POOL_MAGAZINES
+/* mBusy is 0 when the magazine is free, 1 when it is held and 2 when
+ * it is held and some task may be waiting for it.
+ */
+typedef struct nlevent_pool_magazine_pthreads_s
+{
+    nlfutex_t           mBusy;
+    uint32_t            mCount;
+    uint32_t            mBlocks[NLER_EVENT_POOL_MAGAZINE_SIZE];
+} __attribute__((aligned(kCacheLineSize))) nlevent_pool_magazine_pthreads_t;
+#endif
+
+typedef struct nlevent_pool_class_pthreads_s
+{
+    intptr_t            mFreeHead;
+    uint8_t            *mEvents;
+    size_t              mEventSize;
+    uint32_t            mEventCount;
+    uint32_t           *mNext;
+#if NLER_EVENT_POOL_MAGAZINES
+    nlevent_pool_magazine_pthreads_t mMagazines[NLER_EVENT_POOL_MAGAZINES];
+#endif
+} __attribute__((aligned(kCacheLineSize))) nlevent_pool_class_pthreads_t;
+
 typedef struct nlevent_pool_pthreads_s
 {
-    pthread_mutex_t mLock;
-    int             mFreeEvents;
+    size_t              mClassCount;
+    nlevent_pool_class_pthreads_t mClasses[];
 } nlevent_pool_pthreads_t;
 
-int nlevent_pool_create(void *aPoolMemory, int32_t aPoolMemorySize, nlevent_pool_t *aPoolObj)
+#if NLER_EVENT_POOL_MAGAZINES
+static __thread uint32_t sMagazineSlot;
+static uint32_t          sMagazineSlots;
+#endif
+
+static intptr_t nlevent_pool_pthreads_make_head(intptr_t aPrevious, uint32_t aLink)
+{
+    const uintptr_t tag = ((uintptr_t)aPrevious >> kFreeListLinkBits) + 1;
+
+    return (intptr_t)((tag << kFreeListLinkBits) | aLink);
+}
+
+static uint32_t nlevent_pool_pthreads_head_link(intptr_t aHead)
+{
+    return (uint32_t)((uintptr_t)aHead & kFreeListLinkMask);
+}
+
+/* Take up to aMax blocks from the front of the list. The run is read
+ * before it is claimed and may change under us, but then so will the
+ * tag and the swap will fail.
+ */
+static uint32_t nlevent_pool_pthreads_pop(nlevent_pool_class_pthreads_t *aClass, uint32_t *aOutBlocks, uint32_t aMax)
+{
+    intptr_t    head = aClass->mFreeHead;
+    intptr_t    expected;
+    uint32_t    link;
+    uint32_t    count;
+
+    do
+    {
+        expected = head;
+        link     = nlevent_pool_pthreads_head_link(head);
+        count    = 0;
+
+        while ((link != 0) && (count < aMax))
+        {
+            aOutBlocks[count++] = link - 1;
+
+            link = aClass->mNext[link - 1];
+        }
+
+        if (count == 0)
+        {
+            break;
+        }
+
+        head = nl_er_atomic_cas(&aClass->mFreeHead, expected, nlevent_pool_pthreads_make_head(expected, link));
+    }
+    while (head != expected);
+
+    return count;
+}
+
+/* Return aCount blocks, which the caller owns, to the front of the
+ * list.
+ */
+static void nlevent_pool_pthreads_push(nlevent_pool_class_pthreads_t *aClass, const uint32_t *aBlocks, uint32_t aCount)
+{
+    const uint32_t  last = aBlocks[aCount - 1];
+    intptr_t        head = aClass->mFreeHead;
+    intptr_t        expected;
+    uint32_t        i;
+
+    for (i = 0; (i + 1) < aCount; i++)
+    {
+        aClass->mNext[aBlocks[i]] = aBlocks[i + 1] + 1;
+    }
+
+    do
+    {
+        aClass->mNext[last] = nlevent_pool_pthreads_head_link(head);
+
+        expected = head;
+
+        head = nl_er_atomic_cas(&aClass->mFreeHead, expected, nlevent_pool_pthreads_make_head(expected, aBlocks[0] + 1));
+    }
+    while (head != expected);
+}
+
+#if NLER_EVENT_POOL_MAGAZINES
+static bool nlevent_pool_pthreads_try_lock_magazine(nlevent_pool_magazine_pthreads_t *aMagazine)
+{
+    uint32_t expected = 0;
+
+    return __atomic_compare_exchange_n(&aMagazine->mBusy, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+/* Sleep, rather than spin, until the magazine is free, such that a
+ * holder of lower priority gets to run and let go of it.
+ */
+static void nlevent_pool_pthreads_lock_magazine(nlevent_pool_magazine_pthreads_t *aMagazine)
+{
+    if (!nlevent_pool_pthreads_try_lock_magazine(aMagazine))
+    {
+        while (__atomic_exchange_n(&aMagazine->mBusy, 2, __ATOMIC_ACQUIRE) != 0)
+        {
+            nlfutex_pthreads_wait(&aMagazine->mBusy, 2, NULL);
+        }
+    }
+}
+
+static void nlevent_pool_pthreads_unlock_magazine(nlevent_pool_magazine_pthreads_t *aMagazine)
+{
+    if (__atomic_exchange_n(&aMagazine->mBusy, 0, __ATOMIC_RELEASE) == 2)
+    {
+        nlfutex_pthreads_wake(&aMagazine->mBusy, 1);
+    }
+}
+
+static nlevent_pool_magazine_pthreads_t *nlevent_pool_pthreads_get_magazine(nlevent_pool_class_pthreads_t *aClass)
+{
+    if (sMagazineSlot == 0)
+    {
+        sMagazineSlot = __atomic_add_fetch(&sMagazineSlots, 1, __ATOMIC_RELAXED);
+    }
+
+    return &aClass->mMagazines[sMagazineSlot % NLER_EVENT_POOL_MAGAZINES];
+}
+
+static bool nlevent_pool_pthreads_magazine_get(nlevent_pool_class_pthreads_t *aClass, uint32_t *aOutBlock)
+{
+    nlevent_pool_magazine_pthreads_t   *lMagazine = nlevent_pool_pthreads_get_magazine(aClass);
+    bool                                retval = false;
+
+    if (nlevent_pool_pthreads_try_lock_magazine(lMagazine))
+    {
+        if (lMagazine->mCount == 0)
+        {
+            lMagazine->mCount = nlevent_pool_pthreads_pop(aClass, lMagazine->mBlocks, kMagazineBatch);
+        }
+
+        if (lMagazine->mCount > 0)
+        {
+            *aOutBlock = lMagazine->mBlocks[--lMagazine->mCount];
+
+            retval = true;
+        }
+
+        nlevent_pool_pthreads_unlock_magazine(lMagazine);
+    }
+
+    return retval;
+}
+
+static bool nlevent_pool_pthreads_magazine_put(nlevent_pool_class_pthreads_t *aClass, uint32_t aBlock)
+{
+    nlevent_pool_magazine_pthreads_t   *lMagazine = nlevent_pool_pthreads_get_magazine(aClass);
+    bool                                retval = false;
+
+    if (nlevent_pool_pthreads_try_lock_magazine(lMagazine))
+    {
+        if (lMagazine->mCount == NLER_EVENT_POOL_MAGAZINE_SIZE)
+        {
+            // hand the least recently recycled half back to the list.
+
+            nlevent_pool_pthreads_push(aClass, lMagazine->mBlocks, kMagazineBatch);
+
+            lMagazine->mCount -= kMagazineBatch;
+
+            memmove(&lMagazine->mBlocks[0], &lMagazine->mBlocks[kMagazineBatch], lMagazine->mCount * sizeof(uint32_t));
+        }
+
+        lMagazine->mBlocks[lMagazine->mCount++] = aBlock;
+
+        nlevent_pool_pthreads_unlock_magazine(lMagazine);
+
+        retval = true;
+    }
+
+    return retval;
+}
+
+static bool nlevent_pool_pthreads_magazine_steal(nlevent_pool_class_pthreads_t *aClass, uint32_t *aOutBlock)
+{
+    nlevent_pool_magazine_pthreads_t   *lMagazine;
+    bool                                retval = false;
+    size_t                              i;
+
+    for (i = 0; (i < NLER_EVENT_POOL_MAGAZINES) && !retval; i++)
+    {
+        lMagazine = &aClass->mMagazines[i];
+
+        // a busy magazine may be holding the last free events, or
+        // taking them off the list, even while it looks empty. One
+        // seen free has its count up to date.
+
+        if ((__atomic_load_n(&lMagazine->mBusy, __ATOMIC_ACQUIRE) != 0) ||
+            (__atomic_load_n(&lMagazine->mCount, __ATOMIC_RELAXED) > 0))
+        {
+            nlevent_pool_pthreads_lock_magazine(lMagazine);
+
+            if (lMagazine->mCount > 0)
+            {
+                *aOutBlock = lMagazine->mBlocks[--lMagazine->mCount];
+
+                retval = true;
+            }
+
+            nlevent_pool_pthreads_unlock_magazine(lMagazine);
+        }
+    }
+
+    return retval;
+}
+#endif /* NLER_EVENT_POOL_MAGAZINES */
+
+static nlevent_pooled_t *nlevent_pool_pthreads_class_get(nlevent_pool_class_pthreads_t *aClass)
+{
+    nlevent_pooled_t   *retval = NULL;
+    uint32_t            block;
+    bool                found = false;
+
+#if NLER_EVENT_POOL_MAGAZINES
+    found = nlevent_pool_pthreads_magazine_get(aClass, &block);
+#endif
+
+    if (!found)
+    {
+        found = (nlevent_pool_pthreads_pop(aClass, &block, 1) == 1);
+    }
+
+#if NLER_EVENT_POOL_MAGAZINES
+    if (!found)
+    {
+        found = nlevent_pool_pthreads_magazine_steal(aClass, &block);
+    }
+#endif
+
+    if (found)
+    {
+        retval = (nlevent_pooled_t *)(aClass->mEvents + (block * aClass->mEventSize));
+    }
+
+    return retval;
+}
+
+static void nlevent_pool_pthreads_class_put(nlevent_pool_class_pthreads_t *aClass, uint32_t aBlock)
 {
-    nlevent_pool_pthreads_t     *lPool;
-    int                          status;
-    int                          retval = NLER_SUCCESS;
-    pthread_mutexattr_t          mutexattr;
+    bool cached = false;
+
+#if NLER_EVENT_POOL_MAGAZINES
+    cached = nlevent_pool_pthreads_magazine_put(aClass, aBlock);
+#endif
 
-    if ((aPoolMemory == NULL) || (aPoolMemorySize == 0) || (aPoolObj == NULL))
+    if (!cached)
+    {
+        nlevent_pool_pthreads_push(aClass, &aBlock, 1);
+    }
+}
+
+int nlevent_pool_create_sized(void *aPoolMemory, int32_t aPoolMemorySize, const nlevent_pool_size_class_t *aSizeClasses, size_t aSizeClassCount, nlevent_pool_t *aPoolObj)
+{
+    nlevent_pool_pthreads_t        *lPool;
+    nlevent_pool_class_pthreads_t  *lClass;
+    uint32_t                       *lNext;
+    uintptr_t                       cursor;
+    uintptr_t                       last;
+    size_t                          size;
+    size_t                          blocks = 0;
+    size_t                          i;
+    uint32_t                        index;
+    int                             retval = NLER_SUCCESS;
+
+    if ((aPoolMemory == NULL) || (aPoolMemorySize <= 0) || (aSizeClasses == NULL) || (aSizeClassCount == 0) || (aPoolObj == NULL))
     {
         retval = NLER_ERROR_BAD_INPUT;
         goto done;
     }
 
-    status = pthread_mutexattr_init(&mutexattr);
-    if (status != 0)
+    // check the classes fit in the pool memory before committing to
+    // them; the link is the block index plus one and must fit beside
+    // the tag.
+
+    cursor = (uintptr_t)aPoolMemory;
+    last   = (uintptr_t)aPoolMemory + (uintptr_t)aPoolMemorySize;
+
+    for (i = 0; i < aSizeClassCount; i++)
     {
-        retval = NLER_ERROR_FAILURE;
-        goto done;
+        if ((aSizeClasses[i].mEventSize < sizeof(nlevent_pooled_t)) ||
+            ((i > 0) && (aSizeClasses[i].mEventSize <= aSizeClasses[i - 1].mEventSize)) ||
+            (aSizeClasses[i].mEventCount == 0) ||
+            (aSizeClasses[i].mEventCount >= kFreeListLinkMask))
+        {
+            retval = NLER_ERROR_BAD_INPUT;
+            goto done;
+        }
+
+        size   = (aSizeClasses[i].mEventSize + kBlockAlignment - 1) & ~(kBlockAlignment - 1);
+        cursor = (cursor + kBlockAlignment - 1) & ~(kBlockAlignment - 1);
+
+        if ((cursor > last) || (aSizeClasses[i].mEventCount > ((last - cursor) / size)))
+        {
+            retval = NLER_ERROR_BAD_INPUT;
+            goto done;
+        }
+
+        cursor += aSizeClasses[i].mEventCount * size;
+        blocks += aSizeClasses[i].mEventCount;
     }
 
-    lPool = (nlevent_pool_pthreads_t *)calloc(1, sizeof(nlevent_pool_pthreads_t));
-    if (lPool == NULL)
+    // the pool is aligned to a cache line such that the classes and
+    // magazines in it do not share lines with one another.
+
+    if (posix_memalign((void **)&lPool, kCacheLineSize, sizeof(nlevent_pool_pthreads_t) + (aSizeClassCount * sizeof(nlevent_pool_class_pthreads_t)) + (blocks * sizeof(uint32_t))) != 0)
     {
         retval = NLER_ERROR_NO_MEMORY;
-        goto mutexattr_destroy;
+        goto done;
     }
 
-    status = pthread_mutex_init(&lPool->mLock, &mutexattr);
-    if (status != 0)
+    memset(lPool, 0, sizeof(nlevent_pool_pthreads_t) + (aSizeClassCount * sizeof(nlevent_pool_class_pthreads_t)));
+
+    lPool->mClassCount = aSizeClassCount;
+
+    cursor = (uintptr_t)aPoolMemory;
+    lNext  = (uint32_t *)&lPool->mClasses[aSizeClassCount];
+
+    for (i = 0; i < aSizeClassCount; i++)
     {
-        retval = NLER_ERROR_FAILURE;
-        goto dealloc;
-    }
+        lClass = &lPool->mClasses[i];
+        cursor = (cursor + kBlockAlignment - 1) & ~(kBlockAlignment - 1);
 
-    lPool->mFreeEvents = aPoolMemorySize / sizeof(nlevent_pooled_t);
+        lClass->mEvents     = (uint8_t *)cursor;
+        lClass->mEventSize  = (aSizeClasses[i].mEventSize + kBlockAlignment - 1) & ~(kBlockAlignment - 1);
+        lClass->mEventCount = aSizeClasses[i].mEventCount;
+        lClass->mNext       = lNext;
 
-    *aPoolObj = (nlevent_pool_t)lPool;
+        // hand blocks out in address order to begin with.
 
-    return (retval);
+        for (index = 0; index < lClass->mEventCount; index++)
+        {
+            lClass->mNext[index] = ((index + 1) < lClass->mEventCount) ? (index + 2) : 0;
+        }
 
- dealloc:
-    free(lPool);
+        lClass->mFreeHead = 1;
 
-mutexattr_destroy:
-    pthread_mutexattr_destroy(&mutexattr);
+        cursor += lClass->mEventCount * lClass->mEventSize;
+        lNext  += lClass->mEventCount;
+    }
+
+    *aPoolObj = (nlevent_pool_t)lPool;
 
  done:
-    NL_LOG_CRIT(lrERPOOLED, "failed to allocate event pool lock\n");
+    if (retval != NLER_SUCCESS)
+    {
+        NL_LOG_CRIT(lrERPOOLED, "failed to create event pool from %p with size %d\n", aPoolMemory, aPoolMemorySize);
+    }
 
     return (retval);
 }
 
+int nlevent_pool_create(void *aPoolMemory, int32_t aPoolMemorySize, nlevent_pool_t *aPoolObj)
+{
+    nlevent_pool_size_class_t    lSizeClass;
+    uintptr_t                    first;
+    uintptr_t                    last;
+
+    lSizeClass.mEventSize  = sizeof(nlevent_pooled_t);
+    lSizeClass.mEventCount = 0;
+
+    // as many events as fit, once the memory is aligned.
+
+    if ((aPoolMemory != NULL) && (aPoolMemorySize > 0))
+    {
+        first = ((uintptr_t)aPoolMemory + kBlockAlignment - 1) & ~(kBlockAlignment - 1);
+        last  = (uintptr_t)aPoolMemory + (uintptr_t)aPoolMemorySize;
+
+        if (first < last)
+        {
+            lSizeClass.mEventSize  = (sizeof(nlevent_pooled_t) + kBlockAlignment - 1) & ~(kBlockAlignment - 1);
+            lSizeClass.mEventCount = (uint32_t)((last - first) / lSizeClass.mEventSize);
+
+            if (lSizeClass.mEventCount >= kFreeListLinkMask)
+            {
+                lSizeClass.mEventCount = kFreeListLinkMask - 1;
+            }
+        }
+    }
+
+    return nlevent_pool_create_sized(aPoolMemory, aPoolMemorySize, &lSizeClass, 1, aPoolObj);
+}
+
 void nlevent_pool_destroy(nlevent_pool_t *aPool)
 {
     nlevent_pool_pthreads_t    *lPool = *(nlevent_pool_pthreads_t **)aPool;
 
     if (lPool != NULL)
     {
-        pthread_mutex_destroy(&lPool->mLock);
-
         free(lPool);
     }
 }
 
-nlevent_pooled_t *nlevent_pool_get_event(nlevent_pool_t *aPool)
+nlevent_pooled_t *nlevent_pool_get_event_sized(nlevent_pool_t *aPool, size_t aSize)
 {
     nlevent_pooled_t            *retval = NULL;
     nlevent_pool_pthreads_t     *lPool = *(nlevent_pool_pthreads_t **)aPool;
-    int                          freeevs, status;
+    size_t                       i;
 
     if (lPool != NULL)
     {
-        status = pthread_mutex_lock(&lPool->mLock);
-        if (status != 0)
-        {
-            goto done;
-        }
-
-        freeevs = --lPool->mFreeEvents;
-
-        status = pthread_mutex_unlock(&lPool->mLock);
-        if (status != 0)
+        for (i = 0; (i < lPool->mClassCount) && (retval == NULL); i++)
         {
-            goto done;
+            if (lPool->mClasses[i].mEventSize >= aSize)
+            {
+                retval = nlevent_pool_pthreads_class_get(&lPool->mClasses[i]);
+            }
         }
 
-        if (freeevs >= 0)
-        {
-            retval = (nlevent_pooled_t *)malloc(sizeof(nlevent_pooled_t));
-        }
-        else
+        if (retval == NULL)
         {
-            NL_LOG_DEBUG(lrERPOOLED, "no more events in event pool\n");
+            NL_LOG_DEBUG(lrERPOOLED, "no more events of %u bytes in event pool\n", (unsigned)aSize);
         }
     }
 
- done:
     return retval;
 }
 
+nlevent_pooled_t *nlevent_pool_get_event(nlevent_pool_t *aPool)
+{
+    return nlevent_pool_get_event_sized(aPool, sizeof(nlevent_pooled_t));
+}
+
 void nlevent_pool_recycle_event(nlevent_pool_t *aPool, nlevent_pooled_t *aEvent)
 {
-    nlevent_pool_pthreads_t *lPool = *(nlevent_pool_pthreads_t **)aPool;
+    nlevent_pool_pthreads_t        *lPool = *(nlevent_pool_pthreads_t **)aPool;
+    nlevent_pool_class_pthreads_t  *lClass;
+    uintptr_t                       offset;
+    bool                            recycled = false;
+    size_t                          i;
 
-    if (lPool != NULL)
+    if ((lPool != NULL) && (aEvent != NULL))
     {
-        pthread_mutex_lock(&lPool->mLock);
+        for (i = 0; (i < lPool->mClassCount) && !recycled; i++)
+        {
+            lClass = &lPool->mClasses[i];
+            offset = (uintptr_t)aEvent - (uintptr_t)lClass->mEvents;
 
-        lPool->mFreeEvents++;
+            if (((uint8_t *)aEvent >= lClass->mEvents) &&
+                (offset < (lClass->mEventCount * lClass->mEventSize)) &&
+                ((offset % lClass->mEventSize) == 0))
+            {
+                nlevent_pool_pthreads_class_put(lClass, (uint32_t)(offset / lClass->mEventSize));
 
-        pthread_mutex_unlock(&lPool->mLock);
+                recycled = true;
+            }
+        }
 
-        if (aEvent != NULL)
+        if (!recycled)
         {
-            free(aEvent);
+            NL_LOG_CRIT(lrERPOOLED, "attempt to recycle event (%p) not from pool %p\n", aEvent, lPool);
         }
     }
 }
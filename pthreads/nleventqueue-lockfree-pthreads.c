@@ -0,0 +1,1047 @@
+/*
+ *
+ *    Copyright (c) 2026 Project nler Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements NLER event queues under the POSIX threads
+ *      (pthreads) build platform as lock-free, bounded,
+ *      multi-producer / single-consumer queues when the NLER lock-free
+ *      queue feature has been enabled.
+ *
+ *      Each slot carries a sequence number that producers and the
+ *      consumer use to claim and publish it, such that no task ever
+ *      blocks another while posting or getting. Only one task at a
+ *      time may get events from a given queue.
+ *
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <nlercfg.h>
+#include <nlereventqueue.h>
+#include <nlerlog.h>
+#include <nlererror.h>
+
+#include <pthread.h>
+#include <time.h>
+
+#if defined(__linux__)
+#include <unistd.h>
+
+#include <sys/eventfd.h>
+#endif
+
+#include "nlfutex-pthreads.h"
+
+#if NLER_FEATURE_SIMULATEABLE_TIME
+#include "nlereventqueue_sim.h"
+#endif
+
+#if NLER_EVENTQUEUE_STATS
+#include "nlereventqueue_stats.h"
+#endif
+
+#if NLER_FEATURE_LOCK_FREE_QUEUE
+
+#define kCacheLineSize 64
+
+/* Urgent events travel in a lane of their own, which the consumer
+ * always drains first.
+ */
+enum
+{
+    kLaneUrgent = 0,
+    kLaneNormal,
+    kLaneCount
+};
+
+/* The consumer-owned heads and the producer-contended tails are padded
+ * onto separate cache lines so that posting does not continually
+ * invalidate the line the consumer is reading from and vice versa.
+ *
+ * Slot i of a lane may be written by the producer that claims
+ * position p when mSequences[i] == 2p and may be read by the consumer
+ * once the producer publishes it as 2p + 1. Doubling the positions
+ * keeps a published slot distinguishable from a free one even when
+ * the lane holds only a single event.
+ *
+ * Producers waiting for space in a full queue sleep on mSpaceFutex
+ * and register in mSpaceWaiters, mirroring how the consumer waits for
+ * events on mFutex and mWaiters.
+ *
+ * Tasks blocked in nleventqueue_select() are comparatively rare and
+ * are tracked on mSelectors under mSelectLock, which producers only
+ * take when mSelectorCount shows there is a selector to wake.
+ * Watermark crossings are likewise rare and are confirmed and
+ * reported under mSelectLock, such that notifications are never
+ * reordered.
+ *
+ * Once requested, mPollableFd is an eventfd that is signaled while the
+ * queue is non-empty. Producers signal it when they find
+ * mPollableSignaled clear; the consumer clears it when it empties the
+ * queue, then rechecks for events posted in the meantime.
+ *
+ * Only the consumer may remove events, so producers cannot displace
+ * the oldest event or search the pending ones; of the overflow
+ * policies, only NLER_EVENTQUEUE_OVERFLOW_FAIL and
+ * NLER_EVENTQUEUE_OVERFLOW_DROP_NEWEST are supported. The policy,
+ * watermarks and drop handler are expected to be configured before
+ * the queue is in use.
+ *
+ * With statistics enabled, producers timestamp each slot in the
+ * lane's mPostTimes before publishing it. All other statistics are
+ * kept by the consumer, in its own cache line, except for posts,
+ * which are the lane tails, and rarely incremented rejections. The
+ * peak depth is that observed by the consumer as it gets events.
+ */
+typedef struct nleventqueue_lockfree_pthreads_selector_s
+{
+    struct nleventqueue_lockfree_pthreads_selector_s  *mNext;
+    nlfutex_t                                         *mFutex;
+} nleventqueue_lockfree_pthreads_selector_t;
+
+typedef struct nleventqueue_lockfree_pthreads_lane_s
+{
+    size_t           *mSequences;
+    nl_event_t      **mMemory;
+    size_t            mSize;
+#if NLER_EVENTQUEUE_STATS
+    uint32_t         *mPostTimes;
+#endif
+} nleventqueue_lockfree_pthreads_lane_t;
+
+typedef struct nleventqueue_lockfree_pthreads_s
+{
+    size_t            mHeads[kLaneCount];
+#if NLER_FEATURE_SIMULATEABLE_TIME
+    size_t            mPrevGetCount;
+#endif
+#if NLER_EVENTQUEUE_STATS
+    nleventqueue_stats_t mStats;
+#endif
+    uint8_t           mHeadPad[kCacheLineSize];
+    size_t            mTails[kLaneCount];
+    nlfutex_t         mSpaceFutex;
+    uint32_t          mSpaceWaiters;
+    uint8_t           mTailPad[kCacheLineSize];
+    nlfutex_t         mFutex;
+    uint32_t          mWaiters;
+    int               mPollableFd;
+    bool              mPollableSignaled;
+    uint32_t          mSelectorCount;
+    pthread_mutex_t   mSelectLock;
+    nleventqueue_lockfree_pthreads_selector_t *mSelectors;
+    nleventqueue_lockfree_pthreads_lane_t      mLanes[kLaneCount];
+    nleventqueue_overflow_policy_t             mOverflowPolicy;
+    uint32_t          mLowWatermark;
+    uint32_t          mHighWatermark;
+    bool              mAboveHighWatermark;
+    nleventqueue_watermark_handler_t           mWatermarkHandler;
+    void             *mWatermarkClosure;
+    nleventqueue_drop_handler_t                mDropHandler;
+    void             *mDropClosure;
+    size_t            mUrgentSequences[NLER_EVENTQUEUE_URGENT_DEPTH];
+    nl_event_t       *mUrgentMemory[NLER_EVENTQUEUE_URGENT_DEPTH];
+#if NLER_EVENTQUEUE_STATS
+    uint32_t          mUrgentPostTimes[NLER_EVENTQUEUE_URGENT_DEPTH];
+    uint32_t          mRejections;
+#endif
+} nleventqueue_lockfree_pthreads_t;
+
+static void nleventqueue_lockfree_pthreads_lane_init(nleventqueue_lockfree_pthreads_lane_t *aLane, size_t *aSequences, nl_event_t **aMemory, size_t aSize)
+{
+    size_t i;
+
+    for (i = 0; i < aSize; i++)
+    {
+        aSequences[i] = (i * 2);
+    }
+
+    aLane->mSequences = aSequences;
+    aLane->mMemory    = aMemory;
+    aLane->mSize      = aSize;
+}
+
+int nleventqueue_create(void *aQueueMemory, size_t aQueueMemorySize, nleventqueue_t *aOutQueue)
+{
+    const size_t                       lQueueSize = (aQueueMemorySize / sizeof (nl_event_t *));
+    nleventqueue_lockfree_pthreads_t  *lQueue = NULL;
+    size_t                            *lSequences;
+    int                                status;
+    int                                retval = NLER_SUCCESS;
+
+    if ((aQueueMemory == NULL) || (lQueueSize == 0) || (aOutQueue == NULL))
+    {
+        retval = NLER_ERROR_BAD_INPUT;
+        goto done;
+    }
+
+    lQueue = (nleventqueue_lockfree_pthreads_t *)calloc(1, sizeof (nleventqueue_lockfree_pthreads_t));
+    if (lQueue == NULL)
+    {
+        retval = NLER_ERROR_NO_MEMORY;
+        goto done;
+    }
+
+    lQueue->mPollableFd = -1;
+
+    status = pthread_mutex_init(&lQueue->mSelectLock, NULL);
+    if (status != 0)
+    {
+        retval = NLER_ERROR_FAILURE;
+        goto dealloc;
+    }
+
+#if NLER_EVENTQUEUE_STATS
+    lSequences = (size_t *)malloc(lQueueSize * (sizeof (size_t) + sizeof (uint32_t)));
+#else
+    lSequences = (size_t *)malloc(lQueueSize * sizeof (size_t));
+#endif
+    if (lSequences == NULL)
+    {
+        retval = NLER_ERROR_NO_MEMORY;
+        goto mutex_destroy;
+    }
+
+    nleventqueue_lockfree_pthreads_lane_init(&lQueue->mLanes[kLaneUrgent], lQueue->mUrgentSequences,
+                                             lQueue->mUrgentMemory, NLER_EVENTQUEUE_URGENT_DEPTH);
+    nleventqueue_lockfree_pthreads_lane_init(&lQueue->mLanes[kLaneNormal], lSequences,
+                                             (nl_event_t **)aQueueMemory, lQueueSize);
+
+#if NLER_EVENTQUEUE_STATS
+    lQueue->mLanes[kLaneUrgent].mPostTimes = lQueue->mUrgentPostTimes;
+    lQueue->mLanes[kLaneNormal].mPostTimes = (uint32_t *)&lSequences[lQueueSize];
+#endif
+
+    *aOutQueue = (nleventqueue_t)lQueue;
+
+    return (retval);
+
+ mutex_destroy:
+    pthread_mutex_destroy(&lQueue->mSelectLock);
+
+ dealloc:
+    free(lQueue);
+
+ done:
+    return (retval);
+}
+
+void nleventqueue_destroy(nleventqueue_t *aEventQueue)
+{
+    nleventqueue_lockfree_pthreads_t  *lEventQueue = *(nleventqueue_lockfree_pthreads_t **)aEventQueue;
+
+    if (lEventQueue != NULL)
+    {
+        pthread_mutex_destroy(&lEventQueue->mSelectLock);
+
+#if defined(__linux__)
+        if (lEventQueue->mPollableFd >= 0)
+        {
+            close(lEventQueue->mPollableFd);
+        }
+#endif
+
+        free(lEventQueue->mLanes[kLaneNormal].mSequences);
+
+        free(lEventQueue);
+    }
+}
+
+void nleventqueue_disable_event_counting(nleventqueue_t *aEventQueue)
+{
+    return;
+}
+
+/* Producers that have claimed, but not yet published, a slot are
+ * counted as pending.
+ */
+static size_t nleventqueue_lockfree_pthreads_count(const nleventqueue_lockfree_pthreads_t *aQueue)
+{
+    size_t  head;
+    size_t  tail;
+    size_t  i;
+    size_t  retval = 0;
+
+    for (i = 0; i < kLaneCount; i++)
+    {
+        head = __atomic_load_n(&aQueue->mHeads[i], __ATOMIC_RELAXED);
+        tail = __atomic_load_n(&aQueue->mTails[i], __ATOMIC_RELAXED);
+
+        if (tail > head)
+        {
+            retval += (tail - head);
+        }
+    }
+
+    return retval;
+}
+
+int nleventqueue_set_overflow_policy(nleventqueue_t *aEventQueue, nleventqueue_overflow_policy_t aPolicy)
+{
+    nleventqueue_lockfree_pthreads_t  *lEventQueue = *(nleventqueue_lockfree_pthreads_t **)aEventQueue;
+    int                                retval = NLER_SUCCESS;
+
+    if (aPolicy > NLER_EVENTQUEUE_OVERFLOW_CONFLATE)
+    {
+        retval = NLER_ERROR_BAD_INPUT;
+    }
+    else if ((aPolicy != NLER_EVENTQUEUE_OVERFLOW_FAIL) && (aPolicy != NLER_EVENTQUEUE_OVERFLOW_DROP_NEWEST))
+    {
+        retval = NLER_ERROR_NOT_IMPLEMENTED;
+    }
+    else
+    {
+        __atomic_store_n(&lEventQueue->mOverflowPolicy, aPolicy, __ATOMIC_RELAXED);
+    }
+
+    return retval;
+}
+
+int nleventqueue_set_watermarks(nleventqueue_t *aEventQueue, uint32_t aLowWatermark, uint32_t aHighWatermark, nleventqueue_watermark_handler_t aHandler, void *aClosure)
+{
+    nleventqueue_lockfree_pthreads_t  *lEventQueue = *(nleventqueue_lockfree_pthreads_t **)aEventQueue;
+    int                                retval = NLER_SUCCESS;
+
+    if ((aHandler != NULL) && (aLowWatermark >= aHighWatermark))
+    {
+        retval = NLER_ERROR_BAD_INPUT;
+        goto done;
+    }
+
+    pthread_mutex_lock(&lEventQueue->mSelectLock);
+
+    lEventQueue->mLowWatermark       = aLowWatermark;
+    lEventQueue->mHighWatermark      = aHighWatermark;
+    lEventQueue->mWatermarkHandler   = aHandler;
+    lEventQueue->mWatermarkClosure   = aClosure;
+    lEventQueue->mAboveHighWatermark = (nleventqueue_lockfree_pthreads_count(lEventQueue) >= aHighWatermark);
+
+    pthread_mutex_unlock(&lEventQueue->mSelectLock);
+
+ done:
+    return retval;
+}
+
+int nleventqueue_set_drop_handler(nleventqueue_t *aEventQueue, nleventqueue_drop_handler_t aHandler, void *aClosure)
+{
+    nleventqueue_lockfree_pthreads_t  *lEventQueue = *(nleventqueue_lockfree_pthreads_t **)aEventQueue;
+
+    lEventQueue->mDropHandler = aHandler;
+    lEventQueue->mDropClosure = aClosure;
+
+    return NLER_SUCCESS;
+}
+
+#if NLER_EVENTQUEUE_STATS
+static uint32_t nleventqueue_lockfree_pthreads_now_us(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint32_t)((now.tv_sec * 1000000) + (now.tv_nsec / 1000));
+}
+#endif
+
+int nleventqueue_get_stats(nleventqueue_t *aEventQueue, nleventqueue_stats_t *aOutStats)
+{
+#if NLER_EVENTQUEUE_STATS
+    nleventqueue_lockfree_pthreads_t  *lEventQueue = *(nleventqueue_lockfree_pthreads_t **)aEventQueue;
+    size_t                             i;
+
+    if (aOutStats == NULL)
+    {
+        return NLER_ERROR_BAD_INPUT;
+    }
+
+    *aOutStats = lEventQueue->mStats;
+
+    aOutStats->mPosts = 0;
+
+    for (i = 0; i < kLaneCount; i++)
+    {
+        aOutStats->mPosts += (uint32_t)__atomic_load_n(&lEventQueue->mTails[i], __ATOMIC_RELAXED);
+    }
+
+    aOutStats->mRejections = __atomic_load_n(&lEventQueue->mRejections, __ATOMIC_RELAXED);
+
+    return NLER_SUCCESS;
+#else
+    return NLER_ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+static void nleventqueue_lockfree_pthreads_signal_pollable(nleventqueue_lockfree_pthreads_t *aQueue)
+{
+#if defined(__linux__)
+    if (!__atomic_exchange_n(&aQueue->mPollableSignaled, true, __ATOMIC_SEQ_CST))
+    {
+        eventfd_write(aQueue->mPollableFd, 1);
+    }
+#endif
+}
+
+/* Called by the consumer once it has emptied the queue. Clearing the
+ * descriptor before the flag ensures that a producer which finds the
+ * flag clear signals after the clear, while one which finds it still
+ * set published an event this recheck will see.
+ */
+static void nleventqueue_lockfree_pthreads_clear_pollable(nleventqueue_lockfree_pthreads_t *aQueue)
+{
+#if defined(__linux__)
+    eventfd_t value;
+
+    if (__atomic_load_n(&aQueue->mPollableSignaled, __ATOMIC_RELAXED))
+    {
+        eventfd_read(aQueue->mPollableFd, &value);
+
+        __atomic_store_n(&aQueue->mPollableSignaled, false, __ATOMIC_SEQ_CST);
+
+        if (nleventqueue_lockfree_pthreads_count(aQueue) > 0)
+        {
+            nleventqueue_lockfree_pthreads_signal_pollable(aQueue);
+        }
+    }
+#endif
+}
+
+int nleventqueue_get_pollable_fd(nleventqueue_t *aEventQueue)
+{
+#if defined(__linux__)
+    nleventqueue_lockfree_pthreads_t  *lEventQueue = *(nleventqueue_lockfree_pthreads_t **)aEventQueue;
+    int                                fd;
+    int                                retval;
+
+    pthread_mutex_lock(&lEventQueue->mSelectLock);
+
+    if (lEventQueue->mPollableFd < 0)
+    {
+        fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+        if (fd >= 0)
+        {
+            /* Pairs with the fence in nleventqueue_lockfree_pthreads_post_event
+             * such that events posted before producers see the descriptor
+             * are signaled here.
+             */
+            __atomic_store_n(&lEventQueue->mPollableFd, fd, __ATOMIC_SEQ_CST);
+
+            if (nleventqueue_lockfree_pthreads_count(lEventQueue) > 0)
+            {
+                nleventqueue_lockfree_pthreads_signal_pollable(lEventQueue);
+            }
+        }
+    }
+
+    retval = ((lEventQueue->mPollableFd >= 0) ? lEventQueue->mPollableFd : NLER_ERROR_NO_RESOURCE);
+
+    pthread_mutex_unlock(&lEventQueue->mSelectLock);
+
+    return retval;
+#else
+    return NLER_ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+/* Report a watermark crossing, if the queue depth has just made one.
+ * The unlocked check keeps the common, uncongested case to a few
+ * loads; a candidate crossing is then confirmed under the lock.
+ */
+static void nleventqueue_lockfree_pthreads_check_watermarks(nleventqueue_lockfree_pthreads_t *aQueue)
+{
+    bool    above;
+    size_t  count;
+
+    if (aQueue->mWatermarkHandler == NULL)
+    {
+        return;
+    }
+
+    above = __atomic_load_n(&aQueue->mAboveHighWatermark, __ATOMIC_RELAXED);
+    count = nleventqueue_lockfree_pthreads_count(aQueue);
+
+    if ((!above && (count >= aQueue->mHighWatermark)) || (above && (count <= aQueue->mLowWatermark)))
+    {
+        pthread_mutex_lock(&aQueue->mSelectLock);
+
+        count = nleventqueue_lockfree_pthreads_count(aQueue);
+
+        if (!aQueue->mAboveHighWatermark && (count >= aQueue->mHighWatermark))
+        {
+            __atomic_store_n(&aQueue->mAboveHighWatermark, true, __ATOMIC_RELAXED);
+            aQueue->mWatermarkHandler(true, aQueue->mWatermarkClosure);
+        }
+        else if (aQueue->mAboveHighWatermark && (count <= aQueue->mLowWatermark))
+        {
+            __atomic_store_n(&aQueue->mAboveHighWatermark, false, __ATOMIC_RELAXED);
+            aQueue->mWatermarkHandler(false, aQueue->mWatermarkClosure);
+        }
+
+        pthread_mutex_unlock(&aQueue->mSelectLock);
+    }
+}
+
+static void nleventqueue_lockfree_pthreads_wake_selectors(nleventqueue_lockfree_pthreads_t *aQueue)
+{
+    nleventqueue_lockfree_pthreads_selector_t  *selector;
+
+    pthread_mutex_lock(&aQueue->mSelectLock);
+
+    for (selector = aQueue->mSelectors; selector != NULL; selector = selector->mNext)
+    {
+        __atomic_add_fetch(selector->mFutex, 1, __ATOMIC_RELEASE);
+
+        nlfutex_pthreads_wake(selector->mFutex, 1);
+    }
+
+    pthread_mutex_unlock(&aQueue->mSelectLock);
+}
+
+static bool nleventqueue_lockfree_pthreads_lane_put(nleventqueue_lockfree_pthreads_t *aQueue, size_t aLane, const nl_event_t *aEvent)
+{
+    nleventqueue_lockfree_pthreads_lane_t  *lane = &aQueue->mLanes[aLane];
+    size_t                                  position;
+    size_t                                  slot;
+    size_t                                  sequence;
+    intptr_t                                difference;
+
+    position = __atomic_load_n(&aQueue->mTails[aLane], __ATOMIC_RELAXED);
+
+    while (true)
+    {
+        slot       = position % lane->mSize;
+        sequence   = __atomic_load_n(&lane->mSequences[slot], __ATOMIC_ACQUIRE);
+        difference = (intptr_t)(sequence - (position * 2));
+
+        if (difference == 0)
+        {
+            if (__atomic_compare_exchange_n(&aQueue->mTails[aLane], &position, position + 1,
+                                            true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false;
+        }
+        else
+        {
+            position = __atomic_load_n(&aQueue->mTails[aLane], __ATOMIC_RELAXED);
+        }
+    }
+
+    lane->mMemory[slot] = (nl_event_t *)aEvent;
+
+#if NLER_EVENTQUEUE_STATS
+    lane->mPostTimes[slot] = nleventqueue_lockfree_pthreads_now_us();
+#endif
+
+    __atomic_store_n(&lane->mSequences[slot], (position * 2) + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+/* Let the consumer, selectors, pollable descriptor and watermark
+ * handler know of the events just published.
+ */
+static void nleventqueue_lockfree_pthreads_signal_posted(nleventqueue_lockfree_pthreads_t *aQueue)
+{
+    /* Pairs with the fence in nleventqueue_lockfree_pthreads_get_events
+     * such that either this task observes the registered waiter or the
+     * waiter observes the event just published.
+     */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&aQueue->mWaiters, __ATOMIC_RELAXED) > 0)
+    {
+        __atomic_add_fetch(&aQueue->mFutex, 1, __ATOMIC_RELEASE);
+
+        nlfutex_pthreads_wake(&aQueue->mFutex, 1);
+    }
+
+    if (__atomic_load_n(&aQueue->mSelectorCount, __ATOMIC_RELAXED) > 0)
+    {
+        nleventqueue_lockfree_pthreads_wake_selectors(aQueue);
+    }
+
+    if (__atomic_load_n(&aQueue->mPollableFd, __ATOMIC_RELAXED) >= 0)
+    {
+        nleventqueue_lockfree_pthreads_signal_pollable(aQueue);
+    }
+
+    nleventqueue_lockfree_pthreads_check_watermarks(aQueue);
+}
+
+static int nleventqueue_lockfree_pthreads_post_event(nleventqueue_t *aEventQueue, const nl_event_t *aEvent, size_t aLane, nl_time_native_t aTimeoutNative)
+{
+    int                                retval = NLER_SUCCESS;
+    nleventqueue_lockfree_pthreads_t  *lEventQueue = *(nleventqueue_lockfree_pthreads_t **)aEventQueue;
+    struct timespec                    deadline_storage;
+    const struct timespec             *deadline = NULL;
+    bool                               waiting = (aTimeoutNative != 0);
+    bool                               posted;
+    nlfutex_t                          futex;
+
+    if (waiting)
+    {
+        deadline = nlfutex_pthreads_deadline(aTimeoutNative, &deadline_storage);
+    }
+
+    posted = nleventqueue_lockfree_pthreads_lane_put(lEventQueue, aLane, aEvent);
+
+    while (!posted && waiting)
+    {
+        futex = __atomic_load_n(&lEventQueue->mSpaceFutex, __ATOMIC_ACQUIRE);
+
+        __atomic_add_fetch(&lEventQueue->mSpaceWaiters, 1, __ATOMIC_RELAXED);
+
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+        posted = nleventqueue_lockfree_pthreads_lane_put(lEventQueue, aLane, aEvent);
+
+        if (!posted)
+        {
+            waiting = nlfutex_pthreads_wait(&lEventQueue->mSpaceFutex, futex, deadline);
+
+            posted = nleventqueue_lockfree_pthreads_lane_put(lEventQueue, aLane, aEvent);
+        }
+
+        __atomic_sub_fetch(&lEventQueue->mSpaceWaiters, 1, __ATOMIC_RELAXED);
+    }
+
+    if (!posted)
+    {
+#if NLER_EVENTQUEUE_STATS
+        __atomic_add_fetch(&lEventQueue->mRejections, 1, __ATOMIC_RELAXED);
+#endif
+
+        if ((aLane == kLaneUrgent) ||
+            (__atomic_load_n(&lEventQueue->mOverflowPolicy, __ATOMIC_RELAXED) != NLER_EVENTQUEUE_OVERFLOW_DROP_NEWEST))
+        {
+            retval = NLER_ERROR_NO_RESOURCE;
+        }
+        else if (lEventQueue->mDropHandler != NULL)
+        {
+            lEventQueue->mDropHandler((nl_event_t *)aEvent, lEventQueue->mDropClosure);
+        }
+
+        goto done;
+    }
+
+    nleventqueue_lockfree_pthreads_signal_posted(lEventQueue);
+
+ done:
+    // a producer that asked to wait for space is being throttled
+    // rather than losing events, so only complain about those that
+    // did not.
+
+    if ((retval == NLER_ERROR_NO_RESOURCE) && (aTimeoutNative == 0))
+    {
+        NL_LOG_CRIT(lrERQUEUE, "attempt to post %sevent (%d) to full queue %p with size %d\n",
+                    ((aLane == kLaneUrgent) ? "urgent " : ""), aEvent->mType,
+                    lEventQueue->mLanes[kLaneNormal].mMemory, lEventQueue->mLanes[kLaneNormal].mSize);
+
+#if NLER_ASSERT_ON_FULL_QUEUE
+        NLER_ASSERT(0);
+#endif
+    }
+#if NLER_FEATURE_SIMULATEABLE_TIME
+    else if (posted)
+    {
+        nleventqueue_sim_count_inc();
+    }
+#endif
+
+    return retval;
+}
+
+int nleventqueue_post_event(nleventqueue_t *aEventQueue, const nl_event_t *aEvent)
+{
+    return nleventqueue_lockfree_pthreads_post_event(aEventQueue, aEvent, kLaneNormal, 0);
+}
+
+int nleventqueue_post_event_with_timeout(nleventqueue_t *aEventQueue, const nl_event_t *aEvent, nl_time_ms_t aTimeoutMS)
+{
+    return nleventqueue_lockfree_pthreads_post_event(aEventQueue, aEvent, kLaneNormal, nl_time_ms_to_delay_time_native(aTimeoutMS));
+}
+
+int nleventqueue_post_event_urgent(nleventqueue_t *aEventQueue, const nl_event_t *aEvent)
+{
+    return nleventqueue_lockfree_pthreads_post_event(aEventQueue, aEvent, kLaneUrgent, 0);
+}
+
+uint32_t nleventqueue_post_events(nleventqueue_t *aEventQueue, const nl_event_t * const *aEvents, uint32_t aCount)
+{
+    nleventqueue_lockfree_pthreads_t  *lEventQueue = *(nleventqueue_lockfree_pthreads_t **)aEventQueue;
+    bool                               signal = false;
+    uint32_t                           retval = 0;
+#if NLER_FEATURE_SIMULATEABLE_TIME
+    uint32_t                           posted_count = 0;
+#endif
+
+    if ((aEvents == NULL) || (aCount == 0))
+    {
+        goto done;
+    }
+
+    while (retval < aCount)
+    {
+        if (nleventqueue_lockfree_pthreads_lane_put(lEventQueue, kLaneNormal, aEvents[retval]))
+        {
+            signal = true;
+#if NLER_FEATURE_SIMULATEABLE_TIME
+            posted_count++;
+#endif
+        }
+        else
+        {
+#if NLER_EVENTQUEUE_STATS
+            __atomic_add_fetch(&lEventQueue->mRejections, 1, __ATOMIC_RELAXED);
+#endif
+
+            if (__atomic_load_n(&lEventQueue->mOverflowPolicy, __ATOMIC_RELAXED) != NLER_EVENTQUEUE_OVERFLOW_DROP_NEWEST)
+            {
+                break;
+            }
+
+            if (lEventQueue->mDropHandler != NULL)
+            {
+                lEventQueue->mDropHandler((nl_event_t *)aEvents[retval], lEventQueue->mDropClosure);
+            }
+        }
+
+        retval++;
+    }
+
+    // each event is published as it is put, so only the wakeup is
+    // deferred to the end of the batch.
+
+    if (signal)
+    {
+        nleventqueue_lockfree_pthreads_signal_posted(lEventQueue);
+    }
+
+    if (retval < aCount)
+    {
+        NL_LOG_CRIT(lrERQUEUE, "attempt to post %u events (%d first) to full queue %p with size %d\n",
+                    (unsigned)(aCount - retval), aEvents[retval]->mType,
+                    lEventQueue->mLanes[kLaneNormal].mMemory, lEventQueue->mLanes[kLaneNormal].mSize);
+
+#if NLER_ASSERT_ON_FULL_QUEUE
+        NLER_ASSERT(0);
+#endif
+    }
+
+#if NLER_FEATURE_SIMULATEABLE_TIME
+    while (posted_count-- > 0)
+    {
+        nleventqueue_sim_count_inc();
+    }
+#endif
+
+ done:
+    return retval;
+}
+
+static bool nleventqueue_lockfree_pthreads_lane_is_ready(nleventqueue_lockfree_pthreads_t *aQueue, size_t aLane)
+{
+    const nleventqueue_lockfree_pthreads_lane_t *lane = &aQueue->mLanes[aLane];
+    const size_t position = aQueue->mHeads[aLane];
+    const size_t slot = position % lane->mSize;
+
+    return (__atomic_load_n(&lane->mSequences[slot], __ATOMIC_ACQUIRE) == ((position * 2) + 1));
+}
+
+static bool nleventqueue_lockfree_pthreads_is_ready(nleventqueue_lockfree_pthreads_t *aQueue)
+{
+    return (nleventqueue_lockfree_pthreads_lane_is_ready(aQueue, kLaneUrgent) ||
+            nleventqueue_lockfree_pthreads_lane_is_ready(aQueue, kLaneNormal));
+}
+
+static nl_event_t *nleventqueue_lockfree_pthreads_lane_take(nleventqueue_lockfree_pthreads_t *aQueue, size_t aLane)
+{
+    nleventqueue_lockfree_pthreads_lane_t  *lane = &aQueue->mLanes[aLane];
+    const size_t                            position = aQueue->mHeads[aLane];
+    const size_t                            slot = position % lane->mSize;
+    nl_event_t                             *retval;
+
+    retval = lane->mMemory[slot];
+
+#if NLER_EVENTQUEUE_STATS
+    nleventqueue_stats_record_get(&aQueue->mStats, nleventqueue_lockfree_pthreads_now_us() - lane->mPostTimes[slot]);
+#endif
+
+    /* Hand the slot back to producers for the next lap around the
+     * lane.
+     */
+    __atomic_store_n(&lane->mSequences[slot], (position + lane->mSize) * 2, __ATOMIC_RELEASE);
+
+    __atomic_store_n(&aQueue->mHeads[aLane], position + 1, __ATOMIC_RELAXED);
+
+    return retval;
+}
+
+static nl_event_t *nleventqueue_lockfree_pthreads_remove_event(nleventqueue_lockfree_pthreads_t *aQueue)
+{
+    const size_t lane = (nleventqueue_lockfree_pthreads_lane_is_ready(aQueue, kLaneUrgent) ? kLaneUrgent : kLaneNormal);
+
+    return nleventqueue_lockfree_pthreads_lane_take(aQueue, lane);
+}
+
+static size_t nleventqueue_lockfree_pthreads_get_events(nleventqueue_lockfree_pthreads_t *aQueue, nl_event_t **aOutEvents, size_t aMaxEvents, nl_time_native_t aTimeoutNative)
+{
+    size_t                    retval = 0;
+    struct timespec           deadline_storage;
+    const struct timespec    *deadline = NULL;
+    bool                      waiting = (aTimeoutNative != 0);
+    nlfutex_t                 futex;
+#if NLER_EVENTQUEUE_STATS
+    size_t                    depth;
+#endif
+
+#if NLER_FEATURE_SIMULATEABLE_TIME
+    while (aQueue->mPrevGetCount > 0)
+    {
+        nleventqueue_sim_count_dec();
+        aQueue->mPrevGetCount--;
+    }
+#endif
+
+    if (waiting)
+    {
+        deadline = nlfutex_pthreads_deadline(aTimeoutNative, &deadline_storage);
+    }
+
+    while (!nleventqueue_lockfree_pthreads_is_ready(aQueue) && waiting)
+    {
+        futex = __atomic_load_n(&aQueue->mFutex, __ATOMIC_ACQUIRE);
+
+        __atomic_add_fetch(&aQueue->mWaiters, 1, __ATOMIC_RELAXED);
+
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+        if (!nleventqueue_lockfree_pthreads_is_ready(aQueue))
+        {
+            waiting = nlfutex_pthreads_wait(&aQueue->mFutex, futex, deadline);
+        }
+
+        __atomic_sub_fetch(&aQueue->mWaiters, 1, __ATOMIC_RELAXED);
+    }
+
+#if NLER_EVENTQUEUE_STATS
+    depth = nleventqueue_lockfree_pthreads_count(aQueue);
+
+    if (depth > aQueue->mStats.mPeakDepth)
+    {
+        aQueue->mStats.mPeakDepth = (uint32_t)depth;
+    }
+#endif
+
+    while ((retval < aMaxEvents) && nleventqueue_lockfree_pthreads_is_ready(aQueue))
+    {
+        aOutEvents[retval++] = nleventqueue_lockfree_pthreads_remove_event(aQueue);
+    }
+
+    if (retval > 0)
+    {
+        if ((__atomic_load_n(&aQueue->mPollableFd, __ATOMIC_RELAXED) >= 0) && !nleventqueue_lockfree_pthreads_is_ready(aQueue))
+        {
+            nleventqueue_lockfree_pthreads_clear_pollable(aQueue);
+        }
+
+        nleventqueue_lockfree_pthreads_check_watermarks(aQueue);
+
+        /* Pairs with the fence in nleventqueue_lockfree_pthreads_post_event
+         * such that either this task observes the waiting producer or
+         * the producer observes the space just freed.
+         */
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+        if (__atomic_load_n(&aQueue->mSpaceWaiters, __ATOMIC_RELAXED) > 0)
+        {
+            __atomic_add_fetch(&aQueue->mSpaceFutex, 1, __ATOMIC_RELEASE);
+
+            nlfutex_pthreads_wake(&aQueue->mSpaceFutex, (int)retval);
+        }
+    }
+
+#if NLER_FEATURE_SIMULATEABLE_TIME
+    aQueue->mPrevGetCount = retval;
+#endif
+
+    return retval;
+}
+
+/**
+ * NOTE: This function isn't intended for use by clients of NLER.
+ *
+ * This exists to let NLER functions get events from a queue without incurring a
+ * +1 tick offset when converting milliseconds to ticks.
+ */
+extern nl_event_t *nleventqueue_get_event_with_timeout_native(nleventqueue_t *aEventQueue, nl_time_native_t aTimeoutNative);
+
+nl_event_t *nleventqueue_get_event_with_timeout_native(nleventqueue_t *aEventQueue, nl_time_native_t aTimeoutNative)
+{
+    nl_event_t                        *retval = NULL;
+    nleventqueue_lockfree_pthreads_t  *lEventQueue = *(nleventqueue_lockfree_pthreads_t **)aEventQueue;
+
+    nleventqueue_lockfree_pthreads_get_events(lEventQueue, &retval, 1, aTimeoutNative);
+
+    return retval;
+}
+
+nl_event_t *nleventqueue_get_event_with_timeout(nleventqueue_t *aEventQueue, nl_time_ms_t aTimeoutMS)
+{
+    nl_event_t              *retval;
+
+    retval = nleventqueue_get_event_with_timeout_native(aEventQueue, aTimeoutMS);
+
+    return retval;
+}
+
+uint32_t nleventqueue_get_events(nleventqueue_t *aEventQueue, nl_event_t **aOutEvents, uint32_t aMaxEvents, nl_time_ms_t aTimeoutMS)
+{
+    nleventqueue_lockfree_pthreads_t  *lEventQueue = *(nleventqueue_lockfree_pthreads_t **)aEventQueue;
+    uint32_t                           retval = 0;
+
+    if ((aOutEvents != NULL) && (aMaxEvents > 0))
+    {
+        retval = nleventqueue_lockfree_pthreads_get_events(lEventQueue, aOutEvents, aMaxEvents, nl_time_ms_to_delay_time_native(aTimeoutMS));
+    }
+
+    return retval;
+}
+
+static void nleventqueue_lockfree_pthreads_add_selector(nleventqueue_lockfree_pthreads_t *aQueue, nleventqueue_lockfree_pthreads_selector_t *aSelector)
+{
+    pthread_mutex_lock(&aQueue->mSelectLock);
+
+    aSelector->mNext   = aQueue->mSelectors;
+    aQueue->mSelectors = aSelector;
+
+    __atomic_add_fetch(&aQueue->mSelectorCount, 1, __ATOMIC_RELAXED);
+
+    pthread_mutex_unlock(&aQueue->mSelectLock);
+
+    /* Pairs with the fence in nleventqueue_post_event as for
+     * mWaiters.
+     */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static void nleventqueue_lockfree_pthreads_remove_selector(nleventqueue_lockfree_pthreads_t *aQueue, nleventqueue_lockfree_pthreads_selector_t *aSelector)
+{
+    nleventqueue_lockfree_pthreads_selector_t **link;
+
+    pthread_mutex_lock(&aQueue->mSelectLock);
+
+    for (link = &aQueue->mSelectors; *link != NULL; link = &(*link)->mNext)
+    {
+        if (*link == aSelector)
+        {
+            *link = aSelector->mNext;
+            break;
+        }
+    }
+
+    __atomic_sub_fetch(&aQueue->mSelectorCount, 1, __ATOMIC_RELAXED);
+
+    pthread_mutex_unlock(&aQueue->mSelectLock);
+}
+
+int nleventqueue_select(nleventqueue_t **aEventQueues, size_t aQueueCount, nl_time_ms_t aTimeoutMS)
+{
+    nleventqueue_lockfree_pthreads_selector_t  selectors[NLER_EVENTQUEUE_SELECT_MAX];
+    nleventqueue_lockfree_pthreads_t          *lEventQueue;
+    nlfutex_t                                  futex = 0;
+    nlfutex_t                                  expected;
+    struct timespec                            deadline_storage;
+    const struct timespec                     *deadline = NULL;
+    bool                                       waiting = (aTimeoutMS != 0);
+    bool                                       last;
+    size_t                                     registered;
+    size_t                                     i;
+    int                                        retval;
+
+    if ((aEventQueues == NULL) || (aQueueCount == 0) || (aQueueCount > NLER_EVENTQUEUE_SELECT_MAX))
+    {
+        retval = NLER_ERROR_BAD_INPUT;
+        goto done;
+    }
+
+    if (waiting)
+    {
+        deadline = nlfutex_pthreads_deadline(nl_time_ms_to_delay_time_native(aTimeoutMS), &deadline_storage);
+    }
+
+    do
+    {
+        last       = !waiting;
+        expected   = __atomic_load_n(&futex, __ATOMIC_ACQUIRE);
+        registered = 0;
+        retval     = NLER_ERROR_NO_RESOURCE;
+
+        /* Queues earlier in the set take precedence when more than one
+         * has pending events.
+         */
+        for (i = 0; (i < aQueueCount) && (retval == NLER_ERROR_NO_RESOURCE); i++)
+        {
+            lEventQueue = *(nleventqueue_lockfree_pthreads_t **)aEventQueues[i];
+
+            if (waiting)
+            {
+                selectors[i].mFutex = &futex;
+                nleventqueue_lockfree_pthreads_add_selector(lEventQueue, &selectors[i]);
+                registered++;
+            }
+
+            if (nleventqueue_lockfree_pthreads_is_ready(lEventQueue))
+            {
+                retval = (int)i;
+            }
+        }
+
+        if ((retval == NLER_ERROR_NO_RESOURCE) && waiting)
+        {
+            waiting = nlfutex_pthreads_wait(&futex, expected, deadline);
+        }
+
+        for (i = 0; i < registered; i++)
+        {
+            nleventqueue_lockfree_pthreads_remove_selector(*(nleventqueue_lockfree_pthreads_t **)aEventQueues[i], &selectors[i]);
+        }
+    }
+    while ((retval == NLER_ERROR_NO_RESOURCE) && !last);
+
+ done:
+    return retval;
+}
+
+uint32_t nleventqueue_get_count(nleventqueue_t *aEventQueue)
+{
+    const nleventqueue_lockfree_pthreads_t  *lEventQueue = *(nleventqueue_lockfree_pthreads_t **)aEventQueue;
+
+    return (nleventqueue_lockfree_pthreads_count(lEventQueue));
+}
+
+#endif /* NLER_FEATURE_LOCK_FREE_QUEUE */
@@ -19,47 +19,109 @@
 /**
  *    @file
  *      This file implements NLER event queues under the POSIX threads
- *      (pthreads) build platform.
+ *      (pthreads) build platform when the NLER lock-free queue feature
+ *      has not been enabled.
  *
  */
 
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdlib.h>
-#include <string.h>
-#include <unistd.h>
+#include <time.h>
 
+#include <nlercfg.h>
 #include <nlereventqueue.h>
 #include <nlerlog.h>
 #include <nlererror.h>
 
 #include <pthread.h>
 
-#include <sys/select.h>
+#if defined(__linux__)
+#include <unistd.h>
+
+#include <sys/eventfd.h>
+#endif
+
+#include "nlfutex-pthreads.h"
 
 #if NLER_FEATURE_SIMULATEABLE_TIME
 #include "nlereventqueue_sim.h"
 #endif
 
-#define kPipeMagicOctet '\x38'
+#if NLER_EVENTQUEUE_STATS
+#include "nlereventqueue_stats.h"
+#endif
 
-enum
-{
-    kReadDescriptor  = 0,
-    kWriteDescriptor = 1,
+#if !NLER_FEATURE_LOCK_FREE_QUEUE
 
-    kMaxDescriptors
-};
+/* Consumers that find the queue empty register themselves in
+ * mWaiters and sleep on mFutex. Producers only bump and wake the
+ * futex when there is a registered waiter, so posting to a queue
+ * whose consumer is busy costs no system calls at all. Producers
+ * that find the queue full and are willing to wait do likewise with
+ * mSpaceWaiters and mSpaceFutex, which consumers wake as they remove
+ * events.
+ *
+ * The caller-supplied queue memory is used as a circular buffer of
+ * mQueueSize event pointers, mQueueCount of which, starting at
+ * mQueueHead, are pending. Urgent events are held apart, in a
+ * smaller circular buffer that is always drained first.
+ *
+ * When the queue is full, mOverflowPolicy decides the fate of a
+ * further event. mAboveHighWatermark records which watermark was
+ * crossed last so that each crossing is reported exactly once.
+ *
+ * With statistics enabled, mPostTimes and mUrgentPostTimes parallel
+ * the two circular buffers and hold the time each pending event was
+ * posted, from which its sojourn time is computed when it is removed.
+ *
+ * Once requested, mPollableFd is an eventfd that is signaled while the
+ * queue is non-empty, such that an external reactor may poll it.
+ * mPollableSignaled tracks its state so that it is only written and
+ * read as the queue changes between empty and non-empty.
+ *
+ * Tasks blocked in nleventqueue_select() link a selector onto
+ * mSelectors of each queue they wait on, such that a post to any of
+ * them wakes the one futex the selecting task sleeps on.
+ */
+typedef struct nleventqueue_pthreads_selector_s
+{
+    struct nleventqueue_pthreads_selector_s  *mNext;
+    nlfutex_t                                *mFutex;
+} nleventqueue_pthreads_selector_t;
 
 typedef struct nleventqueue_pthreads_s
 {
     pthread_mutex_t   mLock;
-    int               mPipe[kMaxDescriptors];
+    nlfutex_t         mFutex;
+    uint32_t          mWaiters;
+    nlfutex_t         mSpaceFutex;
+    uint32_t          mSpaceWaiters;
     nl_event_t      **mQueueMemory;
     size_t            mQueueSize;
-    size_t            mQueueEnd;
+    size_t            mQueueHead;
+    size_t            mQueueCount;
+    nl_event_t       *mUrgentMemory[NLER_EVENTQUEUE_URGENT_DEPTH];
+    size_t            mUrgentHead;
+    size_t            mUrgentCount;
+    nleventqueue_pthreads_selector_t *mSelectors;
+    nleventqueue_overflow_policy_t    mOverflowPolicy;
+    uint32_t          mLowWatermark;
+    uint32_t          mHighWatermark;
+    bool              mAboveHighWatermark;
+    nleventqueue_watermark_handler_t  mWatermarkHandler;
+    void             *mWatermarkClosure;
+    nleventqueue_drop_handler_t       mDropHandler;
+    void             *mDropClosure;
+    int               mPollableFd;
+    bool              mPollableSignaled;
+#if NLER_EVENTQUEUE_STATS
+    uint32_t         *mPostTimes;
+    uint32_t          mUrgentPostTimes[NLER_EVENTQUEUE_URGENT_DEPTH];
+    nleventqueue_stats_t mStats;
+#endif
 #if NLER_FEATURE_SIMULATEABLE_TIME
-    bool              mPrevGetSuccessful;
+    size_t            mPrevGetCount;
 #endif
 } nleventqueue_pthreads_t;
 
@@ -92,31 +154,39 @@ int nleventqueue_create(void *aQueueMemory, size_t aQueueMemorySize, nleventqueu
         goto mutexattr_destroy;
     }
 
-    status = pipe(lQueue->mPipe);
+    status = pthread_mutex_init(&lQueue->mLock, &mutexattr);
     if (status != 0)
     {
         retval = NLER_ERROR_FAILURE;
         goto dealloc;
     }
 
-    status = pthread_mutex_init(&lQueue->mLock, &mutexattr);
-    if (status != 0)
+#if NLER_EVENTQUEUE_STATS
+    lQueue->mPostTimes = (uint32_t *)malloc(lQueueSize * sizeof (uint32_t));
+    if (lQueue->mPostTimes == NULL)
     {
-        retval = NLER_ERROR_FAILURE;
-        goto close;
+        retval = NLER_ERROR_NO_MEMORY;
+        goto mutex_destroy;
     }
+#endif
 
     lQueue->mQueueMemory = (nl_event_t **)aQueueMemory;
     lQueue->mQueueSize   = lQueueSize;
-    lQueue->mQueueEnd    = 0;
+    lQueue->mQueueHead   = 0;
+    lQueue->mQueueCount  = 0;
+    lQueue->mOverflowPolicy = NLER_EVENTQUEUE_OVERFLOW_FAIL;
+    lQueue->mPollableFd  = -1;
+
+    pthread_mutexattr_destroy(&mutexattr);
 
     *aOutQueue = (nleventqueue_t)lQueue;
 
     return (retval);
 
- close:
-    close(lQueue->mPipe[kReadDescriptor]);
-    close(lQueue->mPipe[kWriteDescriptor]);
+#if NLER_EVENTQUEUE_STATS
+ mutex_destroy:
+    pthread_mutex_destroy(&lQueue->mLock);
+#endif
 
  dealloc:
     free(lQueue);
@@ -136,8 +206,16 @@ void nleventqueue_destroy(nleventqueue_t *aEventQueue)
     {
         pthread_mutex_destroy(&lEventQueue->mLock);
 
-        close(lEventQueue->mPipe[kReadDescriptor]);
-        close(lEventQueue->mPipe[kWriteDescriptor]);
+#if defined(__linux__)
+        if (lEventQueue->mPollableFd >= 0)
+        {
+            close(lEventQueue->mPollableFd);
+        }
+#endif
+
+#if NLER_EVENTQUEUE_STATS
+        free(lEventQueue->mPostTimes);
+#endif
 
         free(lEventQueue);
     }
@@ -148,12 +226,395 @@ void nleventqueue_disable_event_counting(nleventqueue_t *aEventQueue)
     return;
 }
 
-int nleventqueue_post_event(nleventqueue_t *aEventQueue, const nl_event_t *aEvent)
+static size_t nleventqueue_pthreads_count(const nleventqueue_pthreads_t *aQueue)
+{
+    return (aQueue->mUrgentCount + aQueue->mQueueCount);
+}
+
+int nleventqueue_set_overflow_policy(nleventqueue_t *aEventQueue, nleventqueue_overflow_policy_t aPolicy)
+{
+    nleventqueue_pthreads_t  *lEventQueue = *(nleventqueue_pthreads_t **)aEventQueue;
+    int                       retval = NLER_SUCCESS;
+
+    if (aPolicy > NLER_EVENTQUEUE_OVERFLOW_CONFLATE)
+    {
+        retval = NLER_ERROR_BAD_INPUT;
+        goto done;
+    }
+
+    pthread_mutex_lock(&lEventQueue->mLock);
+
+    lEventQueue->mOverflowPolicy = aPolicy;
+
+    pthread_mutex_unlock(&lEventQueue->mLock);
+
+ done:
+    return retval;
+}
+
+int nleventqueue_set_watermarks(nleventqueue_t *aEventQueue, uint32_t aLowWatermark, uint32_t aHighWatermark, nleventqueue_watermark_handler_t aHandler, void *aClosure)
+{
+    nleventqueue_pthreads_t  *lEventQueue = *(nleventqueue_pthreads_t **)aEventQueue;
+    int                       retval = NLER_SUCCESS;
+
+    if ((aHandler != NULL) && (aLowWatermark >= aHighWatermark))
+    {
+        retval = NLER_ERROR_BAD_INPUT;
+        goto done;
+    }
+
+    pthread_mutex_lock(&lEventQueue->mLock);
+
+    lEventQueue->mLowWatermark       = aLowWatermark;
+    lEventQueue->mHighWatermark      = aHighWatermark;
+    lEventQueue->mWatermarkHandler   = aHandler;
+    lEventQueue->mWatermarkClosure   = aClosure;
+    lEventQueue->mAboveHighWatermark = (nleventqueue_pthreads_count(lEventQueue) >= aHighWatermark);
+
+    pthread_mutex_unlock(&lEventQueue->mLock);
+
+ done:
+    return retval;
+}
+
+int nleventqueue_set_drop_handler(nleventqueue_t *aEventQueue, nleventqueue_drop_handler_t aHandler, void *aClosure)
+{
+    nleventqueue_pthreads_t  *lEventQueue = *(nleventqueue_pthreads_t **)aEventQueue;
+
+    pthread_mutex_lock(&lEventQueue->mLock);
+
+    lEventQueue->mDropHandler = aHandler;
+    lEventQueue->mDropClosure = aClosure;
+
+    pthread_mutex_unlock(&lEventQueue->mLock);
+
+    return NLER_SUCCESS;
+}
+
+#if NLER_EVENTQUEUE_STATS
+static uint32_t nleventqueue_pthreads_now_us(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint32_t)((now.tv_sec * 1000000) + (now.tv_nsec / 1000));
+}
+
+/* Timestamp and account for the event most recently put in a lane.
+ * Called with the queue lock held.
+ */
+static void nleventqueue_pthreads_stats_post(nleventqueue_pthreads_t *aQueue, bool aUrgent)
+{
+    size_t slot;
+
+    if (aUrgent)
+    {
+        slot = (aQueue->mUrgentHead + aQueue->mUrgentCount - 1) % NLER_EVENTQUEUE_URGENT_DEPTH;
+
+        aQueue->mUrgentPostTimes[slot] = nleventqueue_pthreads_now_us();
+    }
+    else
+    {
+        slot = (aQueue->mQueueHead + aQueue->mQueueCount - 1) % aQueue->mQueueSize;
+
+        aQueue->mPostTimes[slot] = nleventqueue_pthreads_now_us();
+    }
+
+    nleventqueue_stats_record_post(&aQueue->mStats, nleventqueue_pthreads_count(aQueue));
+}
+#endif
+
+int nleventqueue_get_stats(nleventqueue_t *aEventQueue, nleventqueue_stats_t *aOutStats)
+{
+#if NLER_EVENTQUEUE_STATS
+    nleventqueue_pthreads_t  *lEventQueue = *(nleventqueue_pthreads_t **)aEventQueue;
+
+    if (aOutStats == NULL)
+    {
+        return NLER_ERROR_BAD_INPUT;
+    }
+
+    pthread_mutex_lock(&lEventQueue->mLock);
+
+    *aOutStats = lEventQueue->mStats;
+
+    pthread_mutex_unlock(&lEventQueue->mLock);
+
+    return NLER_SUCCESS;
+#else
+    return NLER_ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+/* Make the pollable descriptor, if any, readable or not to match
+ * whether the queue has events. Called with the queue lock held.
+ */
+static void nleventqueue_pthreads_update_pollable(nleventqueue_pthreads_t *aQueue)
+{
+#if defined(__linux__)
+    const bool  pending = (nleventqueue_pthreads_count(aQueue) > 0);
+    eventfd_t   value;
+
+    if ((aQueue->mPollableFd < 0) || (aQueue->mPollableSignaled == pending))
+    {
+        return;
+    }
+
+    if (pending)
+    {
+        eventfd_write(aQueue->mPollableFd, 1);
+    }
+    else
+    {
+        eventfd_read(aQueue->mPollableFd, &value);
+    }
+
+    aQueue->mPollableSignaled = pending;
+#endif
+}
+
+int nleventqueue_get_pollable_fd(nleventqueue_t *aEventQueue)
+{
+#if defined(__linux__)
+    nleventqueue_pthreads_t  *lEventQueue = *(nleventqueue_pthreads_t **)aEventQueue;
+    int                       retval;
+
+    pthread_mutex_lock(&lEventQueue->mLock);
+
+    if (lEventQueue->mPollableFd < 0)
+    {
+        lEventQueue->mPollableFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+        nleventqueue_pthreads_update_pollable(lEventQueue);
+    }
+
+    retval = ((lEventQueue->mPollableFd >= 0) ? lEventQueue->mPollableFd : NLER_ERROR_NO_RESOURCE);
+
+    pthread_mutex_unlock(&lEventQueue->mLock);
+
+    return retval;
+#else
+    return NLER_ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+/* Report a watermark crossing, if the queue depth has just made one.
+ * Called with the queue lock held.
+ */
+static void nleventqueue_pthreads_check_watermarks(nleventqueue_pthreads_t *aQueue)
+{
+    const size_t count = nleventqueue_pthreads_count(aQueue);
+
+    if (aQueue->mWatermarkHandler == NULL)
+    {
+        return;
+    }
+
+    if (!aQueue->mAboveHighWatermark && (count >= aQueue->mHighWatermark))
+    {
+        aQueue->mAboveHighWatermark = true;
+        aQueue->mWatermarkHandler(true, aQueue->mWatermarkClosure);
+    }
+    else if (aQueue->mAboveHighWatermark && (count <= aQueue->mLowWatermark))
+    {
+        aQueue->mAboveHighWatermark = false;
+        aQueue->mWatermarkHandler(false, aQueue->mWatermarkClosure);
+    }
+}
+
+static bool nleventqueue_pthreads_is_pending(const nleventqueue_pthreads_t *aQueue, const nl_event_t *aEvent)
+{
+    size_t  index = aQueue->mQueueHead;
+    size_t  i;
+
+    for (i = 0; i < aQueue->mQueueCount; i++)
+    {
+        if (aQueue->mQueueMemory[index] == aEvent)
+        {
+            return true;
+        }
+
+        index++;
+
+        if (index == aQueue->mQueueSize)
+        {
+            index = 0;
+        }
+    }
+
+    return false;
+}
+
+/* Selectors live on the stacks of the selecting tasks and may only
+ * be touched with the queue lock held.
+ */
+static void nleventqueue_pthreads_wake_selectors(nleventqueue_pthreads_t *aQueue)
+{
+    nleventqueue_pthreads_selector_t  *selector;
+
+    for (selector = aQueue->mSelectors; selector != NULL; selector = selector->mNext)
+    {
+        __atomic_add_fetch(selector->mFutex, 1, __ATOMIC_RELEASE);
+
+        nlfutex_pthreads_wake(selector->mFutex, 1);
+    }
+}
+
+static void nleventqueue_pthreads_ring_put(nl_event_t **aMemory, size_t aSize, size_t aHead, size_t *aCount, const nl_event_t *aEvent)
+{
+    size_t tail = aHead + *aCount;
+
+    if (tail >= aSize)
+    {
+        tail -= aSize;
+    }
+
+    aMemory[tail] = (nl_event_t *)aEvent;
+
+    (*aCount)++;
+}
+
+static nl_event_t *nleventqueue_pthreads_ring_take(nl_event_t **aMemory, size_t aSize, size_t *aHead, size_t *aCount)
+{
+    nl_event_t  *retval;
+
+    retval = aMemory[*aHead];
+
+    (*aHead)++;
+
+    if (*aHead == aSize)
+    {
+        *aHead = 0;
+    }
+
+    (*aCount)--;
+
+    return retval;
+}
+
+/* Hand an event discarded by the overflow policy to whoever owns it.
+ * Called with the queue lock held.
+ */
+static void nleventqueue_pthreads_drop_event(nleventqueue_pthreads_t *aQueue, const nl_event_t *aEvent)
+{
+    if (aQueue->mDropHandler != NULL)
+    {
+        aQueue->mDropHandler((nl_event_t *)aEvent, aQueue->mDropClosure);
+    }
+}
+
+/* Put one event in its lane, or dispose of it as the overflow policy
+ * dictates. Called with the queue lock held. A producer that may yet
+ * wait for space passes aMayWait, and is told NLER_ERROR_NO_RESOURCE
+ * rather than have the policy applied if the queue is full.
+ */
+static int nleventqueue_pthreads_put_event(nleventqueue_pthreads_t *aQueue, const nl_event_t *aEvent, bool aUrgent, bool aMayWait, bool *aOutQueued)
+{
+    int          retval = NLER_SUCCESS;
+    bool         queued = false;
+    nl_event_t  *displaced;
+
+    if (!aUrgent && (aQueue->mOverflowPolicy == NLER_EVENTQUEUE_OVERFLOW_CONFLATE) &&
+        nleventqueue_pthreads_is_pending(aQueue, aEvent))
+    {
+        goto done;
+    }
+
+    if (!aUrgent && aMayWait && (aQueue->mQueueCount == aQueue->mQueueSize))
+    {
+        retval = NLER_ERROR_NO_RESOURCE;
+        goto done;
+    }
+
+    if (aUrgent && (aQueue->mUrgentCount < NLER_EVENTQUEUE_URGENT_DEPTH))
+    {
+        nleventqueue_pthreads_ring_put(aQueue->mUrgentMemory, NLER_EVENTQUEUE_URGENT_DEPTH,
+                                       aQueue->mUrgentHead, &aQueue->mUrgentCount, aEvent);
+        queued = true;
+    }
+    else if (!aUrgent && (aQueue->mQueueCount < aQueue->mQueueSize))
+    {
+        nleventqueue_pthreads_ring_put(aQueue->mQueueMemory, aQueue->mQueueSize,
+                                       aQueue->mQueueHead, &aQueue->mQueueCount, aEvent);
+        queued = true;
+    }
+    else if (!aUrgent && (aQueue->mOverflowPolicy == NLER_EVENTQUEUE_OVERFLOW_DROP_OLDEST))
+    {
+        // the depth is unchanged and any waiting consumer has already
+        // been woken for the event being displaced.
+
+        displaced = nleventqueue_pthreads_ring_take(aQueue->mQueueMemory, aQueue->mQueueSize,
+                                                    &aQueue->mQueueHead, &aQueue->mQueueCount);
+        nleventqueue_pthreads_ring_put(aQueue->mQueueMemory, aQueue->mQueueSize,
+                                       aQueue->mQueueHead, &aQueue->mQueueCount, aEvent);
+
+#if NLER_EVENTQUEUE_STATS
+        nleventqueue_pthreads_stats_post(aQueue, false);
+#endif
+
+        nleventqueue_pthreads_drop_event(aQueue, displaced);
+    }
+    else if (aUrgent || (aQueue->mOverflowPolicy != NLER_EVENTQUEUE_OVERFLOW_DROP_NEWEST))
+    {
+        retval = NLER_ERROR_NO_RESOURCE;
+    }
+    else
+    {
+        nleventqueue_pthreads_drop_event(aQueue, aEvent);
+    }
+
+#if NLER_EVENTQUEUE_STATS
+    if (queued)
+    {
+        nleventqueue_pthreads_stats_post(aQueue, aUrgent);
+    }
+    else
+    {
+        aQueue->mStats.mRejections++;
+    }
+#endif
+
+ done:
+    *aOutQueued = queued;
+
+    return retval;
+}
+
+/* Let the consumer, selectors, pollable descriptor and watermark
+ * handler know of the events just queued. Called with the queue lock
+ * held; returns whether the futex must be woken once it is released.
+ */
+static bool nleventqueue_pthreads_signal_posted(nleventqueue_pthreads_t *aQueue)
+{
+    bool wake = false;
+
+    if (aQueue->mWaiters > 0)
+    {
+        __atomic_add_fetch(&aQueue->mFutex, 1, __ATOMIC_RELEASE);
+        wake = true;
+    }
+
+    nleventqueue_pthreads_wake_selectors(aQueue);
+
+    nleventqueue_pthreads_update_pollable(aQueue);
+
+    nleventqueue_pthreads_check_watermarks(aQueue);
+
+    return wake;
+}
+
+static int nleventqueue_pthreads_post_event(nleventqueue_t *aEventQueue, const nl_event_t *aEvent, bool aUrgent, nl_time_native_t aTimeoutNative)
 {
-    static const uint8_t      magic[1] = { kPipeMagicOctet };
     int                       status;
     int                       retval = NLER_SUCCESS;
+    bool                      wake = false;
+    bool                      queued = false;
     nleventqueue_pthreads_t  *lEventQueue = *(nleventqueue_pthreads_t **)aEventQueue;
+    struct timespec           deadline_storage;
+    const struct timespec    *deadline = NULL;
+    bool                      waiting = (aTimeoutNative != 0);
+    nlfutex_t                 futex;
 
     status = pthread_mutex_lock(&lEventQueue->mLock);
     if (status != 0)
@@ -162,25 +623,35 @@ int nleventqueue_post_event(nleventqueue_t *aEventQueue, const nl_event_t *aEven
         goto done;
     }
 
-    if (lEventQueue->mQueueEnd < lEventQueue->mQueueSize)
+    if (waiting)
     {
-        lEventQueue->mQueueMemory[lEventQueue->mQueueEnd] = (nl_event_t *)aEvent;
-        lEventQueue->mQueueEnd++;
+        deadline = nlfutex_pthreads_deadline(aTimeoutNative, &deadline_storage);
+    }
 
-        status = write(lEventQueue->mPipe[kWriteDescriptor], &magic[0], sizeof (magic));
-        if (status != sizeof (magic))
-        {
-            retval = NLER_ERROR_FAILURE;
-            goto unlock;
-        }
+    // wait for space for as long as the event is neither queued nor
+    // conflated, then put it in or apply the policy once done waiting.
+
+    while (((retval = nleventqueue_pthreads_put_event(lEventQueue, aEvent, aUrgent, waiting, &queued)) == NLER_ERROR_NO_RESOURCE) &&
+           !aUrgent && waiting)
+    {
+        futex = __atomic_load_n(&lEventQueue->mSpaceFutex, __ATOMIC_ACQUIRE);
+
+        lEventQueue->mSpaceWaiters++;
+
+        pthread_mutex_unlock(&lEventQueue->mLock);
+
+        waiting = nlfutex_pthreads_wait(&lEventQueue->mSpaceFutex, futex, deadline);
+
+        pthread_mutex_lock(&lEventQueue->mLock);
+
+        lEventQueue->mSpaceWaiters--;
     }
-    else
+
+    if (queued)
     {
-        retval = NLER_ERROR_NO_RESOURCE;
-        goto unlock;
+        wake = nleventqueue_pthreads_signal_posted(lEventQueue);
     }
 
- unlock:
     status = pthread_mutex_unlock(&lEventQueue->mLock);
     if (status != 0)
     {
@@ -188,21 +659,119 @@ int nleventqueue_post_event(nleventqueue_t *aEventQueue, const nl_event_t *aEven
         goto done;
     }
 
-    if (retval == NLER_ERROR_NO_RESOURCE)
+    if (wake)
+    {
+        nlfutex_pthreads_wake(&lEventQueue->mFutex, 1);
+    }
+
+    // a producer that asked to wait for space is being throttled
+    // rather than losing events, so only complain about those that
+    // did not.
+
+    if ((retval == NLER_ERROR_NO_RESOURCE) && (aTimeoutNative == 0))
     {
         //don't log while holding the lock
 
-        NL_LOG_CRIT(lrERQUEUE, "attempt to post event (%d) to full queue %p with size %d\n",
-                    aEvent->mType, lEventQueue->mQueueMemory, lEventQueue->mQueueSize);
+        NL_LOG_CRIT(lrERQUEUE, "attempt to post %sevent (%d) to full queue %p with size %d\n",
+                    (aUrgent ? "urgent " : ""), aEvent->mType, lEventQueue->mQueueMemory, lEventQueue->mQueueSize);
 
 #if NLER_ASSERT_ON_FULL_QUEUE
         NLER_ASSERT(0);
 #endif
     }
 #if NLER_FEATURE_SIMULATEABLE_TIME
-    else
+    else if (queued)
     {
-        nl_eventqueue_sim_count_inc();
+        nleventqueue_sim_count_inc();
+    }
+#endif
+
+ done:
+    return retval;
+}
+
+int nleventqueue_post_event(nleventqueue_t *aEventQueue, const nl_event_t *aEvent)
+{
+    return nleventqueue_pthreads_post_event(aEventQueue, aEvent, false, 0);
+}
+
+int nleventqueue_post_event_with_timeout(nleventqueue_t *aEventQueue, const nl_event_t *aEvent, nl_time_ms_t aTimeoutMS)
+{
+    return nleventqueue_pthreads_post_event(aEventQueue, aEvent, false, nl_time_ms_to_delay_time_native(aTimeoutMS));
+}
+
+int nleventqueue_post_event_urgent(nleventqueue_t *aEventQueue, const nl_event_t *aEvent)
+{
+    return nleventqueue_pthreads_post_event(aEventQueue, aEvent, true, 0);
+}
+
+uint32_t nleventqueue_post_events(nleventqueue_t *aEventQueue, const nl_event_t * const *aEvents, uint32_t aCount)
+{
+    nleventqueue_pthreads_t  *lEventQueue = *(nleventqueue_pthreads_t **)aEventQueue;
+    bool                      wake = false;
+    bool                      queued;
+    bool                      signal = false;
+    uint32_t                  retval = 0;
+#if NLER_FEATURE_SIMULATEABLE_TIME
+    uint32_t                  queued_count = 0;
+#endif
+
+    if ((aEvents == NULL) || (aCount == 0))
+    {
+        goto done;
+    }
+
+    if (pthread_mutex_lock(&lEventQueue->mLock) != 0)
+    {
+        goto done;
+    }
+
+    while (retval < aCount)
+    {
+        if (nleventqueue_pthreads_put_event(lEventQueue, aEvents[retval], false, false, &queued) != NLER_SUCCESS)
+        {
+            break;
+        }
+
+        if (queued)
+        {
+            signal = true;
+#if NLER_FEATURE_SIMULATEABLE_TIME
+            queued_count++;
+#endif
+        }
+
+        retval++;
+    }
+
+    if (signal)
+    {
+        wake = nleventqueue_pthreads_signal_posted(lEventQueue);
+    }
+
+    pthread_mutex_unlock(&lEventQueue->mLock);
+
+    if (wake)
+    {
+        nlfutex_pthreads_wake(&lEventQueue->mFutex, 1);
+    }
+
+    if (retval < aCount)
+    {
+        //don't log while holding the lock
+
+        NL_LOG_CRIT(lrERQUEUE, "attempt to post %u events (%d first) to full queue %p with size %d\n",
+                    (unsigned)(aCount - retval), aEvents[retval]->mType, lEventQueue->mQueueMemory, lEventQueue->mQueueSize);
+
+#if NLER_ASSERT_ON_FULL_QUEUE
+        NLER_ASSERT(0);
+#endif
+    }
+
+#if NLER_FEATURE_SIMULATEABLE_TIME
+    while (queued_count-- > 0)
+    {
+        nleventqueue_sim_count_inc();
     }
 #endif
 
@@ -214,113 +783,129 @@ static nl_event_t *nleventqueue_pthreads_remove_event(nleventqueue_pthreads_t *a
 {
     nl_event_t  *retval;
 
-    retval = aQueue->mQueueMemory[0];
-
-    aQueue->mQueueEnd--;
+    if (aQueue->mUrgentCount > 0)
+    {
+#if NLER_EVENTQUEUE_STATS
+        nleventqueue_stats_record_get(&aQueue->mStats,
+                                      nleventqueue_pthreads_now_us() - aQueue->mUrgentPostTimes[aQueue->mUrgentHead]);
+#endif
 
-    if (aQueue->mQueueEnd > 0)
+        retval = nleventqueue_pthreads_ring_take(aQueue->mUrgentMemory, NLER_EVENTQUEUE_URGENT_DEPTH,
+                                                 &aQueue->mUrgentHead, &aQueue->mUrgentCount);
+    }
+    else
     {
-        memmove(aQueue->mQueueMemory, &aQueue->mQueueMemory[1], aQueue->mQueueEnd * sizeof(nl_event_t *));
+#if NLER_EVENTQUEUE_STATS
+        nleventqueue_stats_record_get(&aQueue->mStats,
+                                      nleventqueue_pthreads_now_us() - aQueue->mPostTimes[aQueue->mQueueHead]);
+#endif
+
+        retval = nleventqueue_pthreads_ring_take(aQueue->mQueueMemory, aQueue->mQueueSize,
+                                                 &aQueue->mQueueHead, &aQueue->mQueueCount);
     }
 
     return retval;
 }
 
-/**
- * NOTE: This function isn't intended for use by clients of NLER.
- *
- * This exists to let NLER functions get events from a queue without incurring a
- * +1 tick offset when converting milliseconds to ticks.
+/* Wait, with the queue lock held, for up to aTimeoutNative for the
+ * queue to become non-empty and then remove up to aMaxEvents events
+ * into aOutEvents without dropping the lock in between.
  */
-extern nl_event_t *nleventqueue_get_event_with_timeout_native(nleventqueue_t *aEventQueue, nl_time_native_t aTimeoutNative);
-
-nl_event_t *nleventqueue_get_event_with_timeout_native(nleventqueue_t *aEventQueue, nl_time_native_t aTimeoutNative)
+static size_t nleventqueue_pthreads_get_events(nleventqueue_pthreads_t *aQueue, nl_event_t **aOutEvents, size_t aMaxEvents, nl_time_native_t aTimeoutNative)
 {
     int                       status;
-    nl_event_t               *retval = NULL;
-    nleventqueue_pthreads_t  *lEventQueue = *(nleventqueue_pthreads_t **)aEventQueue;
-
-    status = pthread_mutex_lock(&lEventQueue->mLock);
+    size_t                    retval = 0;
+    struct timespec           deadline_storage;
+    const struct timespec    *deadline = NULL;
+    bool                      waiting = (aTimeoutNative != 0);
+    bool                      wake = false;
+    nlfutex_t                 futex;
+
+    status = pthread_mutex_lock(&aQueue->mLock);
     if (status != 0)
     {
-        retval = NULL;
         goto done;
     }
 
 #if NLER_FEATURE_SIMULATEABLE_TIME
-    if (lEventQueue->mPrevGetSuccessful == true)
+    while (aQueue->mPrevGetCount > 0)
     {
-        nl_eventqueue_sim_count_dec();
+        nleventqueue_sim_count_dec();
+        aQueue->mPrevGetCount--;
     }
 #endif
 
-    if (lEventQueue->mQueueEnd > 0)
+    if (waiting)
     {
-        retval = nleventqueue_pthreads_remove_event(lEventQueue);
+        /* Establish the deadline once, up front, so that spurious or
+         * contended wakeups never extend the overall timeout.
+         */
+        deadline = nlfutex_pthreads_deadline(aTimeoutNative, &deadline_storage);
     }
 
-    pthread_mutex_unlock(&lEventQueue->mLock);
-
-    while (retval == NULL)
+    while ((nleventqueue_pthreads_count(aQueue) == 0) && waiting)
     {
-        int             nfds;
-        fd_set          rds, wds, xds;
-        struct timeval  timeout;
+        futex = __atomic_load_n(&aQueue->mFutex, __ATOMIC_ACQUIRE);
 
-        FD_ZERO(&rds);
-        FD_ZERO(&wds);
-        FD_ZERO(&xds);
+        aQueue->mWaiters++;
 
-        FD_SET(lEventQueue->mPipe[kReadDescriptor], &rds);
+        pthread_mutex_unlock(&aQueue->mLock);
 
-        nfds = lEventQueue->mPipe[kReadDescriptor] + 1;
+        waiting = nlfutex_pthreads_wait(&aQueue->mFutex, futex, deadline);
 
-        timeout.tv_sec  = aTimeoutNative / 1000;
-        timeout.tv_usec = (aTimeoutNative % 1000) * 1000;
+        pthread_mutex_lock(&aQueue->mLock);
 
-        status = select(nfds, &rds, &wds, &xds, &timeout);
+        aQueue->mWaiters--;
+    }
 
-        if (status == 1)
-        {
-            char buf[1];
+    while ((retval < aMaxEvents) && (nleventqueue_pthreads_count(aQueue) > 0))
+    {
+        aOutEvents[retval++] = nleventqueue_pthreads_remove_event(aQueue);
+    }
 
-            status = read(lEventQueue->mPipe[kReadDescriptor], &buf, sizeof (buf));
-            if (status == -1)
-            {
-                retval = NULL;
-                goto done;
-            }
-            else if (status == 1 && buf[0] != kPipeMagicOctet)
-            {
-                retval = NULL;
-                goto done;
-            }
+    if (retval > 0)
+    {
+        nleventqueue_pthreads_update_pollable(aQueue);
 
-            status = pthread_mutex_lock(&lEventQueue->mLock);
-            if (status != 0)
-            {
-                retval = NULL;
-                goto done;
-            }
+        nleventqueue_pthreads_check_watermarks(aQueue);
+    }
 
-            if (lEventQueue->mQueueEnd > 0)
-            {
-                retval = nleventqueue_pthreads_remove_event(lEventQueue);
-            }
-            
-            pthread_mutex_unlock(&lEventQueue->mLock);
-        }
-        else
-        {
-            break;
-        }
+    if ((retval > 0) && (aQueue->mSpaceWaiters > 0))
+    {
+        __atomic_add_fetch(&aQueue->mSpaceFutex, 1, __ATOMIC_RELEASE);
+        wake = true;
     }
 
- done:
 #if NLER_FEATURE_SIMULATEABLE_TIME
-    lEventQueue->mPrevGetSuccessful = ((retval != NULL) ? true : false);
+    aQueue->mPrevGetCount = retval;
 #endif
 
+    pthread_mutex_unlock(&aQueue->mLock);
+
+    if (wake)
+    {
+        nlfutex_pthreads_wake(&aQueue->mSpaceFutex, (int)retval);
+    }
+
+ done:
+    return retval;
+}
+
+/**
+ * NOTE: This function isn't intended for use by clients of NLER.
+ *
+ * This exists to let NLER functions get events from a queue without incurring a
+ * +1 tick offset when converting milliseconds to ticks.
+ */
+extern nl_event_t *nleventqueue_get_event_with_timeout_native(nleventqueue_t *aEventQueue, nl_time_native_t aTimeoutNative);
+
+nl_event_t *nleventqueue_get_event_with_timeout_native(nleventqueue_t *aEventQueue, nl_time_native_t aTimeoutNative)
+{
+    nl_event_t               *retval = NULL;
+    nleventqueue_pthreads_t  *lEventQueue = *(nleventqueue_pthreads_t **)aEventQueue;
+
+    nleventqueue_pthreads_get_events(lEventQueue, &retval, 1, aTimeoutNative);
+
     return retval;
 }
 
@@ -333,9 +918,114 @@ nl_event_t *nleventqueue_get_event_with_timeout(nleventqueue_t *aEventQueue, nl_
     return retval;
 }
 
+uint32_t nleventqueue_get_events(nleventqueue_t *aEventQueue, nl_event_t **aOutEvents, uint32_t aMaxEvents, nl_time_ms_t aTimeoutMS)
+{
+    nleventqueue_pthreads_t  *lEventQueue = *(nleventqueue_pthreads_t **)aEventQueue;
+    uint32_t                  retval = 0;
+
+    if ((aOutEvents != NULL) && (aMaxEvents > 0))
+    {
+        retval = nleventqueue_pthreads_get_events(lEventQueue, aOutEvents, aMaxEvents, nl_time_ms_to_delay_time_native(aTimeoutMS));
+    }
+
+    return retval;
+}
+
+static void nleventqueue_pthreads_remove_selector(nleventqueue_pthreads_t *aQueue, nleventqueue_pthreads_selector_t *aSelector)
+{
+    nleventqueue_pthreads_selector_t **link;
+
+    pthread_mutex_lock(&aQueue->mLock);
+
+    for (link = &aQueue->mSelectors; *link != NULL; link = &(*link)->mNext)
+    {
+        if (*link == aSelector)
+        {
+            *link = aSelector->mNext;
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&aQueue->mLock);
+}
+
+int nleventqueue_select(nleventqueue_t **aEventQueues, size_t aQueueCount, nl_time_ms_t aTimeoutMS)
+{
+    nleventqueue_pthreads_selector_t  selectors[NLER_EVENTQUEUE_SELECT_MAX];
+    nleventqueue_pthreads_t          *lEventQueue;
+    nlfutex_t                         futex = 0;
+    nlfutex_t                         expected;
+    struct timespec                   deadline_storage;
+    const struct timespec            *deadline = NULL;
+    bool                              waiting = (aTimeoutMS != 0);
+    bool                              last;
+    size_t                            registered;
+    size_t                            i;
+    int                               retval;
+
+    if ((aEventQueues == NULL) || (aQueueCount == 0) || (aQueueCount > NLER_EVENTQUEUE_SELECT_MAX))
+    {
+        retval = NLER_ERROR_BAD_INPUT;
+        goto done;
+    }
+
+    if (waiting)
+    {
+        deadline = nlfutex_pthreads_deadline(nl_time_ms_to_delay_time_native(aTimeoutMS), &deadline_storage);
+    }
+
+    do
+    {
+        last       = !waiting;
+        expected   = __atomic_load_n(&futex, __ATOMIC_ACQUIRE);
+        registered = 0;
+        retval     = NLER_ERROR_NO_RESOURCE;
+
+        /* Queues earlier in the set take precedence when more than one
+         * has pending events.
+         */
+        for (i = 0; (i < aQueueCount) && (retval == NLER_ERROR_NO_RESOURCE); i++)
+        {
+            lEventQueue = *(nleventqueue_pthreads_t **)aEventQueues[i];
+
+            pthread_mutex_lock(&lEventQueue->mLock);
+
+            if (nleventqueue_pthreads_count(lEventQueue) > 0)
+            {
+                retval = (int)i;
+            }
+            else if (waiting)
+            {
+                selectors[i].mFutex = &futex;
+                selectors[i].mNext  = lEventQueue->mSelectors;
+                lEventQueue->mSelectors = &selectors[i];
+                registered++;
+            }
+
+            pthread_mutex_unlock(&lEventQueue->mLock);
+        }
+
+        if ((retval == NLER_ERROR_NO_RESOURCE) && waiting)
+        {
+            waiting = nlfutex_pthreads_wait(&futex, expected, deadline);
+        }
+
+        for (i = 0; i < registered; i++)
+        {
+            nleventqueue_pthreads_remove_selector(*(nleventqueue_pthreads_t **)aEventQueues[i], &selectors[i]);
+        }
+    }
+    while ((retval == NLER_ERROR_NO_RESOURCE) && !last);
+
+ done:
+    return retval;
+}
+
 uint32_t nleventqueue_get_count(nleventqueue_t *aEventQueue)
 {
     const nleventqueue_pthreads_t  *lEventQueue = *(nleventqueue_pthreads_t **)aEventQueue;
 
-    return (lEventQueue->mQueueEnd);
+    return (nleventqueue_pthreads_count(lEventQueue));
 }
+
+#endif /* !NLER_FEATURE_LOCK_FREE_QUEUE */
@@ -0,0 +1,214 @@
+/*
+ *
+ *    Copyright (c) 2026 Project nler Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements the POSIX threads (pthreads) build
+ *      platform-internal wait / wake engine.
+ *
+ *      Waiters always sleep against an absolute, monotonic deadline
+ *      such that spurious or early wakeups never stretch the overall
+ *      timeout requested by the caller.
+ *
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "nlfutex-pthreads.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#else
+#include <pthread.h>
+#include <sys/time.h>
+#endif
+
+#if defined(CLOCK_MONOTONIC)
+#define NLFUTEX_CLOCK_ID CLOCK_MONOTONIC
+#else
+#define NLFUTEX_CLOCK_ID CLOCK_REALTIME
+#endif
+
+#define kNanosecondsPerSecond       1000000000L
+#define kNanosecondsPerMillisecond  1000000L
+
+static void nlfutex_pthreads_now(struct timespec *aOutNow)
+{
+    clock_gettime(NLFUTEX_CLOCK_ID, aOutNow);
+}
+
+const struct timespec *nlfutex_pthreads_deadline(nl_time_native_t aTimeoutNative, struct timespec *aOutDeadline)
+{
+    const struct timespec *retval = NULL;
+
+    if (aTimeoutNative != nl_time_ms_to_time_native(NLER_TIMEOUT_NEVER))
+    {
+        const nl_time_ms_t timeout_ms = nl_time_native_to_time_ms(aTimeoutNative);
+
+        nlfutex_pthreads_now(aOutDeadline);
+
+        aOutDeadline->tv_sec  += timeout_ms / 1000;
+        aOutDeadline->tv_nsec += (timeout_ms % 1000) * kNanosecondsPerMillisecond;
+
+        if (aOutDeadline->tv_nsec >= kNanosecondsPerSecond)
+        {
+            aOutDeadline->tv_sec  += 1;
+            aOutDeadline->tv_nsec -= kNanosecondsPerSecond;
+        }
+
+        retval = aOutDeadline;
+    }
+
+    return retval;
+}
+
+#if defined(__linux__)
+
+bool nlfutex_pthreads_wait(nlfutex_t *aFutex, nlfutex_t aExpected, const struct timespec *aDeadline)
+{
+    long status;
+
+    /* FUTEX_WAIT_BITSET, unlike FUTEX_WAIT, takes an absolute timeout
+     * measured against CLOCK_MONOTONIC.
+     */
+    status = syscall(SYS_futex, aFutex, FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG,
+                     aExpected, aDeadline, NULL, FUTEX_BITSET_MATCH_ANY);
+
+    return ((status == 0) || (errno != ETIMEDOUT));
+}
+
+void nlfutex_pthreads_wake(nlfutex_t *aFutex, int aCount)
+{
+    syscall(SYS_futex, aFutex, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, aCount, NULL, NULL, 0);
+}
+
+#else /* defined(__linux__) */
+
+/* Without futexes, a word is parked on one of a small number of
+ * mutex / condition variable buckets selected by its address. Waking
+ * a bucket wakes everything parked on it and unrelated waiters simply
+ * observe a spurious wakeup.
+ */
+#define kFutexBuckets 32
+
+typedef struct nlfutex_bucket_pthreads_s
+{
+    pthread_mutex_t mLock;
+    pthread_cond_t  mCondition;
+} nlfutex_bucket_pthreads_t;
+
+static nlfutex_bucket_pthreads_t sBuckets[kFutexBuckets] = {
+    [0 ... (kFutexBuckets - 1)] = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER }
+};
+
+static bool nlfutex_pthreads_expired(const struct timespec *aDeadline)
+{
+    struct timespec now;
+
+    nlfutex_pthreads_now(&now);
+
+    return ((now.tv_sec > aDeadline->tv_sec) ||
+            ((now.tv_sec == aDeadline->tv_sec) && (now.tv_nsec >= aDeadline->tv_nsec)));
+}
+
+static nlfutex_bucket_pthreads_t *nlfutex_pthreads_get_bucket(const nlfutex_t *aFutex)
+{
+    const uintptr_t address = (uintptr_t)aFutex;
+
+    return &sBuckets[(address / sizeof (nlfutex_t)) % kFutexBuckets];
+}
+
+bool nlfutex_pthreads_wait(nlfutex_t *aFutex, nlfutex_t aExpected, const struct timespec *aDeadline)
+{
+    nlfutex_bucket_pthreads_t *lBucket = nlfutex_pthreads_get_bucket(aFutex);
+    bool                       retval = true;
+
+    pthread_mutex_lock(&lBucket->mLock);
+
+    if (__atomic_load_n(aFutex, __ATOMIC_ACQUIRE) == aExpected)
+    {
+        if (aDeadline == NULL)
+        {
+            pthread_cond_wait(&lBucket->mCondition, &lBucket->mLock);
+        }
+        else
+        {
+            struct timespec now;
+            struct timeval  wall;
+            struct timespec abstime;
+            long            remaining_sec;
+            long            remaining_nsec;
+
+            /* The condition variable measures against the wall clock;
+             * translate the remaining monotonic interval onto it.
+             */
+            nlfutex_pthreads_now(&now);
+            gettimeofday(&wall, NULL);
+
+            remaining_sec  = aDeadline->tv_sec - now.tv_sec;
+            remaining_nsec = aDeadline->tv_nsec - now.tv_nsec;
+
+            if (remaining_nsec < 0)
+            {
+                remaining_sec  -= 1;
+                remaining_nsec += kNanosecondsPerSecond;
+            }
+
+            if (remaining_sec >= 0)
+            {
+                abstime.tv_sec  = wall.tv_sec + remaining_sec;
+                abstime.tv_nsec = (wall.tv_usec * 1000) + remaining_nsec;
+
+                if (abstime.tv_nsec >= kNanosecondsPerSecond)
+                {
+                    abstime.tv_sec  += 1;
+                    abstime.tv_nsec -= kNanosecondsPerSecond;
+                }
+
+                pthread_cond_timedwait(&lBucket->mCondition, &lBucket->mLock, &abstime);
+            }
+
+            retval = !nlfutex_pthreads_expired(aDeadline);
+        }
+    }
+
+    pthread_mutex_unlock(&lBucket->mLock);
+
+    return retval;
+}
+
+void nlfutex_pthreads_wake(nlfutex_t *aFutex, int aCount)
+{
+    nlfutex_bucket_pthreads_t *lBucket = nlfutex_pthreads_get_bucket(aFutex);
+
+    (void)aCount;
+
+    pthread_mutex_lock(&lBucket->mLock);
+
+    pthread_cond_broadcast(&lBucket->mCondition);
+
+    pthread_mutex_unlock(&lBucket->mLock);
+}
+
+#endif /* defined(__linux__) */
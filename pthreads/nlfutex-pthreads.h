@@ -0,0 +1,88 @@
+/*
+ *
+ *    Copyright (c) 2026 Project nler Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file declares the POSIX threads (pthreads) build
+ *      platform-internal wait / wake engine used to block tasks on a
+ *      32-bit word until another task changes it and wakes them.
+ *
+ *      On Linux this maps directly onto futexes. Elsewhere, it is
+ *      emulated with a small, hashed table of mutexes and condition
+ *      variables.
+ *
+ */
+
+#ifndef NLFUTEX_PTHREADS_H
+#define NLFUTEX_PTHREADS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <nlertime.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** A word that tasks may wait on. Wakers must change the value
+ * before calling nlfutex_pthreads_wake().
+ */
+typedef uint32_t nlfutex_t;
+
+/** Compute an absolute, monotonic deadline for a native timeout.
+ *
+ * @param[in]  aTimeoutNative The relative timeout in native time units.
+ *
+ * @param[out] aOutDeadline   Storage for the absolute deadline.
+ *
+ * @return aOutDeadline or NULL if aTimeoutNative never expires.
+ */
+const struct timespec *nlfutex_pthreads_deadline(nl_time_native_t aTimeoutNative, struct timespec *aOutDeadline);
+
+/** Block while the futex still holds an expected value.
+ *
+ * Spurious returns are possible; callers must re-check their
+ * condition and wait again as needed.
+ *
+ * @param[in] aFutex     The word to wait on.
+ *
+ * @param[in] aExpected  The value observed prior to deciding to wait.
+ *
+ * @param[in] aDeadline  An absolute deadline from
+ *                       nlfutex_pthreads_deadline() or NULL to wait
+ *                       forever.
+ *
+ * @return false if the deadline passed, otherwise true.
+ */
+bool nlfutex_pthreads_wait(nlfutex_t *aFutex, nlfutex_t aExpected, const struct timespec *aDeadline);
+
+/** Wake tasks blocked on a futex.
+ *
+ * @param[in] aFutex     The word whose waiters should be woken.
+ *
+ * @param[in] aCount     The maximum number of waiters to wake.
+ */
+void nlfutex_pthreads_wake(nlfutex_t *aFutex, int aCount);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NLFUTEX_PTHREADS_H */
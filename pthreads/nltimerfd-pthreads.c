@@ -0,0 +1,297 @@
+/*
+ *
+ *    Copyright (c) 2026 Project nler Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements the POSIX threads (pthreads)-specific
+ *      timerfd wait.
+ *
+ *      Native time is not necessarily kept on the clock a timerfd can
+ *      run on, so a deadline is carried over to the timerfd's clock
+ *      once, when armed, as its distance from the current native time.
+ *      That clock is CLOCK_BOOTTIME where it exists, as for native
+ *      time, such that a suspend delays neither more than the other. The
+ *      native time read is truncated to the millisecond, so this never
+ *      expires early; it may expire up to a millisecond late, as the
+ *      relative wait it replaces already could.
+ *
+ */
+
+#include "nler-config.h"
+
+#include <nlertimerfd.h>
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/timerfd.h>
+#endif
+
+#include <nlererror.h>
+
+#if defined(__linux__)
+
+#if HAVE_DECL_CLOCK_BOOTTIME
+#define TIMERFD_CLOCK_ID CLOCK_BOOTTIME
+#else
+#define TIMERFD_CLOCK_ID CLOCK_MONOTONIC
+#endif
+
+static int nl_timerfd_pthreads_error(int aErrno)
+{
+    int retval;
+
+    switch (aErrno)
+    {
+
+    case EBADF:
+    case EINVAL:
+        retval = NLER_ERROR_BAD_INPUT;
+        break;
+
+    case ENOMEM:
+        retval = NLER_ERROR_NO_MEMORY;
+        break;
+
+    case EMFILE:
+    case ENFILE:
+    case ENODEV:
+        retval = NLER_ERROR_NO_RESOURCE;
+        break;
+
+    default:
+        retval = NLER_ERROR_FAILURE;
+        break;
+
+    }
+
+    return retval;
+}
+
+int nl_timerfd_init(nl_timerfd_t *aTimer, nleventqueue_t *aQueue)
+{
+    int retval = NLER_SUCCESS;
+
+    if ((aTimer == NULL) || (aQueue == NULL))
+    {
+        retval = NLER_ERROR_BAD_INPUT;
+        goto done;
+    }
+
+    aTimer->mQueueFd = nleventqueue_get_pollable_fd(aQueue);
+
+    if (aTimer->mQueueFd < 0)
+    {
+        retval = aTimer->mQueueFd;
+        goto done;
+    }
+
+    aTimer->mTimerFd = timerfd_create(TIMERFD_CLOCK_ID, TFD_CLOEXEC | TFD_NONBLOCK);
+
+    if (aTimer->mTimerFd < 0)
+    {
+        retval = nl_timerfd_pthreads_error(errno);
+        goto done;
+    }
+
+    aTimer->mQueue    = aQueue;
+    aTimer->mDeadline = 0;
+    aTimer->mArmed    = false;
+
+ done:
+    return retval;
+}
+
+void nl_timerfd_destroy(nl_timerfd_t *aTimer)
+{
+    if ((aTimer != NULL) && (aTimer->mTimerFd >= 0))
+    {
+        close(aTimer->mTimerFd);
+
+        aTimer->mTimerFd = -1;
+    }
+}
+
+int nl_timerfd_arm(nl_timerfd_t *aTimer, nl_time_native_t aDeadline)
+{
+    struct itimerspec   spec;
+    struct timespec     now;
+    int32_t             delta;
+    nl_time_ms_t        delta_ms;
+    int                 retval = NLER_SUCCESS;
+
+    if (aTimer->mArmed && (aTimer->mDeadline == aDeadline))
+    {
+        goto done;
+    }
+
+    if (clock_gettime(TIMERFD_CLOCK_ID, &now) != 0)
+    {
+        retval = nl_timerfd_pthreads_error(errno);
+        goto done;
+    }
+
+    delta = (int32_t)(aDeadline - nl_get_time_native());
+
+    // an all-zero value would disarm the timer, so a deadline already
+    // reached is set to now, which the kernel expires immediately.
+
+    if (delta > 0)
+    {
+        delta_ms = nl_time_native_to_time_ms((nl_time_native_t)delta);
+
+        now.tv_sec  += delta_ms / 1000;
+        now.tv_nsec += (long)(delta_ms % 1000) * 1000000;
+
+        if (now.tv_nsec >= 1000000000)
+        {
+            now.tv_sec++;
+            now.tv_nsec -= 1000000000;
+        }
+    }
+
+    spec.it_interval.tv_sec  = 0;
+    spec.it_interval.tv_nsec = 0;
+    spec.it_value            = now;
+
+    if (timerfd_settime(aTimer->mTimerFd, TFD_TIMER_ABSTIME, &spec, NULL) != 0)
+    {
+        retval = nl_timerfd_pthreads_error(errno);
+        goto done;
+    }
+
+    aTimer->mDeadline = aDeadline;
+    aTimer->mArmed    = true;
+
+ done:
+    return retval;
+}
+
+int nl_timerfd_disarm(nl_timerfd_t *aTimer)
+{
+    struct itimerspec   spec = { { 0, 0 }, { 0, 0 } };
+    int                 retval = NLER_SUCCESS;
+
+    if (!aTimer->mArmed)
+    {
+        goto done;
+    }
+
+    if (timerfd_settime(aTimer->mTimerFd, 0, &spec, NULL) != 0)
+    {
+        retval = nl_timerfd_pthreads_error(errno);
+        goto done;
+    }
+
+    aTimer->mArmed = false;
+
+ done:
+    return retval;
+}
+
+nl_event_t *nl_timerfd_get_event(nl_timerfd_t *aTimer)
+{
+    struct pollfd   fds[2];
+    uint64_t        expirations;
+    nl_event_t      *retval;
+
+    fds[0].fd     = aTimer->mQueueFd;
+    fds[0].events = POLLIN;
+    fds[1].fd     = aTimer->mTimerFd;
+    fds[1].events = POLLIN;
+
+    while (true)
+    {
+        // the queue is looked at first; an expiry cannot be lost by
+        // this since the timerfd stays readable until it is read.
+
+        retval = nleventqueue_get_event_with_timeout(aTimer->mQueue, NLER_TIMEOUT_NOW);
+
+        if (retval != NULL)
+            break;
+
+        if (poll(fds, 2, -1) < 0)
+            continue;
+
+        if (fds[1].revents & POLLIN)
+        {
+            // an expiry must be re-armed even for the same deadline, as
+            // the read below consumes the readiness it would otherwise
+            // have left in place.
+
+            if (read(aTimer->mTimerFd, &expirations, sizeof (expirations)) == sizeof (expirations))
+            {
+                aTimer->mArmed = false;
+
+                break;
+            }
+        }
+    }
+
+    return retval;
+}
+
+#else /* defined(__linux__) */
+
+int nl_timerfd_init(nl_timerfd_t *aTimer, nleventqueue_t *aQueue)
+{
+    (void)aQueue;
+
+    if (aTimer != NULL)
+    {
+        aTimer->mTimerFd = -1;
+        aTimer->mArmed   = false;
+    }
+
+    return NLER_ERROR_NOT_IMPLEMENTED;
+}
+
+void nl_timerfd_destroy(nl_timerfd_t *aTimer)
+{
+    (void)aTimer;
+}
+
+int nl_timerfd_arm(nl_timerfd_t *aTimer, nl_time_native_t aDeadline)
+{
+    (void)aTimer;
+    (void)aDeadline;
+
+    return NLER_ERROR_NOT_IMPLEMENTED;
+}
+
+int nl_timerfd_disarm(nl_timerfd_t *aTimer)
+{
+    (void)aTimer;
+
+    return NLER_ERROR_NOT_IMPLEMENTED;
+}
+
+nl_event_t *nl_timerfd_get_event(nl_timerfd_t *aTimer)
+{
+    (void)aTimer;
+
+    return NULL;
+}
+
+#endif /* defined(__linux__) */
@@ -0,0 +1,435 @@
+/*
+ *
+ *    Copyright (c) 2026 Project nler Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements NLER build platform-independent buffer
+ *      chains.
+ *
+ *      Each segment is a block of the pool memory holding the segment
+ *      itself followed by its storage. A segment that refers to the
+ *      storage of another, following a split, still takes a whole block
+ *      whose own storage goes unused.
+ *
+ */
+
+#include <string.h>
+
+#include "nleratomicops.h"
+#include "nlerbuffer.h"
+#include "nlererror.h"
+
+#define kBufferAlignment        sizeof(void *)
+#define kBufferAlign(s)         (((s) + kBufferAlignment - 1) & ~(kBufferAlignment - 1))
+#define kBufferHeaderSize       kBufferAlign(sizeof(nl_buffer_t))
+
+static uint8_t *nl_buffer_storage(nl_buffer_t *aSegment)
+{
+    return (uint8_t *)aSegment + kBufferHeaderSize;
+}
+
+static void nl_buffer_init_segment(nl_buffer_t *aSegment, nl_buffer_pool_t *aPool)
+{
+    aSegment->mNext            = NULL;
+    aSegment->mData            = nl_buffer_storage(aSegment);
+    aSegment->mLength          = 0;
+    aSegment->mRefCount        = 1;
+    aSegment->mStorageRefCount = 1;
+    aSegment->mOwner           = aSegment;
+    aSegment->mPool            = aPool;
+}
+
+static void nl_buffer_put_storage(nl_buffer_t *aSegment)
+{
+    nl_buffer_pool_t *pool = aSegment->mPool;
+
+    if (nl_er_atomic_dec(&aSegment->mStorageRefCount) == 0)
+    {
+        nllock_enter(&pool->mLock);
+
+        aSegment->mNext = pool->mFree;
+        pool->mFree     = aSegment;
+
+        nllock_exit(&pool->mLock);
+    }
+}
+
+static void nl_buffer_release_segment(nl_buffer_t *aSegment)
+{
+    nl_buffer_t *owner = aSegment->mOwner;
+
+    nl_buffer_put_storage(aSegment);
+
+    if (owner != aSegment)
+    {
+        nl_buffer_put_storage(owner);
+    }
+}
+
+int nl_buffer_pool_create(void *aPoolMemory, size_t aPoolMemorySize, size_t aSegmentSize, nl_buffer_pool_t *aPool)
+{
+    uintptr_t   first;
+    uintptr_t   last;
+    size_t      blockSize;
+    size_t      i;
+    nl_buffer_t *block;
+    int         retval = NLER_SUCCESS;
+
+    if ((aPoolMemory == NULL) || (aPool == NULL) || (aSegmentSize == 0) || (aSegmentSize > UINT16_MAX))
+    {
+        retval = NLER_ERROR_BAD_INPUT;
+        goto done;
+    }
+
+    first     = kBufferAlign((uintptr_t)aPoolMemory);
+    last      = (uintptr_t)aPoolMemory + aPoolMemorySize;
+    blockSize = kBufferHeaderSize + kBufferAlign(aSegmentSize);
+
+    if ((first > last) || ((last - first) < blockSize))
+    {
+        retval = NLER_ERROR_BAD_INPUT;
+        goto done;
+    }
+
+    retval = nllock_create(&aPool->mLock);
+
+    if (retval != NLER_SUCCESS)
+    {
+        goto done;
+    }
+
+    aPool->mFree        = NULL;
+    aPool->mSegmentSize = (uint16_t)aSegmentSize;
+
+    // push the blocks last to first such that they are handed out in
+    // address order.
+
+    for (i = (last - first) / blockSize; i > 0; i--)
+    {
+        block = (nl_buffer_t *)(first + ((i - 1) * blockSize));
+
+        block->mNext = aPool->mFree;
+        aPool->mFree = block;
+    }
+
+ done:
+    return retval;
+}
+
+void nl_buffer_pool_destroy(nl_buffer_pool_t *aPool)
+{
+    if (aPool != NULL)
+    {
+        nllock_destroy(&aPool->mLock);
+
+        aPool->mFree = NULL;
+    }
+}
+
+nl_buffer_t *nl_buffer_alloc(nl_buffer_pool_t *aPool, size_t aLength, size_t aHeadroom)
+{
+    nl_buffer_t *retval = NULL;
+    nl_buffer_t *segment;
+    nl_buffer_t *last;
+    nl_buffer_t *next;
+    size_t      room;
+    size_t      count;
+    size_t      taken;
+
+    if ((aPool == NULL) || (aHeadroom >= aPool->mSegmentSize))
+    {
+        goto done;
+    }
+
+    room  = aPool->mSegmentSize - aHeadroom;
+    count = 1 + ((aLength > room) ? ((aLength - room + aPool->mSegmentSize - 1) / aPool->mSegmentSize) : 0);
+
+    // take every segment at once; the chain is the run of segments at
+    // the head of the free list, cut off after the last one, so they
+    // stay linked in the order they come off it.
+
+    nllock_enter(&aPool->mLock);
+
+    last = NULL;
+
+    for (taken = 0, segment = aPool->mFree; (taken < count) && (segment != NULL); taken++)
+    {
+        last    = segment;
+        segment = segment->mNext;
+    }
+
+    if (taken == count)
+    {
+        retval       = aPool->mFree;
+        aPool->mFree = segment;
+
+        last->mNext  = NULL;
+    }
+
+    nllock_exit(&aPool->mLock);
+
+    for (segment = retval; segment != NULL; segment = segment->mNext)
+    {
+        next = segment->mNext;
+
+        nl_buffer_init_segment(segment, aPool);
+
+        segment->mNext = next;
+
+        if (segment == retval)
+        {
+            segment->mData  += aHeadroom;
+            segment->mLength = (uint16_t)((aLength < room) ? aLength : room);
+        }
+        else
+        {
+            segment->mLength = (uint16_t)((aLength < aPool->mSegmentSize) ? aLength : aPool->mSegmentSize);
+        }
+
+        aLength -= segment->mLength;
+    }
+
+ done:
+    return retval;
+}
+
+void nl_buffer_ref(nl_buffer_t *aBuffer)
+{
+    nl_er_atomic_inc(&aBuffer->mRefCount);
+}
+
+void nl_buffer_free(nl_buffer_t *aBuffer)
+{
+    nl_buffer_t *next;
+
+    while ((aBuffer != NULL) && (nl_er_atomic_dec(&aBuffer->mRefCount) == 0))
+    {
+        next = aBuffer->mNext;
+
+        nl_buffer_release_segment(aBuffer);
+
+        aBuffer = next;
+    }
+}
+
+size_t nl_buffer_length(const nl_buffer_t *aBuffer)
+{
+    size_t retval = 0;
+
+    for (; aBuffer != NULL; aBuffer = aBuffer->mNext)
+    {
+        retval += aBuffer->mLength;
+    }
+
+    return retval;
+}
+
+void nl_buffer_cat(nl_buffer_t *aHead, nl_buffer_t *aTail)
+{
+    while (aHead->mNext != NULL)
+    {
+        aHead = aHead->mNext;
+    }
+
+    aHead->mNext = aTail;
+}
+
+int nl_buffer_adjust_header(nl_buffer_t *aBuffer, int32_t aDelta)
+{
+    size_t  delta;
+    int     retval = NLER_SUCCESS;
+
+    if (aBuffer == NULL)
+    {
+        retval = NLER_ERROR_BAD_INPUT;
+        goto done;
+    }
+
+    if (aDelta >= 0)
+    {
+        delta = (size_t)aDelta;
+
+        // the storage ahead of a segment referring to another's may
+        // hold the data of that other segment.
+
+        if ((aBuffer->mOwner != aBuffer) || (delta > (size_t)(aBuffer->mData - nl_buffer_storage(aBuffer))))
+        {
+            retval = NLER_ERROR_NO_RESOURCE;
+            goto done;
+        }
+
+        aBuffer->mData   -= delta;
+        aBuffer->mLength += delta;
+    }
+    else
+    {
+        delta = (size_t)(-(int64_t)aDelta);
+
+        if (delta > aBuffer->mLength)
+        {
+            retval = NLER_ERROR_BAD_INPUT;
+            goto done;
+        }
+
+        aBuffer->mData   += delta;
+        aBuffer->mLength -= delta;
+    }
+
+ done:
+    return retval;
+}
+
+void nl_buffer_trim(nl_buffer_t *aBuffer, size_t aLength)
+{
+    nl_buffer_t *rest;
+
+    while ((aBuffer != NULL) && (aLength > aBuffer->mLength))
+    {
+        aLength -= aBuffer->mLength;
+        aBuffer  = aBuffer->mNext;
+    }
+
+    if (aBuffer != NULL)
+    {
+        rest = aBuffer->mNext;
+
+        aBuffer->mLength = (uint16_t)aLength;
+        aBuffer->mNext   = NULL;
+
+        nl_buffer_free(rest);
+    }
+}
+
+nl_buffer_t *nl_buffer_split(nl_buffer_t *aBuffer, size_t aOffset)
+{
+    nl_buffer_pool_t *pool;
+    nl_buffer_t      *retval = NULL;
+
+    if (aOffset == 0)
+    {
+        goto done;
+    }
+
+    while ((aBuffer != NULL) && (aOffset > aBuffer->mLength))
+    {
+        aOffset -= aBuffer->mLength;
+        aBuffer  = aBuffer->mNext;
+    }
+
+    if (aBuffer == NULL)
+    {
+        goto done;
+    }
+
+    if (aOffset == aBuffer->mLength)
+    {
+        retval = aBuffer->mNext;
+    }
+    else
+    {
+        pool = aBuffer->mPool;
+
+        nllock_enter(&pool->mLock);
+
+        retval = pool->mFree;
+
+        if (retval != NULL)
+        {
+            pool->mFree = retval->mNext;
+        }
+
+        nllock_exit(&pool->mLock);
+
+        if (retval == NULL)
+        {
+            goto done;
+        }
+
+        nl_buffer_init_segment(retval, pool);
+
+        retval->mOwner  = aBuffer->mOwner;
+        retval->mData   = aBuffer->mData + aOffset;
+        retval->mLength = (uint16_t)(aBuffer->mLength - aOffset);
+        retval->mNext   = aBuffer->mNext;
+
+        nl_er_atomic_inc(&retval->mOwner->mStorageRefCount);
+
+        aBuffer->mLength = (uint16_t)aOffset;
+    }
+
+    aBuffer->mNext = NULL;
+
+ done:
+    return retval;
+}
+
+size_t nl_buffer_write(nl_buffer_t *aBuffer, size_t aOffset, const void *aData, size_t aLength)
+{
+    const uint8_t   *data = (const uint8_t *)aData;
+    size_t          count;
+    size_t          retval = 0;
+
+    for (; (aBuffer != NULL) && (retval < aLength); aBuffer = aBuffer->mNext)
+    {
+        if (aOffset >= aBuffer->mLength)
+        {
+            aOffset -= aBuffer->mLength;
+            continue;
+        }
+
+        count = aBuffer->mLength - aOffset;
+
+        if (count > (aLength - retval))
+            count = aLength - retval;
+
+        memcpy(aBuffer->mData + aOffset, data + retval, count);
+
+        retval += count;
+        aOffset = 0;
+    }
+
+    return retval;
+}
+
+size_t nl_buffer_read(const nl_buffer_t *aBuffer, size_t aOffset, void *aData, size_t aLength)
+{
+    uint8_t         *data = (uint8_t *)aData;
+    size_t          count;
+    size_t          retval = 0;
+
+    for (; (aBuffer != NULL) && (retval < aLength); aBuffer = aBuffer->mNext)
+    {
+        if (aOffset >= aBuffer->mLength)
+        {
+            aOffset -= aBuffer->mLength;
+            continue;
+        }
+
+        count = aBuffer->mLength - aOffset;
+
+        if (count > (aLength - retval))
+            count = aLength - retval;
+
+        memcpy(data + retval, aBuffer->mData + aOffset, count);
+
+        retval += count;
+        aOffset = 0;
+    }
+
+    return retval;
+}
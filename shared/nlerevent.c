@@ -26,6 +26,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include "nlerevent.h"
+#include <nlereventpooled.h>
 #include <nlertimer.h>
 
 int nl_dispatch_event(nl_event_t *aEvent, nl_eventhandler_t aDefaultHandler, void *aDefaultClosure)
@@ -48,6 +49,11 @@ int nl_dispatch_event(nl_event_t *aEvent, nl_eventhandler_t aDefaultHandler, voi
         {
             retval = (aDefaultHandler)(aEvent, aDefaultClosure);
         }
+
+        if (aEvent->mType == NL_EVENT_T_MULTICAST)
+        {
+            nlevent_multicast_release((nlevent_multicast_t *)aEvent);
+        }
     }
 
     return retval;
@@ -0,0 +1,102 @@
+/*
+ *
+ *    Copyright (c) 2026 Project nler Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements NLER build platform-independent multicast
+ *      pooled events.
+ *
+ *      A multicast event carries a count of the consumers that have yet
+ *      to dispatch it. Every reference is taken before the first post
+ *      such that a consumer dispatching the event early cannot recycle it
+ *      while it is still being posted to the remaining queues.
+ *
+ */
+
+#include <stdint.h>
+
+#include "nleratomicops.h"
+#include "nlererror.h"
+#include "nlereventpooled.h"
+
+nlevent_multicast_t *nlevent_pool_get_multicast_event(nlevent_pool_t *aPool)
+{
+    nlevent_multicast_t *retval;
+
+    retval = (nlevent_multicast_t *)nlevent_pool_get_event_sized(aPool, sizeof(nlevent_multicast_t));
+
+    if (retval != NULL)
+    {
+        NL_INIT_EVENT(*retval, NL_EVENT_T_MULTICAST, NULL, NULL);
+
+        retval->mReturnQueue = NULL;
+        retval->mPayload     = NULL;
+        retval->mPool        = aPool;
+        retval->mRefCount    = 0;
+    }
+
+    return retval;
+}
+
+int nlevent_multicast_post(nlevent_multicast_t *aEvent, nleventqueue_t * const *aEventQueues, size_t aQueueCount)
+{
+    int32_t     failed = 0;
+    size_t      i;
+    int         status;
+    int         retval = NLER_SUCCESS;
+
+    if ((aEvent == NULL) || (aEvent->mType != NL_EVENT_T_MULTICAST) ||
+        (aEventQueues == NULL) || (aQueueCount == 0) || (aQueueCount > INT32_MAX))
+    {
+        retval = NLER_ERROR_BAD_INPUT;
+        goto done;
+    }
+
+    aEvent->mRefCount = (int32_t)aQueueCount;
+
+    for (i = 0; i < aQueueCount; i++)
+    {
+        status = nleventqueue_post_event(aEventQueues[i], (nl_event_t *)aEvent);
+
+        if (status != NLER_SUCCESS)
+        {
+            retval = status;
+            failed++;
+        }
+    }
+
+    // the references of the queues that refused the event are dropped
+    // only now; the event may no longer be touched unless this was the
+    // last of them.
+
+    if ((failed > 0) && (nl_er_atomic_add(&aEvent->mRefCount, -failed) == 0))
+    {
+        nlevent_pool_recycle_event(aEvent->mPool, (nlevent_pooled_t *)aEvent);
+    }
+
+ done:
+    return retval;
+}
+
+void nlevent_multicast_release(nlevent_multicast_t *aEvent)
+{
+    if (nl_er_atomic_dec(&aEvent->mRefCount) == 0)
+    {
+        nlevent_pool_recycle_event(aEvent->mPool, (nlevent_pooled_t *)aEvent);
+    }
+}
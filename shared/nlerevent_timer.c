@@ -37,6 +37,23 @@
 #include <stdio.h>
 #include "nlerassert.h"
 #include "nleratomicops.h"
+#include "nlermathutil.h"
+#include "nlertimerwheel.h"
+
+#if NLER_FEATURE_TIMER_USING_TIMERFD
+#include "nlertimerfd.h"
+
+/* The timerfd tracks real time only */
+#if NLER_FEATURE_SIMULATEABLE_TIME
+#error Cannot use timerfd when doing simulateable time
+#endif
+
+/* The timerfd is waited on by the timer task, which swtimer does without */
+#if NLER_FEATURE_TIMER_USING_SWTIMER
+#error Cannot use timerfd together with swtimer
+#endif
+#endif
+#include <stddef.h>
 #include <nlcompiler.h>
 
 #if NLER_FEATURE_SIMULATEABLE_TIME
@@ -47,14 +64,6 @@
 #if NLER_FEATURE_TIMER_USING_SWTIMER
 #error Cannot use swtimer when doing simulateable time
 #endif
-
-/* Should really be number of tasks, but simulators don't always have a max
- * task defined.  We presume there won't be more tasks using timers than
- * simultaneous timers supported.
- */
-nltask_t *s_task_list[NLER_MAX_TIMER_EVENTS];
-nllock_t s_lock_list[NLER_MAX_TIMER_EVENTS];
-
 #endif
 
 #if NLER_FEATURE_TIMER_USING_SWTIMER
@@ -64,32 +73,29 @@ nllock_t s_lock_list[NLER_MAX_TIMER_EVENTS];
 typedef struct nl_event_timer_s
 {
     NL_DECLARE_EVENT                    /**< Common event fields */
-    nleventqueue_t     *mReturnQueue;   /**< Queue to send timer event to on delay expiration */
-    bool                mRepeating;     /**< Timer flag: timer is repeating */
-    bool                mCancelled;     /**< Timer flag: timer was cancelled */
-    uint8_t             mQueuedCount;   /**< Count of times event has been posted to mReturnQueue */
-    uint8_t             mIgnoreCount;   /**< Count of times to ignore events in is_valid() checks due to restarts */
+    nleventqueue_t     *mReturnQueue;   /**< Queue to send timer event to on delay expiration, NULL for a callback timer */
+#if !NLER_FEATURE_TIMER_USING_SWTIMER
+    nl_timer_wheel_link_t mWheelLink;   /**< For internal use by timer implementation */
+    struct nl_event_timer_s *mListNext; /**< Next timer on the shard's list of timers to (re)arm */
+#endif
+    intptr_t            mState;         /**< Timer state word, see TIMER_STATE_* */
+    uint16_t            mOverrunCount;  /**< Expiries missed since the pending event was queued */
+    uint16_t            mOverrun;       /**< Expiries missed before the event last checked by is_valid() */
+#if !NLER_FEATURE_TIMER_USING_SWTIMER
+    uint16_t            mArmedGeneration; /**< Generation of the run in the timer wheel */
+#endif
+    uint8_t             mMode;          /**< Timer mode: one of nl_event_timer_mode_t */
 #if NLER_FEATURE_TIMER_USING_SWTIMER
     nl_swtimer_t        mTimer;
 #else
-    nl_time_native_t    mTimeNow;       /**< For internal use by timer implementation */
-    nl_time_native_t    mTimeoutNative; /**< For internal use by timer implementation */
-#endif
-#if NLER_FEATURE_SIMULATEABLE_TIME
-    /* In simulator, task scheduling isn't like on a real device.
-     * More than one task might be running (due to host machines having
-     * more than one core) and task priorities are not honored (consider
-     * all tasks to be running at the same priority).
-     *
-     * The device implementation made assumptions about single core
-     * and priorities being honored, so we have to add additional
-     * synchronization primitives in the simulator case.
-     */
-    nllock_t           *mLock;          /**< Lock for accessing structure members atomically */
+    nl_time_native_t    mStartNative;   /**< First deadline less one period, as requested */
+    nl_time_native_t    mTimeNow;       /**< Deadline less one period, as armed */
+    nl_time_native_t    mTimeoutNative; /**< Period */
+    nl_time_native_t    mSlackNative;   /**< Lateness tolerated, for coalescing expiries */
 #endif
 #ifdef DEBUG
     /* We require that the task that calls start() be the same as the
-     * receiving task that calls is_valid(), cancel(), etc.
+     * receiving task that calls is_valid().
      */
     nltask_t           *mTask;          /**< Receiving task */
 #endif
@@ -97,12 +103,60 @@ typedef struct nl_event_timer_s
 
 _Static_assert(sizeof(nl_event_timer_t) == sizeof(nl_event_timer_internal_t), "sizeof(nl_event_timer_t) != sizeof(nl_event_timer_internal_t)");
 
-static void post_timer_event(nl_event_timer_internal_t *aTimer)
+/* The state word packs, from the least significant bit up, the number
+ * of the timer's events on mReturnQueue, how many of those are stale
+ * and to be ignored by is_valid(), whether the timer is running,
+ * whether it is on its shard's list of timers to arm, and a generation
+ * bumped by every start and cancel. Starting, cancelling and checking
+ * a timer thus each come down to compare-and-swaps of this one word,
+ * from any task, and the timer task tells a stale run in its wheel from
+ * the current one by the generation alone.
+ */
+#define TIMER_STATE_QUEUED_ONE      ((intptr_t)0x00000001)
+#define TIMER_STATE_QUEUED_MAX      0xffU
+#define TIMER_STATE_IGNORE_ONE      ((intptr_t)0x00000100)
+#define TIMER_STATE_IGNORE_SHIFT    8
+#define TIMER_STATE_IGNORE_MASK     ((intptr_t)0x0000ff00)
+#define TIMER_STATE_RUNNING         ((intptr_t)0x00010000)
+#define TIMER_STATE_LISTED          ((intptr_t)0x00020000)
+#define TIMER_STATE_GEN_ONE         ((uintptr_t)0x00040000)
+#define TIMER_STATE_GEN_SHIFT       18
+#define TIMER_STATE_GEN_BITS        ((uintptr_t)0x7ffc0000)
+
+#define TIMER_QUEUED(s)             ((uint32_t)(s) & TIMER_STATE_QUEUED_MAX)
+#define TIMER_IGNORED(s)            (((uint32_t)(s) >> TIMER_STATE_IGNORE_SHIFT) & TIMER_STATE_QUEUED_MAX)
+#define TIMER_GENERATION(s)         ((uint16_t)(((uintptr_t)(s) & TIMER_STATE_GEN_BITS) >> TIMER_STATE_GEN_SHIFT))
+
+static bool cas_timer_state(nl_event_timer_internal_t *aTimer, intptr_t aState, intptr_t aNewState)
+{
+    return (nl_er_atomic_cas(&aTimer->mState, aState, aNewState) == aState);
+}
+
+static intptr_t next_timer_generation(intptr_t aState)
+{
+    const uintptr_t state = (uintptr_t)aState;
+
+    return (intptr_t)((state & ~TIMER_STATE_GEN_BITS) | ((state + TIMER_STATE_GEN_ONE) & TIMER_STATE_GEN_BITS));
+}
+
+/* Stop the current run, if any, and take every event of the timer
+ * still queued for a stale one, such that neither is_valid() nor the
+ * timer task mistakes it, or the old run, for a new one. Returns the
+ * state word as it was.
+ */
+static intptr_t stop_timer_run(nl_event_timer_internal_t *aTimer)
 {
-    if (nleventqueue_post_event(aTimer->mReturnQueue, (nl_event_t *)aTimer) == NLER_SUCCESS)
+    intptr_t state;
+    intptr_t updated;
+
+    do
     {
-        nl_er_atomic_inc8((int8_t*)&aTimer->mQueuedCount);
-    }
+        state = aTimer->mState;
+        updated = next_timer_generation(state) & ~(TIMER_STATE_RUNNING | TIMER_STATE_IGNORE_MASK);
+        updated |= (intptr_t)TIMER_QUEUED(state) << TIMER_STATE_IGNORE_SHIFT;
+    } while (!cas_timer_state(aTimer, state, updated));
+
+    return state;
 }
 
 #if NLER_FEATURE_TIMER_USING_SWTIMER
@@ -110,12 +164,30 @@ static uint32_t nl_event_timer_function(nl_swtimer_t *aTimer, void *aArg)
 {
     nl_time_ms_t repeat_delay_ms;
     nl_event_timer_internal_t *timer = (nl_event_timer_internal_t*)((unsigned)aTimer - (unsigned)&(((nl_event_timer_internal_t*)0x0)->mTimer));
-    if (nleventqueue_post_event_from_isr(timer->mReturnQueue, (nl_event_t*)timer) == NLER_SUCCESS)
+    const intptr_t state = timer->mState;
+
+    if (!(state & TIMER_STATE_RUNNING))
+    {
+        return 0;
+    }
+
+    if (timer->mReturnQueue == NULL)
+    {
+        timer->mHandler((nl_event_t*)timer, timer->mHandlerClosure);
+    }
+    else if ((TIMER_QUEUED(state) <= TIMER_IGNORED(state)) && (TIMER_QUEUED(state) < TIMER_STATE_QUEUED_MAX) &&
+             (nleventqueue_post_event_from_isr(timer->mReturnQueue, (nl_event_t*)timer) == NLER_SUCCESS))
     {
         // since we're running as an interrupt, atomic API not needed
-        timer->mQueuedCount++;
+        timer->mState = state + TIMER_STATE_QUEUED_ONE;
+    }
+    else if (timer->mOverrunCount < UINT16_MAX)
+    {
+        // either an event is still pending or there was no room for
+        // one; the receiver learns of this expiry as an overrun.
+        timer->mOverrunCount++;
     }
-    if (timer->mRepeating && !timer->mCancelled)
+    if (timer->mMode != NL_EVENT_TIMER_ONE_SHOT)
     {
         // restart if repeating and not cancelled.
         repeat_delay_ms = (nl_time_ms_t)aArg;
@@ -136,167 +208,392 @@ static uint32_t nl_event_timer_function(nl_swtimer_t *aTimer, void *aArg)
 #define NLER_MAX_TIMER_EVENTS   4
 #endif
 
-static int sync_barrier_dummy_function(nl_event_t *aEvent, void *aClosure)
-{
-    return 0;
-}
+#if NLER_FEATURE_SIMULATEABLE_TIME && (NLER_TIMER_SHARDS > 1)
+/* Advancing simulated time assumes one timer task */
+#error Cannot shard the timer task when doing simulateable time
+#endif
 
-static nltask_t sTimerTask;
+/* Each shard is a timer task of its own, serving the timers whose
+ * return queue hashes to it.
+ *
+ * Starting a timer pushes it onto mListed, from which the timer task
+ * (re)arms it on its next pass. Only the first push before a pass
+ * posts mKick to wake the task; the rest ride along with it. Cancelling
+ * leaves the timer where it is.
+ */
+typedef struct nl_timer_shard_s
+{
+    nltask_t            mTask;
+    /* this has one more event to account for the fact that it can handle an exit
+     * request
+     */
+    nl_event_t         *mQueueMemory[NLER_MAX_TIMER_EVENTS + 1];
+    nl_timer_wheel_t    mWheel;
+    nleventqueue_t      mQueue;
+    nl_time_native_t    mTimeoutNative;
+    nl_time_native_t    mNow;           // time of the pass expiring timers
+    nl_event_t         *mBatch[NLER_TIMER_BATCH_SIZE];  // expirations not yet posted
+    size_t              mBatchCount;
+    intptr_t            mListed;        // timers to (re)arm, pushed lock-free
+    nl_event_t          mKick;
+    int32_t             mKicked;        // whether mKick is on mQueue
+#if NLER_FEATURE_TIMER_USING_TIMERFD
+    nl_timerfd_t        mTimerFd;
+#endif
+    int                 mRunning;
+} nl_timer_shard_t;
+
+DEFINE_STACK(sTimerStacks[NLER_TIMER_SHARDS], (NLER_TASK_STACK_BASE + NLER_TIMER_STACK_SIZE));
+
+static nl_timer_shard_t sShards[NLER_TIMER_SHARDS];
+static nl_time_native_t sTimeoutNeverNative;  // Used store nl_time_ms_to_delay_time_native(NLER_TIMEOUT_NEVER);
 
-DEFINE_STACK(sTimerStack, (NLER_TASK_STACK_BASE + NLER_TIMER_STACK_SIZE));
+#define TIMER_FROM_LINK(l) ((nl_event_timer_internal_t *)((char *)(l) - offsetof(nl_event_timer_internal_t, mWheelLink)))
 
-/* this has one more event to account for the fact that it can handle an exit
- * request
+/* Timers are sharded by return queue rather than by the task starting
+ * them: every event bound for a queue then comes from the one timer
+ * task, in deadline order, and a restart or cancel always finds the
+ * timer in the wheel it was added to.
  */
-static nl_event_t *sQueueMemory[NLER_MAX_TIMER_EVENTS + 1];
-static nl_event_timer_internal_t *sTimers[NLER_MAX_TIMER_EVENTS];
-static nleventqueue_t sQueue;
-static nl_time_native_t sTimeoutNative = NLER_TIMEOUT_NEVER; // FIXME: this macro has type nl_time_ms_t
-static int sEnd = 0;
-static int sRunning = 1;
-static nl_time_native_t sTimeoutNeverNative;  // Used store nl_time_ms_to_delay_time_native(NLER_TIMEOUT_NEVER);
+static nl_timer_shard_t *shard_for_timer(const nl_event_timer_internal_t *aTimer)
+{
+#if NLER_TIMER_SHARDS > 1
+    // callback timers have no queue to keep in order and are spread
+    // by their own address instead.
+    const void *owner = (aTimer->mReturnQueue != NULL) ? (const void *)aTimer->mReturnQueue : (const void *)aTimer;
+
+    return &sShards[nl_hash_pointer(owner, NLER_TIMER_SHARDS)];
+#else
+    (void)aTimer;
 
-static void remove_timer(int aIndex)
+    return &sShards[0];
+#endif
+}
+
+/* Hand a timer whose state word was just marked listed to the timer
+ * task of its shard.
+ */
+static void list_timer(nl_event_timer_internal_t *aTimer)
 {
-    if (aIndex != (sEnd - 1))
+    nl_timer_shard_t *shard = shard_for_timer(aTimer);
+    intptr_t head;
+    int err;
+
+    NLER_ASSERT(shard->mRunning);
+
+    do
     {
-        memmove(&sTimers[aIndex], &sTimers[aIndex + 1],
-                sizeof(nl_event_timer_t *) * (sEnd - (aIndex + 1)));
-    }
-    else
+        head = shard->mListed;
+        aTimer->mListNext = (nl_event_timer_internal_t *)head;
+    } while (nl_er_atomic_cas(&shard->mListed, head, (intptr_t)aTimer) != head);
+
+    if (nl_er_atomic_set(&shard->mKicked, 1) == 0)
     {
-        /* removing last timer, just set entry to NULL */
-        sTimers[aIndex] = NULL;
+        err = nleventqueue_post_event(&shard->mQueue, &shard->mKick);
+        NLER_ASSERT(err >= 0);
     }
+}
 
-    sEnd--;
+/* Whether the run of a timer in the wheel is still the current one.
+ */
+static bool is_armed_run(const nl_event_timer_internal_t *aTimer, intptr_t aState)
+{
+    return ((aState & TIMER_STATE_RUNNING) && (TIMER_GENERATION(aState) == aTimer->mArmedGeneration));
 }
 
-static void handle_timer_event(nl_event_timer_internal_t *aEvent)
+/* Count expiries that were not queued against the event that is. The
+ * count saturates rather than wrap.
+ */
+static void add_overruns(nl_event_timer_internal_t *aTimer, uint32_t aCount)
 {
-    const nl_time_native_t now = nl_get_time_native();
-    nl_time_native_t newtimeout = sTimeoutNeverNative;
-    nl_time_native_t curtimeout = 0;
+    uint16_t count;
+    uint16_t updated;
 
-    int idx = 0;
-    while (idx < sEnd)
+    do
     {
-#if NLER_FEATURE_SIMULATEABLE_TIME
-        nl_event_timer_internal_t *timer = sTimers[idx];
-        NLER_ASSERT(timer->mLock);
-        nllock_enter(timer->mLock);
-#endif
-        if (sTimers[idx] == aEvent)
+        count = aTimer->mOverrunCount;
+        updated = (aCount >= (uint32_t)(UINT16_MAX - count)) ? UINT16_MAX : (uint16_t)(count + aCount);
+    } while ((uint16_t)nl_er_atomic_cas16((int16_t*)&aTimer->mOverrunCount, (int16_t)count, (int16_t)updated) != count);
+}
+
+/* Take back the count of an event that did not fit on its queue.
+ */
+static void unqueue_timer_event(nl_event_timer_internal_t *aTimer)
+{
+    intptr_t state;
+    intptr_t updated;
+
+    do
+    {
+        state = aTimer->mState;
+        updated = state - TIMER_STATE_QUEUED_ONE;
+
+        // a restart since the event was counted took it for a stale one.
+        if (TIMER_IGNORED(state) == TIMER_QUEUED(state))
         {
-            NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) replaced\n",
-                         sTimers[idx], nl_time_native_to_time_ms(sTimers[idx]->mTimeoutNative));
-            aEvent = NULL;
+            updated -= TIMER_STATE_IGNORE_ONE;
         }
-        if (sTimers[idx]->mCancelled)
+    } while (!cas_timer_state(aTimer, state, updated));
+}
+
+/* Post the expirations collected so far, one batch per return queue.
+ * Each queue receives its timers in the order they expired.
+ */
+static void flush_timer_events(nl_timer_shard_t *aShard)
+{
+    nl_event_t *events[NLER_TIMER_BATCH_SIZE];
+    nleventqueue_t *queue;
+    uint32_t count;
+    uint32_t posted;
+    size_t i;
+    size_t j;
+
+    for (i = 0; i < aShard->mBatchCount; i++)
+    {
+        if (aShard->mBatch[i] == NULL)
         {
-            NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) cancelled\n",
-                         sTimers[idx], nl_time_native_to_time_ms(sTimers[idx]->mTimeoutNative));
-            remove_timer(idx);
-#if NLER_FEATURE_SIMULATEABLE_TIME
-            nllock_exit(timer->mLock);
-#endif
             continue;
         }
 
-        if (now - sTimers[idx]->mTimeNow >= sTimers[idx]->mTimeoutNative)
-        {
-            NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) timedout [idx: %d (%u - %u [%u]) >= %u]\n",
-                         sTimers[idx], nl_time_native_to_time_ms(sTimers[idx]->mTimeoutNative),
-                         idx, now, sTimers[idx]->mTimeNow,
-                         now - sTimers[idx]->mTimeNow, sTimers[idx]->mTimeoutNative);
+        queue = ((nl_event_timer_internal_t *)aShard->mBatch[i])->mReturnQueue;
+        count = 0;
 
-            post_timer_event(sTimers[idx]);
-            if (sTimers[idx]->mRepeating)
-            {
-                NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) will repeat\n",
-                             sTimers[idx], nl_time_native_to_time_ms(sTimers[idx]->mTimeoutNative));
-                // mTimeoutNative has an extra tick for the initial delay.
-                // repeats shouldn't have that extra tick, so we just remove
-                // it from the mTimeNow
-                sTimers[idx]->mTimeNow = now - 1;
-            }
-            else
+        for (j = i; j < aShard->mBatchCount; j++)
+        {
+            if ((aShard->mBatch[j] != NULL) &&
+                (((nl_event_timer_internal_t *)aShard->mBatch[j])->mReturnQueue == queue))
             {
-                remove_timer(idx);
-#if NLER_FEATURE_SIMULATEABLE_TIME
-                nllock_exit(timer->mLock);
-#endif
-                continue;
+                events[count++] = aShard->mBatch[j];
+                aShard->mBatch[j] = NULL;
             }
         }
 
-        NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) participates in timeout computation\n",
-                     sTimers[idx], nl_time_native_to_time_ms(sTimers[idx]->mTimeoutNative));
+        posted = nleventqueue_post_events(queue, (const nl_event_t * const *)events, count);
 
-        if (now - sTimers[idx]->mTimeNow < sTimers[idx]->mTimeoutNative)
+        // the expiries that did not fit are reported with the next
+        // event of their timer instead.
+        for (j = posted; j < count; j++)
         {
-            curtimeout = sTimers[idx]->mTimeNow + sTimers[idx]->mTimeoutNative - now;
+            unqueue_timer_event((nl_event_timer_internal_t *)events[j]);
+            add_overruns((nl_event_timer_internal_t *)events[j], 1);
         }
-        else
+    }
+
+    aShard->mBatchCount = 0;
+}
+
+/* Deliver an expiry: run a callback timer's handler right here on the
+ * timer task, or collect any other timer for posting to its return
+ * queue at the end of the pass. At most one event per timer is queued
+ * at a time; the receiver learns of any further expiries as overruns
+ * of that one.
+ */
+static void fire_timer(nl_timer_shard_t *aShard, nl_event_timer_internal_t *aTimer)
+{
+    intptr_t state;
+
+    if (aTimer->mReturnQueue == NULL)
+    {
+        if (is_armed_run(aTimer, aTimer->mState))
         {
-            // the timer is already expired. Set curtimeout = 0 to avoid
-            // assigning a negative value to an unsigned.
-            curtimeout = 0;
+            aTimer->mHandler((nl_event_t *)aTimer, aTimer->mHandlerClosure);
         }
 
-        if (curtimeout < newtimeout)
+        return;
+    }
+
+    // counted now, rather than once posted, so that the timer is seen
+    // to be pending for the rest of the pass, and only if the run was
+    // not stopped in the meantime.
+    do
+    {
+        state = aTimer->mState;
+
+        if (!is_armed_run(aTimer, state))
         {
-            newtimeout = curtimeout;
+            return;
         }
-        idx++;
-#if NLER_FEATURE_SIMULATEABLE_TIME
-        nllock_exit(timer->mLock);
-#endif
+
+        if ((TIMER_QUEUED(state) > TIMER_IGNORED(state)) || (TIMER_QUEUED(state) == TIMER_STATE_QUEUED_MAX))
+        {
+            add_overruns(aTimer, 1);
+            return;
+        }
+    } while (!cas_timer_state(aTimer, state, state + TIMER_STATE_QUEUED_ONE));
+
+    if (aShard->mBatchCount == NLER_TIMER_BATCH_SIZE)
+    {
+        flush_timer_events(aShard);
     }
 
-#if NLER_FEATURE_SIMULATEABLE_TIME
-    if (aEvent && (aEvent->mHandler == sync_barrier_dummy_function))
+    aShard->mBatch[aShard->mBatchCount++] = (nl_event_t *)aTimer;
+}
+
+static void expire_timer(nl_timer_wheel_link_t *aLink, void *aClosure)
+{
+    nl_event_timer_internal_t *timer = TIMER_FROM_LINK(aLink);
+    nl_timer_shard_t *shard = (nl_timer_shard_t *)aClosure;
+    const nl_time_native_t now = shard->mNow;
+    nl_time_native_t period;
+    nl_time_native_t deadline;
+    uint32_t missed;
+
+    if (!is_armed_run(timer, timer->mState))
+    {
+        // cancelled or restarted since it was armed, so dropped here; a
+        // restart has listed the timer to be armed anew.
+        NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) stale\n",
+                     timer, nl_time_native_to_time_ms(timer->mTimeoutNative));
+        return;
+    }
+
+    NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) timedout [(%u - %u [%u]) >= %u]\n",
+                 timer, nl_time_native_to_time_ms(timer->mTimeoutNative),
+                 now, timer->mTimeNow,
+                 now - timer->mTimeNow, timer->mTimeoutNative);
+
+    fire_timer(shard, timer);
+
+    // a restart in progress may be rewriting these, in which case
+    // whatever is made of them here is stale and superseded once the
+    // timer is listed.
+    period = timer->mTimeoutNative;
+
+    if ((timer->mMode != NL_EVENT_TIMER_ONE_SHOT) && (period != 0))
     {
-        /* Special barrier event.  Synchronize by posting back.
-         */
-        if (nleventqueue_post_event(aEvent->mReturnQueue, (nl_event_t *)aEvent) != NLER_SUCCESS)
+        NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) will repeat\n",
+                     timer, nl_time_native_to_time_ms(timer->mTimeoutNative));
+        // the next deadline follows on from the one just reached
+        // rather than from now, such that latency in getting here
+        // does not accumulate as drift.
+        deadline = timer->mTimeNow + period + period;
+
+        // a callback timer catches up by being called once per
+        // missed period; a queued one already has its event pending
+        // and would only count them as overruns one by one.
+        if ((timer->mMode == NL_EVENT_TIMER_REPEAT_CATCH_UP) && (timer->mReturnQueue == NULL))
+        {
+            while ((int32_t)(deadline - now) <= 0)
+            {
+                fire_timer(shard, timer);
+                deadline += period;
+            }
+        }
+
+        // skip whatever periods remain missed, which also keeps the
+        // timer from expiring again within this same pass.
+        if ((int32_t)(deadline - now) <= 0)
         {
-            // assert on failure
-            NLER_ASSERT(false);
+            missed = ((now - deadline) / period) + 1;
+            deadline += missed * period;
+
+            if (timer->mReturnQueue != NULL)
+            {
+                add_overruns(timer, missed);
+            }
         }
-        aEvent = NULL;
+
+        timer->mTimeNow = deadline - period;
+
+        nl_timer_wheel_add(&shard->mWheel, &timer->mWheelLink,
+                           nl_timer_wheel_apply_slack(deadline, timer->mSlackNative));
     }
-#endif
+}
 
-    if (aEvent != NULL)
+/* Take the timers started since the last pass off the list and
+ * (re)arm them in the wheel, or drop them from it if they have been
+ * cancelled since.
+ */
+static void arm_listed_timers(nl_timer_shard_t *aShard)
+{
+    nl_event_timer_internal_t *timer;
+    nl_event_timer_internal_t *next;
+    nl_time_native_t start;
+    nl_time_native_t period;
+    nl_time_native_t slack;
+    intptr_t head;
+    intptr_t state;
+
+    do
     {
-        if (sEnd == NLER_MAX_TIMER_EVENTS)
-        {
-            NL_LOG(lrERTIMER, "timer: no space to add timer (%p). max of %d timers exceeded\n", aEvent, NLER_MAX_TIMER_EVENTS);
+        head = aShard->mListed;
+    } while (nl_er_atomic_cas(&aShard->mListed, head, 0) != head);
 
-            NLER_ASSERT(sEnd < NLER_MAX_TIMER_EVENTS);
+    for (timer = (nl_event_timer_internal_t *)head; timer != NULL; timer = next)
+    {
+        // read before the timer is marked unlisted and may be pushed
+        // anew.
+        next = timer->mListNext;
+
+        // drop the run the timer was restarted over.
+        if (nl_timer_wheel_is_pending(&timer->mWheelLink))
+        {
+            NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) %s\n",
+                         timer, nl_time_native_to_time_ms(timer->mTimeoutNative),
+                         (timer->mState & TIMER_STATE_RUNNING) ? "replaced" : "cancelled");
+            nl_timer_wheel_remove(&aShard->mWheel, &timer->mWheelLink);
         }
-        else
+
+        // the run parameters only change while the timer is stopped, so
+        // those read here belong to the run in the state word if marking
+        // it unlisted succeeds. The compare-and-swap orders the reads
+        // after the load of the state.
+        do
         {
-            NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) added\n",
-                         aEvent, nl_time_native_to_time_ms(aEvent->mTimeoutNative));
+            state = nl_er_atomic_cas(&timer->mState, 0, 0);
+            start = timer->mStartNative;
+            period = timer->mTimeoutNative;
+            slack = timer->mSlackNative;
+        } while (!cas_timer_state(timer, state, state & ~TIMER_STATE_LISTED));
 
-            sTimers[sEnd++] = aEvent;
+        if (!(state & TIMER_STATE_RUNNING))
+        {
+            continue;
+        }
 
-            curtimeout = aEvent->mTimeNow + aEvent->mTimeoutNative - now;
+        NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) added\n",
+                     timer, nl_time_native_to_time_ms(period));
 
-            if (curtimeout < newtimeout)
-                newtimeout = curtimeout;
+        timer->mArmedGeneration = TIMER_GENERATION(state);
+        timer->mTimeNow = start;
 
-        }
+        nl_timer_wheel_add(&aShard->mWheel, &timer->mWheelLink,
+                           nl_timer_wheel_apply_slack(start + period, slack));
     }
+}
+
+static void handle_timer_event(nl_timer_shard_t *aShard)
+{
+    nl_time_native_t now = nl_get_time_native();
+    nl_time_native_t next;
+
+    arm_listed_timers(aShard);
+
+    aShard->mNow = now;
+
+    nl_timer_wheel_advance(&aShard->mWheel, now, expire_timer, aShard);
 
-    sTimeoutNative = newtimeout;
+    flush_timer_events(aShard);
 
-    NL_LOG_DEBUG(lrERTIMER, "timer: new timeout: %d\n", nl_time_native_to_time_ms(newtimeout));
+    if (nl_timer_wheel_next(&aShard->mWheel, &next))
+    {
+        aShard->mTimeoutNative = ((int32_t)(next - now) > 0) ? (next - now) : 0;
+#if NLER_FEATURE_TIMER_USING_TIMERFD
+        nl_timerfd_arm(&aShard->mTimerFd, next);
+#endif
+    }
+    else
+    {
+        aShard->mTimeoutNative = sTimeoutNeverNative;
+#if NLER_FEATURE_TIMER_USING_TIMERFD
+        nl_timerfd_disarm(&aShard->mTimerFd);
+#endif
+    }
+
+    NL_LOG_DEBUG(lrERTIMER, "timer: new timeout: %d\n", nl_time_native_to_time_ms(aShard->mTimeoutNative));
 }
 
-static int nl_timer_eventhandler(nl_event_t *aEvent)
+static int nl_timer_eventhandler(nl_timer_shard_t *aShard, nl_event_t *aEvent)
 {
     int         retval = NLER_SUCCESS;
 
@@ -305,11 +602,14 @@ static int nl_timer_eventhandler(nl_event_t *aEvent)
         switch (aEvent->mType)
         {
             case NL_EVENT_T_TIMER:
-                handle_timer_event((nl_event_timer_internal_t *)aEvent);
+                // cleared ahead of taking the list, such that a timer
+                // listed after that kicks the task once more.
+                nl_er_atomic_set(&aShard->mKicked, 0);
+                handle_timer_event(aShard);
                 break;
 
             case NL_EVENT_T_EXIT:
-                sRunning = 0;
+                aShard->mRunning = 0;
                 break;
 
             default:
@@ -319,7 +619,7 @@ static int nl_timer_eventhandler(nl_event_t *aEvent)
     }
     else
     {
-        handle_timer_event(NULL);
+        handle_timer_event(aShard);
     }
 
     return retval;
@@ -334,60 +634,68 @@ static int nl_timer_eventhandler(nl_event_t *aEvent)
  * tasks which expect events are blocked awaiting an event. This is the
  * precondition used prior to advancing time.
  */
-static void handle_expired_events(void)
+static void handle_expired_events(nl_timer_shard_t *aShard)
 {
     nl_event_t * ev;
     do {
-        ev = nleventqueue_get_event_with_timeout(&sQueue, 0);
-        nl_timer_eventhandler(ev);
+        ev = nleventqueue_get_event_with_timeout(&aShard->mQueue, 0);
+        nl_timer_eventhandler(aShard, ev);
     } while (ev || (nleventqueue_sim_count() > 0));
 }
 #endif
 
 static void nl_timer_run_loop(void *aParams)
 {
-    (void) aParams;
-    while (sRunning)
+    nl_timer_shard_t *shard = (nl_timer_shard_t *)aParams;
+
+    while (shard->mRunning)
     {
         nl_event_t *ev;
-        // sTimeoutNative is computed from valuese typically converted from MS
+#if NLER_FEATURE_TIMER_USING_TIMERFD
+        // the timerfd was armed with the absolute deadline, so neither the
+        // tick conversion below nor the time spent since computing
+        // mTimeoutNative applies.
+        ev = nl_timerfd_get_event(&shard->mTimerFd);
+#else
+        // mTimeoutNative is computed from valuese typically converted from MS
         // using nl_time_ms_to_delay_time_ms() already, so we don't want an extra tick
-        // added by nleventqueue_get_event_with_timeout() when we convert sTimeoutNative to ms.
+        // added by nleventqueue_get_event_with_timeout() when we convert mTimeoutNative to ms.
         // So, subtract one tick before the conversion.
-        ev = nleventqueue_get_event_with_timeout(&sQueue, nl_time_native_to_time_ms(sTimeoutNative-1));
+        ev = nleventqueue_get_event_with_timeout(&shard->mQueue, nl_time_native_to_time_ms(shard->mTimeoutNative-1));
+#endif
 
 #if !defined(NLER_FEATURE_SIMULATEABLE_TIME) || !NLER_FEATURE_SIMULATEABLE_TIME
-        nl_timer_eventhandler(ev);
+        nl_timer_eventhandler(shard, ev);
 #else
         sim_time_info_t *sti = nl_get_sim_time_info();
 
         if (ev == (nl_event_t*) nl_get_advance_event())
         {
-            handle_expired_events();
+            handle_expired_events(shard);
 
             while (nl_get_time_native() < sti->advance_time_point)
             {
                 const nl_time_native_t now = nl_get_time_native();
 
-                nl_time_native_t candidate_time = now + sTimeoutNative;
+                nl_time_native_t candidate_time = now + shard->mTimeoutNative;
 
                 if (candidate_time <= sti->advance_time_point)
                 {
-                    sti->real_time_when_paused += sTimeoutNative;
+                    sti->real_time_when_paused += shard->mTimeoutNative;
                 }
                 else
                 {
                     sti->real_time_when_paused += sti->advance_time_point - now;
                 }
 
-                handle_expired_events();
+                handle_expired_events(shard);
             }
 
             nleventqueue_post_event(((nl_event_timer_internal_t*)ev)->mReturnQueue, ev);
         }
         else
         {
-            nl_timer_eventhandler(ev);
+            nl_timer_eventhandler(shard, ev);
         }
 #endif
     }
@@ -395,30 +703,40 @@ static void nl_timer_run_loop(void *aParams)
 
 void nl_timer_start(nltask_priority_t aPriority)
 {
-    int err = nleventqueue_create(sQueueMemory, sizeof(sQueueMemory), &sQueue);
-    NLER_ASSERT(err >= 0);
+    nl_timer_shard_t *shard;
+    unsigned i;
+    int err;
 
     sTimeoutNeverNative = nl_time_ms_to_delay_time_native(NLER_TIMEOUT_NEVER);
-    sTimeoutNative = sTimeoutNeverNative;
-
-    nltask_create(nl_timer_run_loop, "tmr", sTimerStack, sizeof(sTimerStack), aPriority, NULL, &sTimerTask);
 
-#if NLER_FEATURE_SIMULATEABLE_TIME
-    // Create a pool of locks, which we assign at timer_init.  We don't
-    // want to create in timer_init in case anyone ever calls timer_init
-    // more than once per timer, which could cause a leak.
-    unsigned i;
-    for (i = 0; i < NLER_MAX_TIMER_EVENTS; i++)
+    for (i = 0; i < NLER_TIMER_SHARDS; i++)
     {
-        err = nllock_create(&s_lock_list[i]);
+        shard = &sShards[i];
+
+        err = nleventqueue_create(shard->mQueueMemory, sizeof(shard->mQueueMemory), &shard->mQueue);
+        NLER_ASSERT(err >= 0);
+
+#if NLER_FEATURE_TIMER_USING_TIMERFD
+        err = nl_timerfd_init(&shard->mTimerFd, &shard->mQueue);
         NLER_ASSERT(err == NLER_SUCCESS);
-    }
 #endif
+
+        NL_INIT_EVENT(shard->mKick, NL_EVENT_T_TIMER, NULL, NULL);
+
+        shard->mTimeoutNative = sTimeoutNeverNative;
+        shard->mBatchCount = 0;
+        shard->mListed = 0;
+        shard->mKicked = 0;
+        shard->mRunning = 1;
+        nl_timer_wheel_init(&shard->mWheel, nl_get_time_native());
+
+        nltask_create(nl_timer_run_loop, "tmr", sTimerStacks[i], sizeof(sTimerStacks[i]), aPriority, shard, &shard->mTask);
+    }
 }
 
 nleventqueue_t *nl_get_timer_queue(void)
 {
-    return &sQueue;
+    return &sShards[0].mQueue;
 }
 
 #endif /* NLER_FEATURE_TIMER_USING_SWTIMER */
@@ -428,89 +746,43 @@ void nl_event_timer_init(nl_event_timer_t *aTimer, nl_eventhandler_t aHandler, v
     nl_event_timer_internal_t *timer = (nl_event_timer_internal_t*)aTimer;
     NL_INIT_EVENT(*timer, NL_EVENT_T_TIMER, aHandler, aHandlerArg);
     timer->mReturnQueue = aQueue;
-    timer->mRepeating = false;
-    timer->mCancelled = false;
-    timer->mQueuedCount = 0;
-    timer->mIgnoreCount = 0;
+    timer->mState = 0;
+    timer->mOverrunCount = 0;
+    timer->mOverrun = 0;
+    timer->mMode = NL_EVENT_TIMER_ONE_SHOT;
 #if NLER_FEATURE_TIMER_USING_SWTIMER
     nl_swtimer_init(&timer->mTimer, nl_event_timer_function, NULL);
-#endif
-#if NLER_FEATURE_SIMULATEABLE_TIME
-    timer->mLock = NULL;
+#else
+    timer->mWheelLink.mNext = NULL;
+    timer->mWheelLink.mPrev = NULL;
+    timer->mListNext = NULL;
+    timer->mArmedGeneration = 0;
+    timer->mSlackNative = 0;
 #endif
 #ifdef DEBUG
     timer->mTask = NULL;
 #endif
 }
 
-#if NLER_FEATURE_SIMULATEABLE_TIME
-/* This call makes sure that the timer task has run and
- * processed every event sent to it before this task
- * proceeds.  It works by sending a special "timer" event to the
- * timer task where the return event queue is a local one (not the
- * same as the one used for the task normally) and the
- * timer task will post it back to us as soon as it can.
- * We don't use the task's regular event queue
- * to synchronize on because that queue might
- * contain other events not intended for us.  We could use a
- * a special event with a semaphore to signal as well, but
- * semaphores aren't used in nler.
- */
-static void timer_task_barrier(void)
+void nl_event_timer_init_callback(nl_event_timer_t *aTimer, nl_eventhandler_t aHandler, void *aHandlerArg)
 {
-    int err;
-    nl_event_timer_internal_t sync_event;
-    nl_event_t *queue_memory[1];
-    nleventqueue_t barrier_queue;
-    nl_event_t *result;
+    NLER_ASSERT(aHandler != NULL);
 
-    err = nleventqueue_create(queue_memory, sizeof(queue_memory), &barrier_queue);
-    NLER_ASSERT(err >= 0);
-
-    nl_event_timer_init((nl_event_timer_t*)&sync_event, sync_barrier_dummy_function, NULL, &barrier_queue);
-    sync_event.mTimeNow = 0;
-    sync_event.mTimeoutNative = 0;
-
-    err = nleventqueue_post_event(&sQueue, (nl_event_t*)&sync_event);
-    NLER_ASSERT(err >= 0);
-    result = nleventqueue_get_event_with_timeout(&barrier_queue, NLER_TIMEOUT_NEVER);
-    NLER_ASSERT(result == (nl_event_t*)&sync_event);
-
-    nleventqueue_destroy(&barrier_queue);
+    nl_event_timer_init(aTimer, aHandler, aHandlerArg, NULL);
 }
 
-static void lock_timer_from_client_task(nl_event_timer_internal_t *timer)
-{
-    if (timer->mLock == NULL)
-    {
-        // find the lock to use.
-        unsigned i;
-        for (i = 0; i < NLER_MAX_TIMER_EVENTS; i++)
-        {
-            if (s_task_list[i] == NULL)
-            {
-                // task hasn't seen yet, record it
-                s_task_list[i] = timer->mTask;
-                break;
-            }
-            if (s_task_list[i] == timer->mTask)
-            {
-                // task has been seen before
-                break;
-            }
-        }
-        NLER_ASSERT(i < NLER_MAX_TIMER_EVENTS);
-        timer->mLock = &s_lock_list[i];
-    }
-    nllock_enter(timer->mLock);
-}
-#endif
-
-void nl_event_timer_start(nl_event_timer_t *aTimer, nl_time_ms_t aTimeoutMS, bool aRepeating)
+/* Start a timer expiring aDelayMS, or at native time aDeadline, from
+ * now and then every aPeriodMS if it repeats. The swtimer implementation
+ * works from the former and the timer task from the latter.
+ */
+static void start_timer(nl_event_timer_t *aTimer, nl_time_ms_t aDelayMS, nl_time_native_t aDeadline,
+                        nl_time_ms_t aPeriodMS, nl_time_ms_t aSlackMS, nl_event_timer_mode_t aMode)
 {
     nl_event_timer_internal_t *timer = (nl_event_timer_internal_t*)aTimer;
+    intptr_t state;
+    intptr_t updated;
 #if !NLER_FEATURE_TIMER_USING_SWTIMER
-    int err;
+    nl_time_native_t period;
 #endif
 
 #ifdef DEBUG
@@ -524,71 +796,105 @@ void nl_event_timer_start(nl_event_timer_t *aTimer, nl_time_ms_t aTimeoutMS, boo
     }
 #endif
 
-    // cancel in case it was already running
-    nl_event_timer_cancel(aTimer);
+    // stop it in case it was already running; the run parameters below
+    // are then only rewritten while no run is current.
+    stop_timer_run(timer);
 
-#if NLER_FEATURE_SIMULATEABLE_TIME
-    lock_timer_from_client_task(timer);
-#endif
+    timer->mOverrunCount = 0;
+    timer->mOverrun = 0;
+    timer->mMode = aMode;
 
-    // record that all queued events should be ignored so
-    // that nl_event_timer_is_valid() returns false for
-    // all the events currently in the queue.
-    timer->mIgnoreCount = timer->mQueuedCount;
+#if NLER_FEATURE_TIMER_USING_SWTIMER
+    (void)aDeadline;
+    (void)aSlackMS;
 
-    timer->mRepeating = aRepeating;
-    timer->mCancelled = false;
+    (void)nl_swtimer_cancel(&timer->mTimer);
 
-#if NLER_FEATURE_TIMER_USING_SWTIMER
-    // we store the aTimeoutMS as the func arg in case we want repeating behavior.
-    nl_swtimer_init(&timer->mTimer, nl_event_timer_function, (void*)aTimeoutMS);
-    nl_swtimer_start(&timer->mTimer, aTimeoutMS);
+    do
+    {
+        state = timer->mState;
+        updated = next_timer_generation(state) | TIMER_STATE_RUNNING;
+    } while (!cas_timer_state(timer, state, updated));
+
+    // we store the aPeriodMS as the func arg in case we want repeating behavior.
+    nl_swtimer_init(&timer->mTimer, nl_event_timer_function, (void*)aPeriodMS);
+    nl_swtimer_start(&timer->mTimer, aDelayMS);
 #else
-    NLER_ASSERT(sRunning);
-    timer->mTimeNow = nl_get_time_native();
-    timer->mTimeoutNative = nl_time_ms_to_delay_time_native(aTimeoutMS);
-#if NLER_FEATURE_SIMULATEABLE_TIME
-    nllock_exit(timer->mLock);
-#endif
-    // inform the timer task so it can remove the timer from it's list.
-    err = nleventqueue_post_event(&sQueue, (nl_event_t *)timer);
-    NLER_ASSERT(err >= 0);
-#if NLER_FEATURE_SIMULATEABLE_TIME
-    timer_task_barrier();
-#endif
+    (void)aDelayMS;
+
+    // a repeating timer must move on by at least a tick each period.
+    period = nl_time_ms_to_time_native(aPeriodMS);
+
+    if ((aMode != NL_EVENT_TIMER_ONE_SHOT) && (period == 0))
+    {
+        period = 1;
+    }
+
+    timer->mStartNative = aDeadline - period;
+    timer->mTimeoutNative = period;
+    timer->mSlackNative = nl_time_ms_to_time_native(aSlackMS);
+
+    // run it anew and have the timer task arm it, unless it is
+    // already listed for that.
+    do
+    {
+        state = timer->mState;
+        updated = next_timer_generation(state) | TIMER_STATE_RUNNING | TIMER_STATE_LISTED;
+    } while (!cas_timer_state(timer, state, updated));
+
+    if (!(state & TIMER_STATE_LISTED))
+    {
+        list_timer(timer);
+    }
 #endif
 }
 
+void nl_event_timer_start(nl_event_timer_t *aTimer, nl_time_ms_t aTimeoutMS, bool aRepeating)
+{
+    nl_event_timer_start_with_slack(aTimer, aTimeoutMS, 0, aRepeating);
+}
+
+void nl_event_timer_start_with_slack(nl_event_timer_t *aTimer, nl_time_ms_t aTimeoutMS, nl_time_ms_t aSlackMS, bool aRepeating)
+{
+    start_timer(aTimer, aTimeoutMS,
+                nl_get_time_native() + nl_time_ms_to_delay_time_native(aTimeoutMS),
+                aTimeoutMS, aSlackMS, aRepeating ? NL_EVENT_TIMER_REPEAT_SKIP : NL_EVENT_TIMER_ONE_SHOT);
+}
+
+void nl_event_timer_start_at(nl_event_timer_t *aTimer, nl_time_native_t aDeadline, nl_time_ms_t aPeriodMS, nl_event_timer_mode_t aMode)
+{
+    const nl_time_native_t now = nl_get_time_native();
+    nl_time_ms_t delay_ms = 0;
+
+    if ((int32_t)(aDeadline - now) > 0)
+    {
+        delay_ms = nl_time_native_to_time_ms(aDeadline - now);
+    }
+
+    start_timer(aTimer, delay_ms, aDeadline, aPeriodMS, 0, aMode);
+}
+
 void nl_event_timer_cancel(nl_event_timer_t *aTimer)
 {
     nl_event_timer_internal_t *timer = (nl_event_timer_internal_t*)aTimer;
+    intptr_t state;
+    intptr_t updated;
+
+    // any of its events still queued are invalid from here on, as the
+    // timer is no longer running. A run the timer task has armed is
+    // left in its wheel, to be dropped as stale by its generation when
+    // the timer task next passes it.
+    do
+    {
+        state = timer->mState;
+        updated = next_timer_generation(state) & ~TIMER_STATE_RUNNING;
+    } while (!cas_timer_state(timer, state, updated));
 
-#ifdef DEBUG
-    NLER_ASSERT(timer->mTask == NULL || timer->mTask == nltask_get_current());
-#endif
-
-#if NLER_FEATURE_SIMULATEABLE_TIME
-    lock_timer_from_client_task(timer);
-#endif
-    timer->mCancelled = true;
 #if NLER_FEATURE_TIMER_USING_SWTIMER
     // cancel timer immediately so that the timer structure
     // is not referenced after this function call returns,
     // in case the structure is not static
     (void)nl_swtimer_cancel(&timer->mTimer);
-#else // NLER_FEATURE_TIMER_USING_SWTIMER
-    // post to the timer task to have the cancel processed
-    // immediately (the timer task is always higher priority)
-    // so by time we return from this function, we know
-    // the timer is no longer in the sTimers array
-#if !NLER_FEATURE_SIMULATEABLE_TIME
-    NLER_ASSERT(nltask_get_priority(&sTimerTask) > nltask_get_priority(nltask_get_current()));
-#endif
-    nleventqueue_post_event(&sQueue, NULL);
-#if NLER_FEATURE_SIMULATEABLE_TIME
-    nllock_exit(timer->mLock);
-    timer_task_barrier();
-#endif // NLER_FEATURE_SIMULATEABLE_TIME
 #endif // NLER_FEATURE_TIMER_USING_SWTIMER
 }
 
@@ -596,40 +902,61 @@ void nl_event_timer_cancel(nl_event_timer_t *aTimer)
 // received the timer event.  Check if the timer event is still
 // valid, or if it has been cancelled or restarted.  It must be
 // called exactly once per dequeued timer event.
-// A cancelled and not restarted timer can be identified
-// by the mCancelled flag.
+// A cancelled and not restarted timer is no longer running.
 // A timer event on the queue is invalid if it was restarted,
-// so mCancelled is false, but the mIgnoreCount will be > 0.
+// so it is running, but the ignore count will be > 0.
 bool nl_event_timer_is_valid(nl_event_timer_t *aTimer)
 {
     bool retval = false;
     nl_event_timer_internal_t *timer = (nl_event_timer_internal_t*)aTimer;
+    intptr_t state;
+    intptr_t updated;
+    uint16_t overrun = 0;
 
 #ifdef DEBUG
     NLER_ASSERT(timer->mTask == nltask_get_current());
 #endif
 
-#if NLER_FEATURE_SIMULATEABLE_TIME
-    lock_timer_from_client_task(timer);
-#endif
-
-    NLER_ASSERT(timer->mQueuedCount > 0);
-    nl_er_atomic_dec8((int8_t*)&timer->mQueuedCount);
-    if (timer->mIgnoreCount > 0)
+    // only this task raises the ignore count, so an event not to be
+    // ignored now is not once counted off below. Its overruns are
+    // latched before it stops being pending, such that the timer task
+    // never counts one against it that belongs to the next.
+    if (TIMER_IGNORED(timer->mState) == 0)
     {
-        timer->mIgnoreCount--;
+        overrun = (uint16_t)nl_er_atomic_set16((int16_t*)&timer->mOverrunCount, 0);
     }
-    else
+
+    do
     {
-        if (timer->mCancelled == false)
+        state = timer->mState;
+        NLER_ASSERT(TIMER_QUEUED(state) > 0);
+        updated = state - TIMER_STATE_QUEUED_ONE;
+
+        if (TIMER_IGNORED(state) > 0)
         {
-            retval = true;
+            updated -= TIMER_STATE_IGNORE_ONE;
         }
+    } while (!cas_timer_state(timer, state, updated));
+
+    if (TIMER_IGNORED(state) == 0)
+    {
+        retval = ((state & TIMER_STATE_RUNNING) != 0);
     }
-#if NLER_FEATURE_SIMULATEABLE_TIME
-    nllock_exit(timer->mLock);
-#endif
+
+    timer->mOverrun = retval ? overrun : 0;
+
     return retval;
 }
 
+uint32_t nl_event_timer_get_overrun(nl_event_timer_t *aTimer)
+{
+    nl_event_timer_internal_t *timer = (nl_event_timer_internal_t*)aTimer;
+
+#ifdef DEBUG
+    NLER_ASSERT(timer->mTask == nltask_get_current());
+#endif
+
+    return timer->mOverrun;
+}
+
 #endif // NLER_FEATURE_EVENT_TIMER
@@ -82,3 +82,19 @@ uint32_t nl_udiv64_by_1000ULL (uint64_t inDividend)
         reciprocal,
         shiftedDivisor);
 }
+
+/* Mix the bits of the pointer above those that alignment leaves clear,
+ * such that the low bits of the key, and so the bucket, change with
+ * every neighbouring object.
+ */
+
+uint32_t nl_hash_pointer(const void *inPointer, uint32_t inBuckets)
+{
+    uint32_t key = (uint32_t)((uintptr_t)inPointer >> 3);
+
+    key ^= key >> 16;
+    key *= 0x45d9f3b;
+    key ^= key >> 16;
+
+    return key % inBuckets;
+}
@@ -33,11 +33,22 @@
 
 #include "nlercfg.h"
 #include "nlerlog.h"
+#include <stddef.h>
 #include <string.h>
 #include "nlererror.h"
 #include "nlertask.h"
 #include <stdio.h>
 #include "nlerassert.h"
+#include "nlertimerwheel.h"
+
+#if NLER_FEATURE_TIMER_USING_TIMERFD
+#include "nlertimerfd.h"
+
+/* The timerfd tracks real time only */
+#if NLER_FEATURE_SIMULATEABLE_TIME
+#error Cannot use timerfd when doing simulateable time
+#endif
+#endif
 
 #if NLER_FEATURE_SIMULATEABLE_TIME
 #include "nlereventqueue_sim.h"
@@ -59,172 +70,186 @@ DEFINE_STACK(sTimerStack, (NLER_TASK_STACK_BASE + NLER_TIMER_STACK_SIZE));
  * request
  */
 static nl_event_t *sQueueMemory[NLER_MAX_TIMER_EVENTS + 1];
-static nl_event_timer_t *sTimers[NLER_MAX_TIMER_EVENTS];
+static nl_timer_wheel_t sWheel;
 static nleventqueue_t sQueueObj;
 static nleventqueue_t *sQueue; // some unit tests reference this
 static nl_time_native_t sTimeoutNative;
 #if NLER_FEATURE_WAKE_TIMER
+static nl_timer_wheel_link_t sWakeTimers;  // wake timers in the wheel, in no particular order
 static nl_time_native_t sMinWakeTimeNative;
 #endif // NLER_FEATURE_WAKE_TIMER
-static int sEnd = 0;
+#if NLER_FEATURE_TIMER_USING_TIMERFD
+static nl_timerfd_t sTimerFd;
+#endif
 static int sRunning = 1;
 static nl_time_native_t sTimeoutNeverNative;  // Used store nl_time_ms_to_delay_time_native(NLER_TIMEOUT_NEVER);
 
-static void remove_timer(int aIndex)
+#define TIMER_FROM_LINK(l) ((nl_event_timer_t *)((char *)(l) - offsetof(nl_event_timer_t, mWheelLink)))
+
+#if NLER_FEATURE_WAKE_TIMER
+#define TIMER_FROM_WAKE_LINK(l) ((nl_event_timer_t *)((char *)(l) - offsetof(nl_event_timer_t, mWakeLink)))
+
+static void wake_list_remove(nl_event_timer_t *aTimer)
 {
-    if (aIndex != (sEnd - 1))
+    if (aTimer->mWakeLink.mNext != NULL)
     {
-        memmove(&sTimers[aIndex], &sTimers[aIndex + 1],
-                sizeof(nl_event_timer_t *) * (sEnd - (aIndex + 1)));
+        aTimer->mWakeLink.mPrev->mNext = aTimer->mWakeLink.mNext;
+        aTimer->mWakeLink.mNext->mPrev = aTimer->mWakeLink.mPrev;
+        aTimer->mWakeLink.mNext = NULL;
+        aTimer->mWakeLink.mPrev = NULL;
     }
+}
 
-    sEnd--;
+static void wake_list_add(nl_event_timer_t *aTimer)
+{
+    aTimer->mWakeLink.mNext = &sWakeTimers;
+    aTimer->mWakeLink.mPrev = sWakeTimers.mPrev;
+    sWakeTimers.mPrev->mNext = &aTimer->mWakeLink;
+    sWakeTimers.mPrev = &aTimer->mWakeLink;
 }
+#endif // NLER_FEATURE_WAKE_TIMER
 
-static void handle_timer_event(nl_event_timer_t *aEvent)
+static void remove_timer(nl_event_timer_t *aTimer)
 {
-    const nl_time_native_t now = nl_get_time_native();
-    nl_time_native_t newtimeout = sTimeoutNeverNative;
+    nl_timer_wheel_remove(&sWheel, &aTimer->mWheelLink);
 #if NLER_FEATURE_WAKE_TIMER
-    nl_time_native_t newwaketime = sTimeoutNeverNative;
+    wake_list_remove(aTimer);
 #endif // NLER_FEATURE_WAKE_TIMER
-    nl_time_native_t curtimeout = 0;
+}
 
-    int idx = 0;
-    while (idx < sEnd)
+static void add_timer(nl_event_timer_t *aTimer)
+{
+    nl_timer_wheel_add(&sWheel, &aTimer->mWheelLink, aTimer->mTimeNow + aTimer->mTimeoutNative);
+#if NLER_FEATURE_WAKE_TIMER
+    if (aTimer->mFlags & NLER_TIMER_FLAG_WAKE)
     {
-        if (sTimers[idx] == aEvent)
-        {
-            if (sTimers[idx]->mFlags & NLER_TIMER_FLAG_DISPLACE)
-            {
-                nleventqueue_post_event(sTimers[idx]->mReturnQueue, (nl_event_t *)sTimers[idx]);
-            }
-            NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) replaced\n", sTimers[idx], sTimers[idx]->mTimeoutMS);
-            aEvent = NULL;
-        }
-
-        if (sTimers[idx]->mFlags & NLER_TIMER_FLAG_CANCEL_ECHO)
-        {
-            NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) cancelled with echo\n", sTimers[idx], sTimers[idx]->mTimeoutMS);
-            nleventqueue_post_event(sTimers[idx]->mReturnQueue, (nl_event_t *)sTimers[idx]);
-            remove_timer(idx);
-            continue;
-        }
-        else if (sTimers[idx]->mFlags & NLER_TIMER_FLAG_CANCELLED)
-        {
-            NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) cancelled\n", sTimers[idx], sTimers[idx]->mTimeoutMS);
-            remove_timer(idx);
-            continue;
-        }
-
-        if (now - sTimers[idx]->mTimeNow >= sTimers[idx]->mTimeoutNative)
-        {
-            NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) timedout [idx: %d (%u - %u [%u]) >= %u]\n",
-                         sTimers[idx], sTimers[idx]->mTimeoutMS, idx, now, sTimers[idx]->mTimeNow,
-                         now - sTimers[idx]->mTimeNow, sTimers[idx]->mTimeoutNative);
+        wake_list_add(aTimer);
+    }
+#endif // NLER_FEATURE_WAKE_TIMER
+}
 
-            nleventqueue_post_event(sTimers[idx]->mReturnQueue, (nl_event_t *)sTimers[idx]);
+/* Wheel expiry callback. Cancellation only sets a flag in the timer,
+ * so a cancelled timer is only noticed, and dropped, here.
+ */
+static void expire_timer(nl_timer_wheel_link_t *aLink, void *aClosure)
+{
+    nl_event_timer_t *timer = TIMER_FROM_LINK(aLink);
+    const nl_time_native_t now = *(const nl_time_native_t *)aClosure;
 
-            if (sTimers[idx]->mFlags & NLER_TIMER_FLAG_REPEAT)
-            {
-                nl_event_timer_t *timer = sTimers[idx];
-
-                NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) will repeat\n", timer, timer->mTimeoutMS);
-
-                /**
-                 * NOTE: It's necessary to correct the value of mTimeoutNative
-                 * for repeat timers.
-                 *
-                 * nl_init_event_timer() uses nl_time_ms_to_delay_time_native()
-                 * to compute aTimer->mTimeoutNative, which adds an extra tick
-                 * to guarantee at *least* aTimeoutMS milliseconds transpire
-                 * before the first timeout.
-                 *
-                 * Without fixing aTimer->mTimeoutNative the extra tick impacts
-                 * all subsequent timeouts.
-                 */
-
-                timer->mTimeNow = now;
-                timer->mTimeoutNative = nl_time_ms_to_time_native(timer->mTimeoutMS);
-            }
-            else
-            {
-                remove_timer(idx);
-                continue;
-            }
-        }
 #if NLER_FEATURE_WAKE_TIMER
-        NL_LOG_DEBUG(lrERTIMER, "timer: %s timer %p (%d) participates in timeout computation\n",
-                (sTimers[idx]->mFlags & NLER_TIMER_FLAG_WAKE) ? "wake" : "", sTimers[idx], sTimers[idx]->mTimeoutMS);
-#else
-        NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) participates in timeout computation\n",
-                sTimers[idx], sTimers[idx]->mTimeoutMS);
+    wake_list_remove(timer);
 #endif // NLER_FEATURE_WAKE_TIMER
 
-        curtimeout = sTimers[idx]->mTimeNow + sTimers[idx]->mTimeoutNative - now;
+    if (timer->mFlags & NLER_TIMER_FLAG_CANCEL_ECHO)
+    {
+        NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) cancelled with echo\n", timer, timer->mTimeoutMS);
+        nleventqueue_post_event(timer->mReturnQueue, (nl_event_t *)timer);
+        return;
+    }
+    else if (timer->mFlags & NLER_TIMER_FLAG_CANCELLED)
+    {
+        NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) cancelled\n", timer, timer->mTimeoutMS);
+        return;
+    }
 
-        if (curtimeout < newtimeout)
-            newtimeout = curtimeout;
+    NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) timedout [(%u - %u [%u]) >= %u]\n",
+                 timer, timer->mTimeoutMS, now, timer->mTimeNow,
+                 now - timer->mTimeNow, timer->mTimeoutNative);
 
-#if NLER_FEATURE_WAKE_TIMER
-        if (sTimers[idx]->mFlags & NLER_TIMER_FLAG_WAKE)
-        {
-            nl_time_native_t curwaketime = sTimers[idx]->mTimeNow + sTimers[idx]->mTimeoutNative;
+    nleventqueue_post_event(timer->mReturnQueue, (nl_event_t *)timer);
 
-            if (curwaketime < newwaketime)
-            {
-                newwaketime = curwaketime;
-            }
+    if (timer->mFlags & NLER_TIMER_FLAG_REPEAT)
+    {
+        NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) will repeat\n", timer, timer->mTimeoutMS);
+
+        /**
+         * NOTE: It's necessary to correct the value of mTimeoutNative
+         * for repeat timers.
+         *
+         * nl_init_event_timer() uses nl_time_ms_to_delay_time_native()
+         * to compute aTimer->mTimeoutNative, which adds an extra tick
+         * to guarantee at *least* aTimeoutMS milliseconds transpire
+         * before the first timeout.
+         *
+         * Without fixing aTimer->mTimeoutNative the extra tick impacts
+         * all subsequent timeouts.
+         *
+         * A period shorter than a tick is stretched to one such that
+         * the timer cannot expire again within the same pass.
+         */
+
+        timer->mTimeNow = now;
+        timer->mTimeoutNative = nl_time_ms_to_time_native(timer->mTimeoutMS);
+
+        if (timer->mTimeoutNative == 0)
+        {
+            timer->mTimeoutNative = 1;
         }
-#endif // NLER_FEATURE_WAKE_TIMER
-        idx++;
+
+        add_timer(timer);
     }
+}
+
+static void handle_timer_event(nl_event_timer_t *aEvent)
+{
+    nl_time_native_t now = nl_get_time_native();
+    nl_time_native_t next;
+#if NLER_FEATURE_WAKE_TIMER
+    nl_time_native_t newwaketime = sTimeoutNeverNative;
+    nl_timer_wheel_link_t *link;
+#endif // NLER_FEATURE_WAKE_TIMER
 
     if (aEvent != NULL)
     {
+        if (nl_timer_wheel_is_pending(&aEvent->mWheelLink))
+        {
+            if (aEvent->mFlags & NLER_TIMER_FLAG_DISPLACE)
+            {
+                nleventqueue_post_event(aEvent->mReturnQueue, (nl_event_t *)aEvent);
+            }
+            NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) replaced\n", aEvent, aEvent->mTimeoutMS);
 
-        NLER_ASSERT(sEnd < NLER_MAX_TIMER_EVENTS);
+            remove_timer(aEvent);
+        }
 
         NL_LOG_DEBUG(lrERTIMER, "timer: timer %p (%d) added\n", aEvent, aEvent->mTimeoutMS);
 
-        sTimers[sEnd++] = aEvent;
+        add_timer(aEvent);
+    }
 
-        if (now - aEvent->mTimeNow < aEvent->mTimeoutNative)
-        {
-            curtimeout = aEvent->mTimeNow + aEvent->mTimeoutNative - now;
-        }
-        else
-        {
-            // the timer is already expired. Set curtimeout = 0 to avoid
-            // assigning a negative value to an unsigned.
-            curtimeout = 0;
-        }
+    nl_timer_wheel_advance(&sWheel, now, expire_timer, &now);
 
-        if (curtimeout < newtimeout)
-        {
-            newtimeout = curtimeout;
-        }
+    if (nl_timer_wheel_next(&sWheel, &next))
+    {
+        sTimeoutNative = ((int32_t)(next - now) > 0) ? (next - now) : 0;
+#if NLER_FEATURE_TIMER_USING_TIMERFD
+        nl_timerfd_arm(&sTimerFd, next);
+#endif
+    }
+    else
+    {
+        sTimeoutNative = sTimeoutNeverNative;
+#if NLER_FEATURE_TIMER_USING_TIMERFD
+        nl_timerfd_disarm(&sTimerFd);
+#endif
+    }
 
 #if NLER_FEATURE_WAKE_TIMER
-        if (aEvent->mFlags & NLER_TIMER_FLAG_WAKE)
-        {
-            nl_time_native_t curwaketime = (nl_time_native_t)(aEvent->mTimeNow + aEvent->mTimeoutNative);
+    for (link = sWakeTimers.mNext; link != &sWakeTimers; link = link->mNext)
+    {
+        nl_event_timer_t *timer = TIMER_FROM_WAKE_LINK(link);
+        nl_time_native_t curwaketime = timer->mTimeNow + timer->mTimeoutNative;
 
-            if (curwaketime < newwaketime)
-            {
-                newwaketime = curwaketime;
-            }
+        if (curwaketime < newwaketime)
+        {
+            newwaketime = curwaketime;
         }
-#endif
     }
-  
 
-    sTimeoutNative = newtimeout;
-#if NLER_FEATURE_WAKE_TIMER
     sMinWakeTimeNative = newwaketime;
 #endif // NLER_FEATURE_WAKE_TIMER
 
-    NL_LOG_DEBUG(lrERTIMER, "timer: new timeout: %d\n", nl_time_native_to_time_ms(newtimeout));
+    NL_LOG_DEBUG(lrERTIMER, "timer: new timeout: %d\n", nl_time_native_to_time_ms(sTimeoutNative));
 }
 
 static int nl_timer_eventhandler(nl_event_t *aEvent)
@@ -281,9 +306,15 @@ static void nl_timer_run_loop(void *aParams)
     while (sRunning)
     {
         nl_event_t *ev;
+#if NLER_FEATURE_TIMER_USING_TIMERFD
+        // the timerfd was armed with the absolute deadline, so the time
+        // spent since computing sTimeoutNative does not push it back.
+        ev = nl_timerfd_get_event(&sTimerFd);
+#else
         nl_event_t *nleventqueue_get_event_with_timeout_native(nleventqueue_t *aEventQueue, nl_time_native_t aTimeoutNative);
 
         ev = nleventqueue_get_event_with_timeout_native(sQueue, sTimeoutNative);
+#endif
 
 #if !defined(NLER_FEATURE_SIMULATEABLE_TIME) || !NLER_FEATURE_SIMULATEABLE_TIME
         nl_timer_eventhandler(ev);
@@ -342,7 +373,10 @@ static void timer_init(void)
 {
     sTimeoutNeverNative = nl_time_ms_to_delay_time_native(NLER_TIMEOUT_NEVER);
     sTimeoutNative = sTimeoutNeverNative;
+    nl_timer_wheel_init(&sWheel, nl_get_time_native());
 #if NLER_FEATURE_WAKE_TIMER
+    sWakeTimers.mNext = &sWakeTimers;
+    sWakeTimers.mPrev = &sWakeTimers;
     sMinWakeTimeNative = sTimeoutNeverNative;
 #endif // NLER_FEATURE_WAKE_TIMER
 }
@@ -353,6 +387,11 @@ nleventqueue_t *nl_timer_start(nltask_priority_t aPriority)
     NLER_ASSERT(err >= 0);
     sQueue = &sQueueObj;
 
+#if NLER_FEATURE_TIMER_USING_TIMERFD
+    err = nl_timerfd_init(&sTimerFd, sQueue);
+    NLER_ASSERT(err == NLER_SUCCESS);
+#endif
+
     timer_init();
 
     nltask_create(nl_timer_run_loop, "tmr", sTimerStack, sizeof(sTimerStack), aPriority, NULL, &sTimerTask);
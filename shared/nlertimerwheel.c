@@ -0,0 +1,348 @@
+/*
+ *
+ *    Copyright (c) 2026 Project nler Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements NLER build platform-independent timer
+ *      wheels.
+ *
+ *      A timer at level k of the wheel lies in the slot of the
+ *      2^(k * NLER_TIMER_WHEEL_SLOT_BITS) tick bucket holding its expiry,
+ *      the lowest level at which that bucket is less than a full
+ *      revolution ahead of the current tick. When the current tick
+ *      reaches the start of a bucket with timers in it, they are added
+ *      again and so fall to a lower level.
+ *
+ */
+
+#include "nlertimerwheel.h"
+
+#include <stddef.h>
+
+#define kWheelBits              NLER_TIMER_WHEEL_SLOT_BITS
+#define kWheelMask              ((uint32_t)NLER_TIMER_WHEEL_SLOTS - 1)
+#define kWheelShift(level)      ((level) * kWheelBits)
+
+#if kWheelShift(NLER_TIMER_WHEEL_LEVELS - 1) >= 32
+#error NLER_TIMER_WHEEL_LEVELS is too large for NLER_TIMER_WHEEL_SLOT_BITS
+#endif
+
+/* number of level buckets from that of aFrom to that of aTo, modulo
+ * the number of buckets in the native time range.
+ */
+static uint32_t nl_timer_wheel_distance(nl_time_native_t aFrom, nl_time_native_t aTo, unsigned aLevel)
+{
+    const unsigned shift = kWheelShift(aLevel);
+
+    return ((aTo >> shift) - (aFrom >> shift)) & (UINT32_MAX >> shift);
+}
+
+static void nl_timer_wheel_slot_init(nl_timer_wheel_link_t *aSlot)
+{
+    aSlot->mNext = aSlot;
+    aSlot->mPrev = aSlot;
+}
+
+static bool nl_timer_wheel_slot_is_empty(const nl_timer_wheel_link_t *aSlot)
+{
+    return (aSlot->mNext == aSlot);
+}
+
+/* move the contents of a slot to another, empty, list head.
+ */
+static void nl_timer_wheel_slot_take(nl_timer_wheel_link_t *aSlot, nl_timer_wheel_link_t *aList)
+{
+    if (nl_timer_wheel_slot_is_empty(aSlot))
+    {
+        nl_timer_wheel_slot_init(aList);
+    }
+    else
+    {
+        aList->mNext        = aSlot->mNext;
+        aList->mPrev        = aSlot->mPrev;
+        aList->mNext->mPrev = aList;
+        aList->mPrev->mNext = aList;
+
+        nl_timer_wheel_slot_init(aSlot);
+    }
+}
+
+static void nl_timer_wheel_unlink(nl_timer_wheel_link_t *aLink)
+{
+    aLink->mPrev->mNext = aLink->mNext;
+    aLink->mNext->mPrev = aLink->mPrev;
+
+    aLink->mNext = NULL;
+    aLink->mPrev = NULL;
+}
+
+static void nl_timer_wheel_insert(nl_timer_wheel_t *aWheel, nl_timer_wheel_link_t *aLink)
+{
+    nl_timer_wheel_link_t   *slot;
+    uint32_t                distance;
+    unsigned                level;
+    unsigned                index;
+
+    if ((int32_t)(aLink->mExpires - aWheel->mCurrent) < 0)
+    {
+        // overdue; it expires with the next tick processed.
+
+        level = 0;
+        index = aWheel->mCurrent & kWheelMask;
+    }
+    else
+    {
+        for (level = 0; level < (NLER_TIMER_WHEEL_LEVELS - 1); level++)
+        {
+            if (nl_timer_wheel_distance(aWheel->mCurrent, aLink->mExpires, level) <= kWheelMask)
+                break;
+        }
+
+        distance = nl_timer_wheel_distance(aWheel->mCurrent, aLink->mExpires, level);
+
+        // beyond the reach of the wheel; park the timer in the last
+        // bucket of the top level to be looked at again from there.
+
+        if (distance > kWheelMask)
+            distance = kWheelMask;
+
+        index = ((aWheel->mCurrent >> kWheelShift(level)) + distance) & kWheelMask;
+    }
+
+    slot = &aWheel->mSlots[level][index];
+
+    aLink->mNext        = slot;
+    aLink->mPrev        = slot->mPrev;
+    slot->mPrev->mNext  = aLink;
+    slot->mPrev         = aLink;
+
+    aWheel->mOccupied[level] |= ((uint64_t)1 << index);
+}
+
+/* the distance in ticks to the next tick with timers to expire or
+ * cascade at a level, given that the level has some.
+ */
+static uint32_t nl_timer_wheel_level_next(const nl_timer_wheel_t *aWheel, unsigned aLevel)
+{
+    const unsigned  shift   = kWheelShift(aLevel);
+    const unsigned  current = (aWheel->mCurrent >> shift) & kWheelMask;
+    uint64_t        occupied;
+    uint32_t        distance;
+
+    // rotate such that bit 0 is the slot of the current bucket.
+
+    occupied = aWheel->mOccupied[aLevel];
+
+    if (current != 0)
+    {
+        occupied = (occupied >> current) | (occupied << (NLER_TIMER_WHEEL_SLOTS - current));
+    }
+
+    distance = (uint32_t)__builtin_ctzll(occupied) & kWheelMask;
+
+    if (distance == 0)
+    {
+        // only the lowest level keeps timers in the current bucket,
+        // but the bucket of a higher level has yet to be cascaded when
+        // the current tick is its first.
+
+        return 0;
+    }
+
+    return ((((aWheel->mCurrent >> shift) + distance) << shift) - aWheel->mCurrent);
+}
+
+/* process the tick at mCurrent: cascade the buckets starting with it,
+ * then expire those timers due at it.
+ */
+static void nl_timer_wheel_tick(nl_timer_wheel_t *aWheel, nl_timer_wheel_expire_t aExpire, void *aClosure)
+{
+    nl_timer_wheel_link_t   list;
+    nl_timer_wheel_link_t   *link;
+    unsigned                level;
+    unsigned                index;
+
+    for (level = NLER_TIMER_WHEEL_LEVELS - 1; level > 0; level--)
+    {
+        if ((aWheel->mCurrent & ((1UL << kWheelShift(level)) - 1)) != 0)
+            continue;
+
+        index = (aWheel->mCurrent >> kWheelShift(level)) & kWheelMask;
+
+        if ((aWheel->mOccupied[level] & ((uint64_t)1 << index)) == 0)
+            continue;
+
+        nl_timer_wheel_slot_take(&aWheel->mSlots[level][index], &list);
+
+        aWheel->mOccupied[level] &= ~((uint64_t)1 << index);
+
+        while (!nl_timer_wheel_slot_is_empty(&list))
+        {
+            link = list.mNext;
+
+            nl_timer_wheel_unlink(link);
+            nl_timer_wheel_insert(aWheel, link);
+        }
+    }
+
+    index = aWheel->mCurrent & kWheelMask;
+
+    nl_timer_wheel_slot_take(&aWheel->mSlots[0][index], &list);
+
+    aWheel->mOccupied[0] &= ~((uint64_t)1 << index);
+    aWheel->mCurrent++;
+
+    // the expiry callback may add and remove timers, this one
+    // included, so the list is unlinked one timer at a time.
+
+    while (!nl_timer_wheel_slot_is_empty(&list))
+    {
+        link = list.mNext;
+
+        nl_timer_wheel_unlink(link);
+
+        aWheel->mCount--;
+
+        aExpire(link, aClosure);
+    }
+}
+
+void nl_timer_wheel_init(nl_timer_wheel_t *aWheel, nl_time_native_t aNow)
+{
+    unsigned level;
+    unsigned index;
+
+    for (level = 0; level < NLER_TIMER_WHEEL_LEVELS; level++)
+    {
+        for (index = 0; index < NLER_TIMER_WHEEL_SLOTS; index++)
+        {
+            nl_timer_wheel_slot_init(&aWheel->mSlots[level][index]);
+        }
+
+        aWheel->mOccupied[level] = 0;
+    }
+
+    aWheel->mCurrent = aNow;
+    aWheel->mCount   = 0;
+}
+
+void nl_timer_wheel_add(nl_timer_wheel_t *aWheel, nl_timer_wheel_link_t *aLink, nl_time_native_t aExpires)
+{
+    nl_timer_wheel_remove(aWheel, aLink);
+
+    aLink->mExpires = aExpires;
+
+    nl_timer_wheel_insert(aWheel, aLink);
+
+    aWheel->mCount++;
+}
+
+void nl_timer_wheel_remove(nl_timer_wheel_t *aWheel, nl_timer_wheel_link_t *aLink)
+{
+    const uintptr_t         first = (uintptr_t)&aWheel->mSlots[0][0];
+    const uintptr_t         last  = (uintptr_t)&aWheel->mSlots[NLER_TIMER_WHEEL_LEVELS - 1][kWheelMask];
+    nl_timer_wheel_link_t   *slot;
+    size_t                  offset;
+
+    if (!nl_timer_wheel_is_pending(aLink))
+        return;
+
+    slot = aLink->mPrev;
+
+    nl_timer_wheel_unlink(aLink);
+
+    aWheel->mCount--;
+
+    // the timer was the last of its slot if the slot is left empty,
+    // in which case the slot is no longer occupied.
+
+    if (((uintptr_t)slot >= first) && ((uintptr_t)slot <= last) && nl_timer_wheel_slot_is_empty(slot))
+    {
+        offset = (size_t)(slot - &aWheel->mSlots[0][0]);
+
+        aWheel->mOccupied[offset / NLER_TIMER_WHEEL_SLOTS] &= ~((uint64_t)1 << (offset % NLER_TIMER_WHEEL_SLOTS));
+    }
+}
+
+bool nl_timer_wheel_is_pending(const nl_timer_wheel_link_t *aLink)
+{
+    return (aLink->mNext != NULL);
+}
+
+void nl_timer_wheel_advance(nl_timer_wheel_t *aWheel, nl_time_native_t aNow, nl_timer_wheel_expire_t aExpire, void *aClosure)
+{
+    nl_time_native_t next;
+
+    while (nl_timer_wheel_next(aWheel, &next) && ((int32_t)(aNow - next) >= 0))
+    {
+        aWheel->mCurrent = next;
+
+        nl_timer_wheel_tick(aWheel, aExpire, aClosure);
+    }
+
+    // nothing is due before the next tick, so those up to it need not
+    // be visited.
+
+    if ((int32_t)((aNow + 1) - aWheel->mCurrent) > 0)
+    {
+        aWheel->mCurrent = aNow + 1;
+    }
+}
+
+bool nl_timer_wheel_next(nl_timer_wheel_t *aWheel, nl_time_native_t *aTime)
+{
+    uint32_t    distance;
+    uint32_t    nearest = UINT32_MAX;
+    unsigned    level;
+
+    if (aWheel->mCount == 0)
+        return false;
+
+    for (level = 0; level < NLER_TIMER_WHEEL_LEVELS; level++)
+    {
+        if (aWheel->mOccupied[level] == 0)
+            continue;
+
+        distance = nl_timer_wheel_level_next(aWheel, level);
+
+        if (distance < nearest)
+            nearest = distance;
+    }
+
+    *aTime = aWheel->mCurrent + nearest;
+
+    return true;
+}
+
+nl_time_native_t nl_timer_wheel_apply_slack(nl_time_native_t aExpires, nl_time_native_t aSlack)
+{
+    nl_time_native_t    limit = aExpires + aSlack;
+    nl_time_native_t    differ = aExpires ^ limit;
+    nl_time_native_t    mask;
+
+    if (differ == 0)
+        return aExpires;
+
+    // every bit below the highest one in which the two ends of the
+    // window differ can be cleared from the later end without leaving
+    // the window.
+
+    mask = (nl_time_native_t)(UINT32_MAX >> __builtin_clz(differ)) >> 1;
+
+    return limit & ~mask;
+}
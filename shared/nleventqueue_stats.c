@@ -0,0 +1,60 @@
+/*
+ *
+ *    Copyright (c) 2026 Project nler Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements NLER build platform-independent event queue
+ *      statistics accounting.
+ *
+ */
+
+#include "nlereventqueue_stats.h"
+
+#if NLER_EVENTQUEUE_STATS
+
+void nleventqueue_stats_record_post(nleventqueue_stats_t *aStats, size_t aDepth)
+{
+    aStats->mPosts++;
+
+    if (aDepth > aStats->mPeakDepth)
+    {
+        aStats->mPeakDepth = (uint32_t)aDepth;
+    }
+}
+
+void nleventqueue_stats_record_get(nleventqueue_stats_t *aStats, uint32_t aSojournUS)
+{
+    size_t bucket = 0;
+
+    // bucket i holds [2^(i-1), 2^i), so the bucket is the bit length
+
+    if (aSojournUS != 0)
+    {
+        bucket = (sizeof (aSojournUS) * 8) - __builtin_clz(aSojournUS);
+    }
+
+    if (bucket >= NLER_EVENTQUEUE_SOJOURN_BUCKETS)
+    {
+        bucket = NLER_EVENTQUEUE_SOJOURN_BUCKETS - 1;
+    }
+
+    aStats->mGets++;
+    aStats->mSojournHistogram[bucket]++;
+}
+
+#endif
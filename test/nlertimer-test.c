@@ -84,7 +84,7 @@
 #endif
 
 nl_event_t *sQueueMemory[8];
-nl_eventqueue_t sQueue;
+nleventqueue_t sQueue;
 
 #if NLER_FEATURE_TIMER_USING_SWTIMER
 extern bool g_swtimer_prevent_sleep;
@@ -98,13 +98,13 @@ static void Test_one(nlTestSuite *inSuite, void *inContext)
     nl_event_timer_t timer1;
     nl_event_t *receivedEvent;
 
-    nl_event_timer_init(&timer1, NULL, NULL, sQueue);
+    nl_event_timer_init(&timer1, NULL, NULL, &sQueue);
 
     printf("\nTest one event timer ----\n");
     start_time_native = nl_get_time_native();
 
     nl_event_timer_start(&timer1, TIMER1_TIMEOUT_MS, false);
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, TIMER1_TIMEOUT_MS * 2);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, TIMER1_TIMEOUT_MS * 2);
     end_time_native = nl_get_time_native();
     elapsed_time_native = end_time_native - start_time_native;
     NL_TEST_ASSERT(inSuite, receivedEvent == (nl_event_t*)&timer1);
@@ -113,7 +113,7 @@ static void Test_one(nlTestSuite *inSuite, void *inContext)
     TIMER_ACCURACY_TEST_ASSERT(inSuite, elapsed_time_native <= (nl_time_ms_to_delay_time_native(TIMER1_TIMEOUT_MS) + TIMER_TIMEOUT_TOLERANCE_TIME));
 
     // check no more events
-    NL_TEST_ASSERT(inSuite, nl_eventqueue_get_event_with_timeout(sQueue, 0) == NULL);
+    NL_TEST_ASSERT(inSuite, nleventqueue_get_event_with_timeout(&sQueue, 0) == NULL);
 }
 
 /* Test four timers with different timeouts and verify:
@@ -140,10 +140,10 @@ static void Test_four(nlTestSuite *inSuite, void *inContext)
     __attribute__((unused)) nl_time_native_t timer4_expected_time_native_max;
     nl_event_t *receivedEvent;
 
-    nl_event_timer_init(&timer1, NULL, NULL, sQueue);
-    nl_event_timer_init(&timer2, NULL, NULL, sQueue);
-    nl_event_timer_init(&timer3, NULL, NULL, sQueue);
-    nl_event_timer_init(&timer4, NULL, NULL, sQueue);
+    nl_event_timer_init(&timer1, NULL, NULL, &sQueue);
+    nl_event_timer_init(&timer2, NULL, NULL, &sQueue);
+    nl_event_timer_init(&timer3, NULL, NULL, &sQueue);
+    nl_event_timer_init(&timer4, NULL, NULL, &sQueue);
 
     printf("\nTest four event timers ----\n");
 
@@ -164,7 +164,7 @@ static void Test_four(nlTestSuite *inSuite, void *inContext)
     timer3_expected_time_native_max = timer3_expected_time_native_min + 2*TIMER_TIMEOUT_TOLERANCE_TIME;
     timer4_expected_time_native_max = timer4_expected_time_native_min + 2*TIMER_TIMEOUT_TOLERANCE_TIME;
 
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, portMAX_DELAY);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, NLER_TIMEOUT_NEVER);
     end_time_native = nl_get_time_native();
     NL_TEST_ASSERT(inSuite, receivedEvent == (nl_event_t*)&timer1);
     NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer1) == true);
@@ -173,7 +173,7 @@ static void Test_four(nlTestSuite *inSuite, void *inContext)
     TIMER_ACCURACY_TEST_ASSERT(inSuite, ((end_time_native >= timer1_expected_time_native_min) &&
                                          (end_time_native <= timer1_expected_time_native_max)));
 
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, portMAX_DELAY);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, NLER_TIMEOUT_NEVER);
     end_time_native = nl_get_time_native();
     NL_TEST_ASSERT(inSuite, receivedEvent == (nl_event_t*)&timer2);
     NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer2) == true);
@@ -182,7 +182,7 @@ static void Test_four(nlTestSuite *inSuite, void *inContext)
     TIMER_ACCURACY_TEST_ASSERT(inSuite, ((end_time_native >= timer2_expected_time_native_min) &&
                                          (end_time_native <= timer2_expected_time_native_max)));
 
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, portMAX_DELAY);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, NLER_TIMEOUT_NEVER);
     end_time_native = nl_get_time_native();
     NL_TEST_ASSERT(inSuite, receivedEvent == (nl_event_t*)&timer3);
     NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer3) == true);
@@ -191,7 +191,7 @@ static void Test_four(nlTestSuite *inSuite, void *inContext)
     TIMER_ACCURACY_TEST_ASSERT(inSuite, ((end_time_native >= timer3_expected_time_native_min) &&
                                          (end_time_native <= timer3_expected_time_native_max)));
 
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, portMAX_DELAY);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, NLER_TIMEOUT_NEVER);
     end_time_native = nl_get_time_native();
     NL_TEST_ASSERT(inSuite, receivedEvent == (nl_event_t*)&timer4);
     NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer4) == true);
@@ -201,7 +201,7 @@ static void Test_four(nlTestSuite *inSuite, void *inContext)
                                          (end_time_native <= timer4_expected_time_native_max)));
 
     // check no more events
-    NL_TEST_ASSERT(inSuite, nl_eventqueue_get_event_with_timeout(sQueue, 0) == NULL);
+    NL_TEST_ASSERT(inSuite, nleventqueue_get_event_with_timeout(&sQueue, 0) == NULL);
 }
 
 /* Test two timers with one cancelled with echo:
@@ -221,8 +221,8 @@ static void Test_cancel(nlTestSuite *inSuite, void *inContext)
     __attribute__((unused)) nl_time_native_t timer2_expected_time_native_max;
     nl_event_t *receivedEvent;
 
-    nl_event_timer_init(&timer1, NULL, NULL, sQueue);
-    nl_event_timer_init(&timer2, NULL, NULL, sQueue);
+    nl_event_timer_init(&timer1, NULL, NULL, &sQueue);
+    nl_event_timer_init(&timer2, NULL, NULL, &sQueue);
 
     printf("\nTest cancel event timer ----\n");
 
@@ -238,11 +238,11 @@ static void Test_cancel(nlTestSuite *inSuite, void *inContext)
     timer2_expected_time_native_max = timer2_expected_time_native_min + 2*TIMER_TIMEOUT_TOLERANCE_TIME;
 
     // should not have any events in the queue
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, 0);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, 0);
     NL_TEST_ASSERT(inSuite, receivedEvent == NULL);
 
     // wait for timer2
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, portMAX_DELAY);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, NLER_TIMEOUT_NEVER);
     end_time_native = nl_get_time_native();
     NL_TEST_ASSERT(inSuite, receivedEvent == (nl_event_t*)&timer2);
     NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer2) == true);
@@ -252,7 +252,7 @@ static void Test_cancel(nlTestSuite *inSuite, void *inContext)
                                          (end_time_native <= timer2_expected_time_native_max)));
 
     // check no more events
-    NL_TEST_ASSERT(inSuite, nl_eventqueue_get_event_with_timeout(sQueue, 0) == NULL);
+    NL_TEST_ASSERT(inSuite, nleventqueue_get_event_with_timeout(&sQueue, 0) == NULL);
 }
 
 static void Test_resend(nlTestSuite *inSuite, void *inContext)
@@ -264,20 +264,20 @@ static void Test_resend(nlTestSuite *inSuite, void *inContext)
     nl_event_timer_t timer1;
     nl_event_t *receivedEvent;
 
-    nl_event_timer_init(&timer1, NULL, NULL, sQueue);
+    nl_event_timer_init(&timer1, NULL, NULL, &sQueue);
 
     printf("\nTest starting already running event timer ----\n");
     start_time_native = nl_get_time_native();
     // start timer
     nl_event_timer_start(&timer1, TIMER_TIMEOUT_1000_MS, false);
-    nl_task_sleep_ms(TIMER_TIMEOUT_500_MS);
+    nltask_sleep_ms(TIMER_TIMEOUT_500_MS);
     // restart timer with same timeout, but reset to current time
     nl_event_timer_start(&timer1, TIMER_TIMEOUT_1000_MS, false);
     // since we restarted before timer ran, should have no events
     // in the queue
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, 0);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, 0);
     NL_TEST_ASSERT(inSuite, receivedEvent == NULL);
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, portMAX_DELAY);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, NLER_TIMEOUT_NEVER);
     end_time_native = nl_get_time_native();
     expected_end_time_native_min = start_time_native + nl_time_ms_to_delay_time_native(TIMER_TIMEOUT_1000_MS + TIMER_TIMEOUT_500_MS) - TIMER_TIMEOUT_TOLERANCE_TIME;
     expected_end_time_native_max = expected_end_time_native_min + 2*TIMER_TIMEOUT_TOLERANCE_TIME;
@@ -287,7 +287,7 @@ static void Test_resend(nlTestSuite *inSuite, void *inContext)
                                          (end_time_native <= expected_end_time_native_max)));
     NL_TEST_ASSERT(inSuite, receivedEvent == (nl_event_t*)&timer1);
     NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer1) == true);
-    NL_TEST_ASSERT(inSuite, nl_eventqueue_get_event_with_timeout(sQueue, 0) == NULL);
+    NL_TEST_ASSERT(inSuite, nleventqueue_get_event_with_timeout(&sQueue, 0) == NULL);
 }
 
 static void Test_resend_cancel(nlTestSuite *inSuite, void *inContext)
@@ -299,24 +299,24 @@ static void Test_resend_cancel(nlTestSuite *inSuite, void *inContext)
     nl_event_timer_t timer1;
     nl_event_t *receivedEvent;
 
-    nl_event_timer_init(&timer1, NULL, NULL, sQueue);
+    nl_event_timer_init(&timer1, NULL, NULL, &sQueue);
 
     printf("\nTest start, cancel, start event timer ----\n");
 
     start_time_native = nl_get_time_native();
     // start timer
     nl_event_timer_start(&timer1, TIMER_TIMEOUT_1000_MS, false);
-    nl_task_sleep_ms(TIMER_TIMEOUT_500_MS);
+    nltask_sleep_ms(TIMER_TIMEOUT_500_MS);
     // cancel before restarting while timer has not run yet
     nl_event_timer_cancel(&timer1);
     // restart timer with same timeout, but reset to current time
     nl_event_timer_start(&timer1, TIMER_TIMEOUT_1000_MS, false);
     // since we cancelled before timer ran, should have no events
     // in the queue
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, 0);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, 0);
     NL_TEST_ASSERT(inSuite, receivedEvent == NULL);
     // check for second timer event, which should be valid
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, portMAX_DELAY);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, NLER_TIMEOUT_NEVER);
     end_time_native = nl_get_time_native();
     expected_end_time_native_min = start_time_native + nl_time_ms_to_delay_time_native(TIMER_TIMEOUT_1000_MS + TIMER_TIMEOUT_500_MS) - TIMER_TIMEOUT_TOLERANCE_TIME;
     expected_end_time_native_max = expected_end_time_native_min + 2*TIMER_TIMEOUT_TOLERANCE_TIME;
@@ -326,12 +326,12 @@ static void Test_resend_cancel(nlTestSuite *inSuite, void *inContext)
                                          (end_time_native <= expected_end_time_native_max)));
     NL_TEST_ASSERT(inSuite, receivedEvent == (nl_event_t*)&timer1);
     NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer1) == true);
-    NL_TEST_ASSERT(inSuite, nl_eventqueue_get_event_with_timeout(sQueue, 0) == NULL);
+    NL_TEST_ASSERT(inSuite, nleventqueue_get_event_with_timeout(&sQueue, 0) == NULL);
 
     start_time_native = nl_get_time_native();
     // start timer
     nl_event_timer_start(&timer1, TIMER_TIMEOUT_1000_MS, false);
-    nl_task_sleep_ms(TIMER_TIMEOUT_500_MS + TIMER_TIMEOUT_1000_MS);
+    nltask_sleep_ms(TIMER_TIMEOUT_500_MS + TIMER_TIMEOUT_1000_MS);
     // cancel before restarting while timer is not running (should have already run)
     nl_event_timer_cancel(&timer1);
     // restart timer with same timeout, but reset to current time
@@ -339,11 +339,11 @@ static void Test_resend_cancel(nlTestSuite *inSuite, void *inContext)
     // check for the cancelled timer event (since we cancelled after
     // timer was already supposed to run, there should already be
     // an event on the queue but it should be invalid)
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, portMAX_DELAY);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, NLER_TIMEOUT_NEVER);
     NL_TEST_ASSERT(inSuite, receivedEvent == (nl_event_t*)&timer1);
     NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer1) == false);
     // check for the real timer event
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, portMAX_DELAY);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, NLER_TIMEOUT_NEVER);
     end_time_native = nl_get_time_native();
     expected_end_time_native_min = start_time_native + nl_time_ms_to_delay_time_native(TIMER_TIMEOUT_1000_MS + TIMER_TIMEOUT_500_MS + TIMER_TIMEOUT_1000_MS) - TIMER_TIMEOUT_TOLERANCE_TIME;
     expected_end_time_native_max = expected_end_time_native_min + 2*TIMER_TIMEOUT_TOLERANCE_TIME;
@@ -355,7 +355,7 @@ static void Test_resend_cancel(nlTestSuite *inSuite, void *inContext)
     NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer1) == true);
 
     // check no more events
-    NL_TEST_ASSERT(inSuite, nl_eventqueue_get_event_with_timeout(sQueue, 0) == NULL);
+    NL_TEST_ASSERT(inSuite, nleventqueue_get_event_with_timeout(&sQueue, 0) == NULL);
 }
 
 /* Test four timers with different timeouts with
@@ -388,10 +388,10 @@ static void Test_four_resend(nlTestSuite *inSuite, void *inContext)
     __attribute__((unused)) nl_time_native_t timer4_expected_time_native_max;
     nl_event_t *receivedEvent;
 
-    nl_event_timer_init(&timer1, NULL, NULL, sQueue);
-    nl_event_timer_init(&timer2, NULL, NULL, sQueue);
-    nl_event_timer_init(&timer3, NULL, NULL, sQueue);
-    nl_event_timer_init(&timer4, NULL, NULL, sQueue);
+    nl_event_timer_init(&timer1, NULL, NULL, &sQueue);
+    nl_event_timer_init(&timer2, NULL, NULL, &sQueue);
+    nl_event_timer_init(&timer3, NULL, NULL, &sQueue);
+    nl_event_timer_init(&timer4, NULL, NULL, &sQueue);
 
     printf("\nTest four event timers with restart ----\n");
 
@@ -414,13 +414,13 @@ static void Test_four_resend(nlTestSuite *inSuite, void *inContext)
 
     // since we restarted timer before it ran, should have
     // no events in the queue
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, 0);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, 0);
     NL_TEST_ASSERT(inSuite, receivedEvent == NULL);
 
     // check for valid timer1
     timer1_expected_time_native_min = start_time_native + nl_time_ms_to_delay_time_native(270) - TIMER_TIMEOUT_TOLERANCE_TIME;
     timer1_expected_time_native_max = timer1_expected_time_native_min + 2*TIMER_TIMEOUT_TOLERANCE_TIME;
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, portMAX_DELAY);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, NLER_TIMEOUT_NEVER);
     end_time_native = nl_get_time_native();
     NL_TEST_ASSERT(inSuite, receivedEvent == (nl_event_t*)&timer1);
     NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer1) == true);
@@ -429,7 +429,7 @@ static void Test_four_resend(nlTestSuite *inSuite, void *inContext)
     TIMER_ACCURACY_TEST_ASSERT(inSuite, ((end_time_native >= timer1_expected_time_native_min) &&
                                          (end_time_native <= timer1_expected_time_native_max)));
 
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, portMAX_DELAY);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, NLER_TIMEOUT_NEVER);
     end_time_native = nl_get_time_native();
     NL_TEST_ASSERT(inSuite, receivedEvent == (nl_event_t*)&timer2);
     NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer2) == true);
@@ -438,7 +438,7 @@ static void Test_four_resend(nlTestSuite *inSuite, void *inContext)
     TIMER_ACCURACY_TEST_ASSERT(inSuite, ((end_time_native >= timer2_expected_time_native_min) &&
                                          (end_time_native <= timer2_expected_time_native_max)));
 
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, portMAX_DELAY);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, NLER_TIMEOUT_NEVER);
     end_time_native = nl_get_time_native();
     NL_TEST_ASSERT(inSuite, receivedEvent == (nl_event_t*)&timer3);
     NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer3) == true);
@@ -447,7 +447,7 @@ static void Test_four_resend(nlTestSuite *inSuite, void *inContext)
     TIMER_ACCURACY_TEST_ASSERT(inSuite, ((end_time_native >= timer3_expected_time_native_min) &&
                                          (end_time_native <= timer3_expected_time_native_max)));
 
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, portMAX_DELAY);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, NLER_TIMEOUT_NEVER);
     end_time_native = nl_get_time_native();
     NL_TEST_ASSERT(inSuite, receivedEvent == (nl_event_t*)&timer4);
     NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer4) == true);
@@ -456,7 +456,7 @@ static void Test_four_resend(nlTestSuite *inSuite, void *inContext)
     TIMER_ACCURACY_TEST_ASSERT(inSuite, ((end_time_native >= timer4_expected_time_native_min) &&
                                          (end_time_native <= timer4_expected_time_native_max)));
 
-    NL_TEST_ASSERT(inSuite, nl_eventqueue_get_event_with_timeout(sQueue, 0) == NULL);
+    NL_TEST_ASSERT(inSuite, nleventqueue_get_event_with_timeout(&sQueue, 0) == NULL);
 }
 
 // test one repeating timer, verify we receive number we expect, then cancel
@@ -471,7 +471,7 @@ static void Test_one_repeating(nlTestSuite *inSuite, void *inContext)
     __attribute__((unused)) nl_time_native_t timer1_event_received_times[total_event_count];
     unsigned i;
 
-    nl_event_timer_init(&timer1, NULL, NULL, sQueue);
+    nl_event_timer_init(&timer1, NULL, NULL, &sQueue);
 
     printf("\nTest one repeating event timer ----\n");
 
@@ -481,7 +481,7 @@ static void Test_one_repeating(nlTestSuite *inSuite, void *inContext)
     // wait for events
     for (i = 0; i < total_event_count; i++)
     {
-        receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, portMAX_DELAY);
+        receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, NLER_TIMEOUT_NEVER);
         timer1_event_received_times[i] = nl_get_time_native();
         NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer1) == true);
         NL_TEST_ASSERT(inSuite, receivedEvent == (nl_event_t*)&timer1);
@@ -497,7 +497,7 @@ static void Test_one_repeating(nlTestSuite *inSuite, void *inContext)
 
     // cancel timer and wait for last event, which should be marked invalid
     nl_event_timer_cancel(&timer1);
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, TIMER1_TIMEOUT_MS * 2);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, TIMER1_TIMEOUT_MS * 2);
     // there could be an event posted or not, depending on whether timer
     // was still running at time of cancel. if there was one received,
     // assert it is invalid.
@@ -507,7 +507,7 @@ static void Test_one_repeating(nlTestSuite *inSuite, void *inContext)
     }
 
     // check no more events
-    NL_TEST_ASSERT(inSuite, nl_eventqueue_get_event_with_timeout(sQueue, 0) == NULL);
+    NL_TEST_ASSERT(inSuite, nleventqueue_get_event_with_timeout(&sQueue, 0) == NULL);
 
     for (i = 0; i < total_event_count; i++)
     {
@@ -570,10 +570,10 @@ static void Test_four_repeating(nlTestSuite *inSuite, void *inContext)
     nl_time_native_t timer4_event_received_times[2];
 #endif
 
-    nl_event_timer_init(&timer1, NULL, NULL, sQueue);
-    nl_event_timer_init(&timer2, NULL, NULL, sQueue);
-    nl_event_timer_init(&timer3, NULL, NULL, sQueue);
-    nl_event_timer_init(&timer4, NULL, NULL, sQueue);
+    nl_event_timer_init(&timer1, NULL, NULL, &sQueue);
+    nl_event_timer_init(&timer2, NULL, NULL, &sQueue);
+    nl_event_timer_init(&timer3, NULL, NULL, &sQueue);
+    nl_event_timer_init(&timer4, NULL, NULL, &sQueue);
 
     printf("\nTest four repeating event timers, takes about 5 seconds ----\n");
 
@@ -604,7 +604,7 @@ static void Test_four_repeating(nlTestSuite *inSuite, void *inContext)
 
     while (current_time_native < target_time_native)
     {
-        receivedEvent = (nl_event_timer_t*)nl_eventqueue_get_event_with_timeout(sQueue, TIMER_TIMEOUT_50_MS);
+        receivedEvent = (nl_event_timer_t*)nleventqueue_get_event_with_timeout(&sQueue, TIMER_TIMEOUT_50_MS);
         current_time_native = nl_get_time_native();
         if (receivedEvent == NULL)
         {
@@ -699,7 +699,7 @@ static void Test_four_repeating(nlTestSuite *inSuite, void *inContext)
 
     // flush any extra events
     for (i = 0; i < 4; i++) {
-        receivedEvent = (nl_event_timer_t*)nl_eventqueue_get_event_with_timeout(sQueue, 0);
+        receivedEvent = (nl_event_timer_t*)nleventqueue_get_event_with_timeout(&sQueue, 0);
         if (receivedEvent == NULL)
         {
             break;
@@ -782,12 +782,12 @@ static void Test_resend_repeating(nlTestSuite *inSuite, void *inContext)
     nl_event_t *receivedEvent;
     unsigned i;
 
-    nl_event_timer_init(&timer1, NULL, NULL, sQueue);
+    nl_event_timer_init(&timer1, NULL, NULL, &sQueue);
 
     printf("\nTest restarting repeating event timer ----\n");
     // start timer
     nl_event_timer_start(&timer1, TIMER_TIMEOUT_1000_MS, true);
-    nl_task_sleep_ms(TIMER_TIMEOUT_500_MS);
+    nltask_sleep_ms(TIMER_TIMEOUT_500_MS);
 
     // restart timer with same timeout before it even runs once,
     // should reset to current time
@@ -795,38 +795,34 @@ static void Test_resend_repeating(nlTestSuite *inSuite, void *inContext)
 
     // since we restarted before timer ran, should have no events
     // in the queue
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, 0);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, 0);
     NL_TEST_ASSERT(inSuite, receivedEvent == NULL);
 
-    // delay for 550MS and check that we have 5 events in our queue
-    nl_task_sleep_ms(TIMER_TIMEOUT_500_MS + TIMER_TIMEOUT_50_MS);
-    for (i = 0; i < 5; i++)
-    {
-        receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, 0);
-        NL_TEST_ASSERT(inSuite, receivedEvent == (nl_event_t*)&timer1);
-        NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer1) == true);
-    }
+    // delay for 550MS and check that we have 1 event in our queue,
+    // with the other 4 expiries counted as its overruns
+    nltask_sleep_ms(TIMER_TIMEOUT_500_MS + TIMER_TIMEOUT_50_MS);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, 0);
+    NL_TEST_ASSERT(inSuite, receivedEvent == (nl_event_t*)&timer1);
+    NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer1) == true);
+    TIMER_ACCURACY_TEST_ASSERT(inSuite, nl_event_timer_get_overrun(&timer1) == 4);
 
     // delay for 500MS more and then restart the timer, and check that
-    // we have 5 invalid events in our queue (none for the restart)
-    nl_task_sleep_ms(TIMER_TIMEOUT_500_MS);
+    // we have 1 invalid event in our queue (none for the restart)
+    nltask_sleep_ms(TIMER_TIMEOUT_500_MS);
     start_time_native = nl_get_time_native();
     nl_event_timer_start(&timer1, TIMER_TIMEOUT_100_MS, true);
-    for (i = 0; i < 5; i++)
-    {
-        receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, 0);
-        NL_TEST_ASSERT(inSuite, receivedEvent == (nl_event_t*)&timer1);
-        NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer1) == false);
-    }
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, 0);
+    NL_TEST_ASSERT(inSuite, receivedEvent == (nl_event_t*)&timer1);
+    NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer1) == false);
 
     // queue should be empty
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, 0);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, 0);
     NL_TEST_ASSERT(inSuite, receivedEvent == NULL);
 
     // wait for 10 more of the events
     for (i = 0; i < 10; i++)
     {
-        receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, TIMER_TIMEOUT_100_MS * 2);
+        receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, TIMER_TIMEOUT_100_MS * 2);
         end_time_native = nl_get_time_native();
         __attribute__((unused)) nl_time_native_t elapsed_time_native = end_time_native - start_time_native;
         start_time_native = end_time_native;
@@ -842,13 +838,13 @@ static void Test_resend_repeating(nlTestSuite *inSuite, void *inContext)
 
     // we restarted right after receiving last event so should
     // not have any events in the queue
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, 0);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, 0);
     NL_TEST_ASSERT(inSuite, receivedEvent == NULL);
 
     // wait for 10 of the events
     for (i = 0; i < 10; i++)
     {
-        receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, TIMER_TIMEOUT_500_MS * 2);
+        receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, TIMER_TIMEOUT_500_MS * 2);
         end_time_native = nl_get_time_native();
         __attribute__((unused)) nl_time_native_t elapsed_time_native = end_time_native - start_time_native;
         start_time_native = end_time_native;
@@ -862,11 +858,11 @@ static void Test_resend_repeating(nlTestSuite *inSuite, void *inContext)
 
     // we cancelled right after receiving last event so should
     // not have any events in the queue
-    receivedEvent = nl_eventqueue_get_event_with_timeout(sQueue, 0);
+    receivedEvent = nleventqueue_get_event_with_timeout(&sQueue, 0);
     NL_TEST_ASSERT(inSuite, receivedEvent == NULL);
 
     // check no more events
-    NL_TEST_ASSERT(inSuite, nl_eventqueue_get_event_with_timeout(sQueue, 0) == NULL);
+    NL_TEST_ASSERT(inSuite, nleventqueue_get_event_with_timeout(&sQueue, 0) == NULL);
 }
 
 static const nlTest sTests[] = {
@@ -907,11 +903,11 @@ int nler_timer_test(void)
         &sTests[0],
     };
 
-    sQueue = nl_eventqueue_create(sQueueMemory, sizeof(sQueueMemory));
+    nleventqueue_create(sQueueMemory, sizeof(sQueueMemory), &sQueue);
 
 #if NLER_FEATURE_TIMER_USING_SWTIMER
 #if NLER_BUILD_PLATFORM_FREERTOS
-    nl_task_t task_handle;
+    nltask_t task_handle;
     int end_dummy_task = 0;
     uint8_t dummy_stack[512];
 
@@ -927,7 +923,7 @@ int nler_timer_test(void)
      * xTaskGetTickCount() won't be right, so any tests of
      * accuracy from within timer functions can fail.
      */
-    nl_task_create(dummy_task, "dum", dummy_stack_ptr, sizeof(dummy_stack) - (dummy_stack_ptr - dummy_stack),
+    nltask_create(dummy_task, "dum", dummy_stack_ptr, sizeof(dummy_stack) - (dummy_stack_ptr - dummy_stack),
                    kIdleTaskPrio + 1, &end_dummy_task, &task_handle);
 
     // block sleep since many of our tests check for timer accuracy.
@@ -948,7 +944,7 @@ int nler_timer_test(void)
 #endif
 #endif
 
-    nl_eventqueue_destroy(sQueue);
+    nleventqueue_destroy(&sQueue);
 
     return nlTestRunnerStats(&theSuite);
 }
@@ -0,0 +1,379 @@
+/*
+ *
+ *    Copyright (c) 2026 Project nler Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test for the NLER buffer chain
+ *      interfaces.
+ *
+ */
+
+#include <nlerbuffer.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef nlLOG_PRIORITY
+#undef nlLOG_PRIORITY
+#endif
+#define nlLOG_PRIORITY 1
+
+#include <nlererror.h>
+#include <nlerinit.h>
+#include <nlerlog.h>
+
+#include <nlunit-test.h>
+
+#define kSEGMENT_SIZE       32
+#define kSEGMENT_COUNT      4
+#define kHEADROOM           8
+
+static uint8_t sBufferMemory[(sizeof(nl_buffer_t) + kSEGMENT_SIZE + 8) * kSEGMENT_COUNT];
+
+static size_t count_segments(const nl_buffer_t *aBuffer)
+{
+    size_t retval = 0;
+
+    for (; aBuffer != NULL; aBuffer = aBuffer->mNext)
+    {
+        retval++;
+    }
+
+    return retval;
+}
+
+static bool is_pool_full(nl_buffer_pool_t *aPool)
+{
+    nl_buffer_t *buffer = nl_buffer_alloc(aPool, kSEGMENT_SIZE * kSEGMENT_COUNT, 0);
+    bool        retval = (buffer != NULL);
+
+    nl_buffer_free(buffer);
+
+    return retval;
+}
+
+static void TestAllocAndFree(nlTestSuite *inSuite, void *inContext)
+{
+    nl_buffer_pool_t    pool;
+    nl_buffer_t         *buffer;
+    nl_buffer_t         *other;
+    int                 status;
+
+    /* Test known, positive failure cases
+     */
+
+    status = nl_buffer_pool_create(NULL, sizeof(sBufferMemory), kSEGMENT_SIZE, &pool);
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_BAD_INPUT);
+
+    status = nl_buffer_pool_create(sBufferMemory, 8, kSEGMENT_SIZE, &pool);
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_BAD_INPUT);
+
+    status = nl_buffer_pool_create(sBufferMemory, sizeof(sBufferMemory), 0, &pool);
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_BAD_INPUT);
+
+    /* Test success case
+     */
+
+    status = nl_buffer_pool_create(sBufferMemory, sizeof(sBufferMemory), kSEGMENT_SIZE, &pool);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    /*
+     * Allocation
+     */
+
+    buffer = nl_buffer_alloc(&pool, 0, kSEGMENT_SIZE);
+    NL_TEST_ASSERT(inSuite, buffer == NULL);
+
+    buffer = nl_buffer_alloc(&pool, 0, 0);
+    NL_TEST_ASSERT(inSuite, buffer != NULL);
+    NL_TEST_ASSERT(inSuite, nl_buffer_length(buffer) == 0);
+    NL_TEST_ASSERT(inSuite, count_segments(buffer) == 1);
+
+    nl_buffer_free(buffer);
+
+    buffer = nl_buffer_alloc(&pool, kSEGMENT_SIZE, kHEADROOM);
+    NL_TEST_ASSERT(inSuite, buffer != NULL);
+    NL_TEST_ASSERT(inSuite, nl_buffer_length(buffer) == kSEGMENT_SIZE);
+    NL_TEST_ASSERT(inSuite, count_segments(buffer) == 2);
+    NL_TEST_ASSERT(inSuite, buffer->mLength == (kSEGMENT_SIZE - kHEADROOM));
+
+    /* Segments of a fresh pool are chained in address order
+     */
+
+    NL_TEST_ASSERT(inSuite, (uintptr_t)buffer < (uintptr_t)buffer->mNext);
+
+    /* Too few segments left
+     */
+
+    other = nl_buffer_alloc(&pool, kSEGMENT_SIZE * 2 + 1, 0);
+    NL_TEST_ASSERT(inSuite, other == NULL);
+
+    other = nl_buffer_alloc(&pool, kSEGMENT_SIZE * 2, 0);
+    NL_TEST_ASSERT(inSuite, other != NULL);
+    NL_TEST_ASSERT(inSuite, count_segments(other) == 2);
+
+    /*
+     * Free
+     */
+
+    nl_buffer_free(other);
+    nl_buffer_free(buffer);
+    nl_buffer_free(NULL);
+
+    NL_TEST_ASSERT(inSuite, is_pool_full(&pool));
+
+    nl_buffer_pool_destroy(&pool);
+}
+
+static void TestReadAndWrite(nlTestSuite *inSuite, void *inContext)
+{
+    nl_buffer_pool_t    pool;
+    nl_buffer_t         *buffer;
+    uint8_t             in[kSEGMENT_SIZE * 2];
+    uint8_t             out[kSEGMENT_SIZE * 2];
+    size_t              count;
+    size_t              i;
+    int                 status;
+
+    for (i = 0; i < sizeof(in); i++)
+    {
+        in[i] = (uint8_t)i;
+    }
+
+    status = nl_buffer_pool_create(sBufferMemory, sizeof(sBufferMemory), kSEGMENT_SIZE, &pool);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    buffer = nl_buffer_alloc(&pool, sizeof(in), kHEADROOM);
+    NL_TEST_ASSERT(inSuite, count_segments(buffer) == 3);
+
+    count = nl_buffer_write(buffer, 0, in, sizeof(in));
+    NL_TEST_ASSERT(inSuite, count == sizeof(in));
+
+    count = nl_buffer_read(buffer, 0, out, sizeof(out));
+    NL_TEST_ASSERT(inSuite, count == sizeof(out));
+    NL_TEST_ASSERT(inSuite, memcmp(in, out, sizeof(in)) == 0);
+
+    /* Across a segment boundary, running off the end
+     */
+
+    count = nl_buffer_read(buffer, kSEGMENT_SIZE, out, sizeof(out));
+    NL_TEST_ASSERT(inSuite, count == kSEGMENT_SIZE);
+    NL_TEST_ASSERT(inSuite, memcmp(&in[kSEGMENT_SIZE], out, count) == 0);
+
+    count = nl_buffer_write(buffer, sizeof(in), in, 1);
+    NL_TEST_ASSERT(inSuite, count == 0);
+
+    nl_buffer_free(buffer);
+
+    nl_buffer_pool_destroy(&pool);
+}
+
+static void TestHeaderAndTrim(nlTestSuite *inSuite, void *inContext)
+{
+    nl_buffer_pool_t    pool;
+    nl_buffer_t         *buffer;
+    uint8_t             header[kHEADROOM] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    uint8_t             out[kHEADROOM];
+    int                 status;
+
+    status = nl_buffer_pool_create(sBufferMemory, sizeof(sBufferMemory), kSEGMENT_SIZE, &pool);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    buffer = nl_buffer_alloc(&pool, kSEGMENT_SIZE * 2, kHEADROOM);
+    NL_TEST_ASSERT(inSuite, buffer != NULL);
+
+    /*
+     * Header
+     */
+
+    status = nl_buffer_adjust_header(buffer, kHEADROOM + 1);
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_NO_RESOURCE);
+
+    status = nl_buffer_adjust_header(buffer, kHEADROOM);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+    NL_TEST_ASSERT(inSuite, nl_buffer_length(buffer) == (kSEGMENT_SIZE * 2 + kHEADROOM));
+
+    nl_buffer_write(buffer, 0, header, sizeof(header));
+
+    status = nl_buffer_adjust_header(buffer, -(kSEGMENT_SIZE + 1));
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_BAD_INPUT);
+
+    status = nl_buffer_adjust_header(buffer, -2);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    nl_buffer_read(buffer, 0, out, 2);
+    NL_TEST_ASSERT(inSuite, (out[0] == 3) && (out[1] == 4));
+
+    /*
+     * Trim
+     */
+
+    nl_buffer_trim(buffer, kSEGMENT_SIZE * 4);
+    NL_TEST_ASSERT(inSuite, nl_buffer_length(buffer) == (kSEGMENT_SIZE * 2 + kHEADROOM - 2));
+
+    nl_buffer_trim(buffer, kSEGMENT_SIZE);
+    NL_TEST_ASSERT(inSuite, nl_buffer_length(buffer) == kSEGMENT_SIZE);
+    NL_TEST_ASSERT(inSuite, count_segments(buffer) == 2);
+
+    nl_buffer_trim(buffer, 10);
+    NL_TEST_ASSERT(inSuite, nl_buffer_length(buffer) == 10);
+    NL_TEST_ASSERT(inSuite, count_segments(buffer) == 1);
+
+    nl_buffer_free(buffer);
+
+    NL_TEST_ASSERT(inSuite, is_pool_full(&pool));
+
+    nl_buffer_pool_destroy(&pool);
+}
+
+static void TestSplitAndShare(nlTestSuite *inSuite, void *inContext)
+{
+    nl_buffer_pool_t    pool;
+    nl_buffer_t         *buffer;
+    nl_buffer_t         *tail;
+    nl_buffer_t         *spare;
+    uint8_t             in[kSEGMENT_SIZE * 2];
+    uint8_t             out[kSEGMENT_SIZE * 2];
+    size_t              i;
+    int                 status;
+
+    for (i = 0; i < sizeof(in); i++)
+    {
+        in[i] = (uint8_t)i;
+    }
+
+    status = nl_buffer_pool_create(sBufferMemory, sizeof(sBufferMemory), kSEGMENT_SIZE, &pool);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    buffer = nl_buffer_alloc(&pool, sizeof(in), 0);
+    NL_TEST_ASSERT(inSuite, count_segments(buffer) == 2);
+
+    nl_buffer_write(buffer, 0, in, sizeof(in));
+
+    /*
+     * Split
+     */
+
+    tail = nl_buffer_split(buffer, 0);
+    NL_TEST_ASSERT(inSuite, tail == NULL);
+
+    tail = nl_buffer_split(buffer, sizeof(in));
+    NL_TEST_ASSERT(inSuite, tail == NULL);
+
+    /* At a segment boundary, no segment is needed
+     */
+
+    spare = nl_buffer_alloc(&pool, kSEGMENT_SIZE * 2, 0);
+    NL_TEST_ASSERT(inSuite, spare != NULL);
+
+    tail = nl_buffer_split(buffer, kSEGMENT_SIZE);
+    NL_TEST_ASSERT(inSuite, tail != NULL);
+    NL_TEST_ASSERT(inSuite, nl_buffer_length(buffer) == kSEGMENT_SIZE);
+    NL_TEST_ASSERT(inSuite, nl_buffer_length(tail) == kSEGMENT_SIZE);
+
+    nl_buffer_cat(buffer, tail);
+
+    /* Inside a segment, a segment refers to the storage of the other
+     */
+
+    tail = nl_buffer_split(buffer, 10);
+    NL_TEST_ASSERT(inSuite, tail == NULL);
+
+    nl_buffer_free(spare);
+
+    tail = nl_buffer_split(buffer, 10);
+    NL_TEST_ASSERT(inSuite, tail != NULL);
+    NL_TEST_ASSERT(inSuite, nl_buffer_length(buffer) == 10);
+    NL_TEST_ASSERT(inSuite, nl_buffer_length(tail) == (sizeof(in) - 10));
+    NL_TEST_ASSERT(inSuite, tail->mData == (buffer->mData + 10));
+
+    nl_buffer_read(tail, 0, out, sizeof(out));
+    NL_TEST_ASSERT(inSuite, memcmp(&in[10], out, sizeof(in) - 10) == 0);
+
+    status = nl_buffer_adjust_header(tail, 1);
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_NO_RESOURCE);
+
+    /* The storage outlives the segment it belongs to
+     */
+
+    nl_buffer_free(buffer);
+
+    NL_TEST_ASSERT(inSuite, nl_buffer_alloc(&pool, kSEGMENT_SIZE * 2, 0) == NULL);
+
+    nl_buffer_read(tail, 0, out, sizeof(out));
+    NL_TEST_ASSERT(inSuite, memcmp(&in[10], out, sizeof(in) - 10) == 0);
+
+    /*
+     * Share
+     */
+
+    nl_buffer_ref(tail);
+
+    nl_buffer_free(tail);
+
+    NL_TEST_ASSERT(inSuite, nl_buffer_length(tail) == (sizeof(in) - 10));
+
+    nl_buffer_free(tail);
+
+    NL_TEST_ASSERT(inSuite, is_pool_full(&pool));
+
+    nl_buffer_pool_destroy(&pool);
+}
+
+static const nlTest sTests[] = {
+    NL_TEST_DEF("alloc and free",          TestAllocAndFree),
+    NL_TEST_DEF("read and write",          TestReadAndWrite),
+    NL_TEST_DEF("header and trim",         TestHeaderAndTrim),
+    NL_TEST_DEF("split and share",         TestSplitAndShare),
+    NL_TEST_SENTINEL()
+};
+
+int nler_buffer_test(void)
+{
+    nlTestSuite theSuite = {
+        "nlerbuffer",
+        &sTests[0]
+    };
+
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+}
+
+int main(int argc, char **argv)
+{
+    int status;
+
+    nl_er_init();
+
+    NL_LOG_CRIT(lrTEST, "start main\n");
+
+    nl_er_start_running();
+
+    status = nler_buffer_test();
+
+    nl_er_cleanup();
+
+    NL_LOG_CRIT(lrTEST, "end main\n");
+
+    return (status);
+}
@@ -0,0 +1,300 @@
+/*
+ *
+ *    Copyright (c) 2026 Project nler Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test for the POSIX threads
+ *      (pthreads)-specific event loop.
+ *
+ */
+
+#include <nlereventloop.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#ifdef nlLOG_PRIORITY
+#undef nlLOG_PRIORITY
+#endif
+#define nlLOG_PRIORITY 1
+
+#include <nlererror.h>
+#include <nlerinit.h>
+#include <nlerlog.h>
+
+#include <nlunit-test.h>
+
+#define NL_EVENT_T_TEST (NL_EVENT_T_WM_USER + 1)
+
+typedef struct nl_test_loop_state_s
+{
+    nl_event_loop_t    *mLoop;
+    nl_event_fd_t      *mRemove;
+    int                 mQueuedCount;
+    int                 mReadableCount;
+    bool                mStopOnQueued;
+} nl_test_loop_state_t;
+
+static int DefaultHandler(nl_event_t *aEvent, void *aClosure)
+{
+    nl_test_loop_state_t *state = (nl_test_loop_state_t *)aClosure;
+
+    if (aEvent->mType == NL_EVENT_T_TEST)
+    {
+        state->mQueuedCount++;
+
+        if (state->mStopOnQueued)
+        {
+            nl_event_loop_stop(state->mLoop);
+        }
+    }
+
+    return NLER_SUCCESS;
+}
+
+static int ReadableHandler(nl_event_t *aEvent, void *aClosure)
+{
+    nl_test_loop_state_t *state = (nl_test_loop_state_t *)aClosure;
+    nl_event_fd_t        *event = (nl_event_fd_t *)aEvent;
+    char                  byte;
+
+    if (event->mReady & NL_EVENT_LOOP_READABLE)
+    {
+        state->mReadableCount++;
+
+        if (read(event->mFd, &byte, 1) != 1)
+        {
+            state->mReadableCount = -1;
+        }
+    }
+
+    if (state->mRemove != NULL)
+    {
+        nl_event_loop_remove_fd(state->mLoop, state->mRemove);
+    }
+
+    return NLER_SUCCESS;
+}
+
+static void TestInitAndDestroy(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *test_queuemem[4];
+    nleventqueue_t          test_queue;
+    nl_event_loop_t         test_loop;
+    nl_test_loop_state_t    state = { &test_loop, NULL, 0, 0, false };
+    int                     status;
+
+    status = nleventqueue_create(&test_queuemem[0], sizeof (test_queuemem), &test_queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    /*
+     * Initialization
+     */
+
+    /* Test known, positive failure cases
+     */
+
+    status = nl_event_loop_init(NULL, &test_queue, DefaultHandler, &state);
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_BAD_INPUT);
+
+    status = nl_event_loop_init(&test_loop, NULL, DefaultHandler, &state);
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_BAD_INPUT);
+
+    status = nl_event_loop_init(&test_loop, &test_queue, NULL, &state);
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_BAD_INPUT);
+
+    /* Test success case
+     */
+
+    status = nl_event_loop_init(&test_loop, &test_queue, DefaultHandler, &state);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    /*
+     * Nothing Ready
+     */
+
+    status = nl_event_loop_run_once(&test_loop, NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, status == 0);
+
+    /*
+     * Destruction
+     */
+
+    nl_event_loop_destroy(&test_loop);
+
+    nleventqueue_destroy(&test_queue);
+}
+
+static void TestDispatch(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *test_queuemem[4];
+    nleventqueue_t          test_queue;
+    nl_event_loop_t         test_loop;
+    nl_test_loop_state_t    state = { &test_loop, NULL, 0, 0, false };
+    nl_event_t              test_events[2] = {
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL) },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL) }
+    };
+    nl_event_fd_t           test_fd_event;
+    int                     fds[2];
+    int                     status;
+
+    status = nleventqueue_create(&test_queuemem[0], sizeof (test_queuemem), &test_queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    status = nl_event_loop_init(&test_loop, &test_queue, DefaultHandler, &state);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    status = pipe(fds);
+    NL_TEST_ASSERT(inSuite, status == 0);
+
+    NL_INIT_EVENT(test_fd_event, NL_EVENT_T_FD, ReadableHandler, &state);
+    test_fd_event.mFd       = fds[0];
+    test_fd_event.mInterest = NL_EVENT_LOOP_READABLE;
+
+    /*
+     * Add Descriptor
+     */
+
+    status = nl_event_loop_add_fd(&test_loop, &test_fd_event);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    status = nl_event_loop_add_fd(&test_loop, &test_fd_event);
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_BAD_STATE);
+
+    /*
+     * Queued Events
+     */
+
+    nleventqueue_post_event(&test_queue, &test_events[0]);
+    nleventqueue_post_event(&test_queue, &test_events[1]);
+
+    status = nl_event_loop_run_once(&test_loop, NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, status == 2);
+    NL_TEST_ASSERT(inSuite, state.mQueuedCount == 2);
+    NL_TEST_ASSERT(inSuite, state.mReadableCount == 0);
+
+    /*
+     * Descriptor Readiness
+     */
+
+    status = write(fds[1], "x", 1);
+    NL_TEST_ASSERT(inSuite, status == 1);
+
+    status = nl_event_loop_run_once(&test_loop, 1000);
+    NL_TEST_ASSERT(inSuite, status == 1);
+    NL_TEST_ASSERT(inSuite, state.mReadableCount == 1);
+
+    /*
+     * Both At Once
+     */
+
+    nleventqueue_post_event(&test_queue, &test_events[0]);
+
+    status = write(fds[1], "x", 1);
+    NL_TEST_ASSERT(inSuite, status == 1);
+
+    status = nl_event_loop_run_once(&test_loop, 1000);
+    NL_TEST_ASSERT(inSuite, status == 2);
+    NL_TEST_ASSERT(inSuite, state.mQueuedCount == 3);
+    NL_TEST_ASSERT(inSuite, state.mReadableCount == 2);
+
+    /*
+     * Removal From Within the Handler
+     */
+
+    state.mRemove = &test_fd_event;
+
+    status = write(fds[1], "xx", 2);
+    NL_TEST_ASSERT(inSuite, status == 2);
+
+    status = nl_event_loop_run_once(&test_loop, 1000);
+    NL_TEST_ASSERT(inSuite, status == 1);
+    NL_TEST_ASSERT(inSuite, state.mReadableCount == 3);
+
+    status = nl_event_loop_run_once(&test_loop, NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, status == 0);
+    NL_TEST_ASSERT(inSuite, state.mReadableCount == 3);
+
+    status = nl_event_loop_remove_fd(&test_loop, &test_fd_event);
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_BAD_STATE);
+
+    /*
+     * Run Until Stopped
+     */
+
+    state.mStopOnQueued = true;
+
+    nleventqueue_post_event(&test_queue, &test_events[0]);
+
+    status = nl_event_loop_run(&test_loop);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+    NL_TEST_ASSERT(inSuite, state.mQueuedCount == 4);
+
+    /*
+     * Destruction
+     */
+
+    close(fds[0]);
+    close(fds[1]);
+
+    nl_event_loop_destroy(&test_loop);
+
+    nleventqueue_destroy(&test_queue);
+}
+
+static const nlTest sTests[] = {
+    NL_TEST_DEF("init and destroy",        TestInitAndDestroy),
+    NL_TEST_DEF("dispatch",                TestDispatch),
+    NL_TEST_SENTINEL()
+};
+
+int nler_eventloop_test(void)
+{
+    nlTestSuite theSuite = {
+        "nlereventloop",
+        &sTests[0]
+    };
+
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+}
+
+int main(int argc, char **argv)
+{
+    int status;
+
+    nl_er_init();
+
+    NL_LOG_CRIT(lrTEST, "start main\n");
+
+    nl_er_start_running();
+
+    status = nler_eventloop_test();
+
+    nl_er_cleanup();
+
+    NL_LOG_CRIT(lrTEST, "end main\n");
+
+    return (status);
+}
@@ -29,6 +29,10 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#if defined(__linux__)
+#include <poll.h>
+#endif
+
 #ifdef nlLOG_PRIORITY
 #undef nlLOG_PRIORITY
 #endif
@@ -37,6 +41,7 @@
 #include <nlererror.h>
 #include <nlerinit.h>
 #include <nlerlog.h>
+#include <nlertask.h>
 
 #include <nlunit-test.h>
 
@@ -515,6 +520,1088 @@ static void TestGetEventWithTimeout(nlTestSuite *inSuite, void *inContext)
     nleventqueue_destroy(&test_queue);
 }
 
+static void TestPostEventUrgent(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *test_queuemem[3];
+    nleventqueue_t          test_queue;
+    nl_event_test_t         test_events[5] = {
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x1 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x2 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x3 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x4 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_EXIT, NULL, NULL), 0x5 }
+    };
+    nl_event_test_t        *evp;
+    int                     status;
+    uint32_t                count;
+    size_t                  i;
+
+    /*
+     * Creation
+     */
+
+    status = nleventqueue_create(&test_queuemem[0], sizeof (test_queuemem), &test_queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    /*
+     * Post Events
+     */
+
+    /* Fill the Queue with Routine Events */
+
+    for (i = 0; i < 3; i++)
+    {
+        status = nleventqueue_post_event(&test_queue, (nl_event_t *)&test_events[i]);
+        NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+    }
+
+    status = nleventqueue_post_event(&test_queue, (nl_event_t *)&test_events[3]);
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_NO_RESOURCE);
+
+    /* Urgent Event */
+
+    status = nleventqueue_post_event_urgent(&test_queue, (nl_event_t *)&test_events[4]);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    count = nleventqueue_get_count(&test_queue);
+    NL_TEST_ASSERT(inSuite, count == 4);
+
+    /*
+     * Get Events
+     */
+
+    /* The Urgent Event Comes First */
+
+    evp = (nl_event_test_t *)nleventqueue_get_event_with_timeout(&test_queue, NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, evp != NULL);
+    NL_TEST_ASSERT(inSuite, evp->mType == NL_EVENT_T_EXIT);
+    NL_TEST_ASSERT(inSuite, evp->mIdentifier == 0x5);
+
+    /* Then the Routine Events, in Order */
+
+    for (i = 0; i < 3; i++)
+    {
+        evp = (nl_event_test_t *)nleventqueue_get_event_with_timeout(&test_queue, NLER_TIMEOUT_NOW);
+        NL_TEST_ASSERT(inSuite, evp != NULL);
+        NL_TEST_ASSERT(inSuite, evp->mIdentifier == i + 1);
+    }
+
+    count = nleventqueue_get_count(&test_queue);
+    NL_TEST_ASSERT(inSuite, count == 0);
+
+    /*
+     * Destruction
+     */
+
+    nleventqueue_destroy(&test_queue);
+}
+
+typedef struct nl_test_drops_s
+{
+    int                     mCount;
+    nl_event_t             *mLastDropped;
+} nl_test_drops_t;
+
+static void DropHandler(nl_event_t *aEvent, void *aClosure)
+{
+    nl_test_drops_t        *drops = (nl_test_drops_t *)aClosure;
+
+    drops->mCount++;
+    drops->mLastDropped = aEvent;
+}
+
+static void TestOverflowPolicy(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *test_queuemem[2];
+    nleventqueue_t          test_queue;
+    nl_event_test_t         test_events[3] = {
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x1 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x2 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x3 }
+    };
+    nl_test_drops_t         drops = { 0, NULL };
+    nl_event_test_t        *evp;
+    int                     status;
+    uint32_t                count;
+
+    /*
+     * Creation
+     */
+
+    status = nleventqueue_create(&test_queuemem[0], sizeof (test_queuemem), &test_queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    status = nleventqueue_set_drop_handler(&test_queue, DropHandler, &drops);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    /*
+     * Set Overflow Policy
+     */
+
+    /* Failure Cases */
+
+    status = nleventqueue_set_overflow_policy(&test_queue, (nleventqueue_overflow_policy_t)(NLER_EVENTQUEUE_OVERFLOW_CONFLATE + 1));
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_BAD_INPUT);
+
+    /* Drop Newest */
+
+    status = nleventqueue_set_overflow_policy(&test_queue, NLER_EVENTQUEUE_OVERFLOW_DROP_NEWEST);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    status = nleventqueue_post_event(&test_queue, (nl_event_t *)&test_events[0]);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    status = nleventqueue_post_event(&test_queue, (nl_event_t *)&test_events[1]);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    status = nleventqueue_post_event(&test_queue, (nl_event_t *)&test_events[2]);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    count = nleventqueue_get_count(&test_queue);
+    NL_TEST_ASSERT(inSuite, count == 2);
+
+    NL_TEST_ASSERT(inSuite, drops.mCount == 1);
+    NL_TEST_ASSERT(inSuite, drops.mLastDropped == (nl_event_t *)&test_events[2]);
+
+    evp = (nl_event_test_t *)nleventqueue_get_event_with_timeout(&test_queue, NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, evp != NULL);
+    NL_TEST_ASSERT(inSuite, evp->mIdentifier == 0x1);
+
+    evp = (nl_event_test_t *)nleventqueue_get_event_with_timeout(&test_queue, NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, evp != NULL);
+    NL_TEST_ASSERT(inSuite, evp->mIdentifier == 0x2);
+
+    /* Drop Oldest, Where Supported */
+
+    status = nleventqueue_set_overflow_policy(&test_queue, NLER_EVENTQUEUE_OVERFLOW_DROP_OLDEST);
+    NL_TEST_ASSERT(inSuite, (status == NLER_SUCCESS) || (status == NLER_ERROR_NOT_IMPLEMENTED));
+
+    if (status == NLER_SUCCESS)
+    {
+        status = nleventqueue_post_event(&test_queue, (nl_event_t *)&test_events[0]);
+        NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+        status = nleventqueue_post_event(&test_queue, (nl_event_t *)&test_events[1]);
+        NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+        status = nleventqueue_post_event(&test_queue, (nl_event_t *)&test_events[2]);
+        NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+        count = nleventqueue_get_count(&test_queue);
+        NL_TEST_ASSERT(inSuite, count == 2);
+
+        /* The Displaced Event Is Handed Back */
+
+        NL_TEST_ASSERT(inSuite, drops.mCount == 2);
+        NL_TEST_ASSERT(inSuite, drops.mLastDropped == (nl_event_t *)&test_events[0]);
+
+        evp = (nl_event_test_t *)nleventqueue_get_event_with_timeout(&test_queue, NLER_TIMEOUT_NOW);
+        NL_TEST_ASSERT(inSuite, evp != NULL);
+        NL_TEST_ASSERT(inSuite, evp->mIdentifier == 0x2);
+
+        evp = (nl_event_test_t *)nleventqueue_get_event_with_timeout(&test_queue, NLER_TIMEOUT_NOW);
+        NL_TEST_ASSERT(inSuite, evp != NULL);
+        NL_TEST_ASSERT(inSuite, evp->mIdentifier == 0x3);
+    }
+
+    /* Conflate, Where Supported */
+
+    status = nleventqueue_set_overflow_policy(&test_queue, NLER_EVENTQUEUE_OVERFLOW_CONFLATE);
+    NL_TEST_ASSERT(inSuite, (status == NLER_SUCCESS) || (status == NLER_ERROR_NOT_IMPLEMENTED));
+
+    if (status == NLER_SUCCESS)
+    {
+        drops.mCount = 0;
+
+        status = nleventqueue_post_event(&test_queue, (nl_event_t *)&test_events[0]);
+        NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+        status = nleventqueue_post_event(&test_queue, (nl_event_t *)&test_events[0]);
+        NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+        count = nleventqueue_get_count(&test_queue);
+        NL_TEST_ASSERT(inSuite, count == 1);
+
+        status = nleventqueue_post_event(&test_queue, (nl_event_t *)&test_events[1]);
+        NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+        status = nleventqueue_post_event(&test_queue, (nl_event_t *)&test_events[1]);
+        NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+        status = nleventqueue_post_event(&test_queue, (nl_event_t *)&test_events[2]);
+        NL_TEST_ASSERT(inSuite, status == NLER_ERROR_NO_RESOURCE);
+
+        /* A Pending Event Is Conflated Without Waiting for Space */
+
+        status = nleventqueue_post_event_with_timeout(&test_queue, (nl_event_t *)&test_events[0], NLER_TIMEOUT_NEVER);
+        NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+        status = nleventqueue_post_event_with_timeout(&test_queue, (nl_event_t *)&test_events[2], 1);
+        NL_TEST_ASSERT(inSuite, status == NLER_ERROR_NO_RESOURCE);
+
+        /* Conflated Events Are Not Dropped */
+
+        NL_TEST_ASSERT(inSuite, drops.mCount == 0);
+
+        evp = (nl_event_test_t *)nleventqueue_get_event_with_timeout(&test_queue, NLER_TIMEOUT_NOW);
+        NL_TEST_ASSERT(inSuite, evp != NULL);
+        NL_TEST_ASSERT(inSuite, evp->mIdentifier == 0x1);
+
+        evp = (nl_event_test_t *)nleventqueue_get_event_with_timeout(&test_queue, NLER_TIMEOUT_NOW);
+        NL_TEST_ASSERT(inSuite, evp != NULL);
+        NL_TEST_ASSERT(inSuite, evp->mIdentifier == 0x2);
+    }
+
+    count = nleventqueue_get_count(&test_queue);
+    NL_TEST_ASSERT(inSuite, count == 0);
+
+    /*
+     * Destruction
+     */
+
+    nleventqueue_destroy(&test_queue);
+}
+
+typedef struct nl_test_watermarks_s
+{
+    int                     mHighCount;
+    int                     mLowCount;
+    bool                    mAboveHighWatermark;
+} nl_test_watermarks_t;
+
+static void WatermarkHandler(bool aAboveHighWatermark, void *aClosure)
+{
+    nl_test_watermarks_t   *watermarks = (nl_test_watermarks_t *)aClosure;
+
+    if (aAboveHighWatermark)
+        watermarks->mHighCount++;
+    else
+        watermarks->mLowCount++;
+
+    watermarks->mAboveHighWatermark = aAboveHighWatermark;
+}
+
+static void TestWatermarks(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *test_queuemem[5];
+    nleventqueue_t          test_queue;
+    nl_event_test_t         test_events[5] = {
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x1 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x2 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x3 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x4 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x5 }
+    };
+    const size_t            event_count = sizeof (test_events) / sizeof (test_events[0]);
+    nl_test_watermarks_t    watermarks = { 0, 0, false };
+    nl_event_t             *evp;
+    int                     status;
+    size_t                  i;
+
+    /*
+     * Creation
+     */
+
+    status = nleventqueue_create(&test_queuemem[0], sizeof (test_queuemem), &test_queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    /*
+     * Set Watermarks
+     */
+
+    /* Failure Cases */
+
+    status = nleventqueue_set_watermarks(&test_queue, 3, 3, WatermarkHandler, &watermarks);
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_BAD_INPUT);
+
+    /* Success Cases */
+
+    status = nleventqueue_set_watermarks(&test_queue, 1, 4, WatermarkHandler, &watermarks);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    /* Rising to the High Watermark Notifies Once */
+
+    for (i = 0; i < event_count; i++)
+    {
+        status = nleventqueue_post_event(&test_queue, (nl_event_t *)&test_events[i]);
+        NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+        NL_TEST_ASSERT(inSuite, watermarks.mAboveHighWatermark == (i >= 3));
+    }
+
+    NL_TEST_ASSERT(inSuite, watermarks.mHighCount == 1);
+    NL_TEST_ASSERT(inSuite, watermarks.mLowCount == 0);
+
+    /* Falling to the Low Watermark Notifies Once */
+
+    for (i = 0; i < event_count; i++)
+    {
+        evp = nleventqueue_get_event_with_timeout(&test_queue, NLER_TIMEOUT_NOW);
+        NL_TEST_ASSERT(inSuite, evp != NULL);
+
+        NL_TEST_ASSERT(inSuite, watermarks.mAboveHighWatermark == (i < 3));
+    }
+
+    NL_TEST_ASSERT(inSuite, watermarks.mHighCount == 1);
+    NL_TEST_ASSERT(inSuite, watermarks.mLowCount == 1);
+
+    /* No Handler, No Notification */
+
+    status = nleventqueue_set_watermarks(&test_queue, 0, 0, NULL, NULL);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    for (i = 0; i < event_count; i++)
+    {
+        status = nleventqueue_post_event(&test_queue, (nl_event_t *)&test_events[i]);
+        NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+    }
+
+    NL_TEST_ASSERT(inSuite, watermarks.mHighCount == 1);
+
+    /*
+     * Destruction
+     */
+
+    nleventqueue_destroy(&test_queue);
+}
+
+static void TestGetStats(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *test_queuemem[3];
+    nleventqueue_t          test_queue;
+    nl_event_test_t         test_events[4] = {
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x1 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x2 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x3 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x4 }
+    };
+    const size_t            event_count = sizeof (test_events) / sizeof (test_events[0]);
+    nleventqueue_stats_t    stats;
+    nl_event_t             *evp;
+    int                     status;
+    uint32_t                histogram_total;
+    size_t                  i;
+
+    /*
+     * Creation
+     */
+
+    status = nleventqueue_create(&test_queuemem[0], sizeof (test_queuemem), &test_queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    /*
+     * Get Stats
+     */
+
+    /* Failure Cases */
+
+    status = nleventqueue_get_stats(&test_queue, NULL);
+    NL_TEST_ASSERT(inSuite, (status == NLER_ERROR_BAD_INPUT) || (status == NLER_ERROR_NOT_IMPLEMENTED));
+
+    /* Statistics Not Kept */
+
+    status = nleventqueue_get_stats(&test_queue, &stats);
+    NL_TEST_ASSERT(inSuite, (status == NLER_SUCCESS) || (status == NLER_ERROR_NOT_IMPLEMENTED));
+
+    if (status == NLER_SUCCESS)
+    {
+        /* Fresh Queue */
+
+        NL_TEST_ASSERT(inSuite, stats.mPosts == 0);
+        NL_TEST_ASSERT(inSuite, stats.mGets == 0);
+        NL_TEST_ASSERT(inSuite, stats.mRejections == 0);
+        NL_TEST_ASSERT(inSuite, stats.mPeakDepth == 0);
+
+        /* Posts, Including One to a Full Queue */
+
+        for (i = 0; i < event_count; i++)
+        {
+            nleventqueue_post_event(&test_queue, (nl_event_t *)&test_events[i]);
+        }
+
+        evp = nleventqueue_get_event_with_timeout(&test_queue, NLER_TIMEOUT_NOW);
+        NL_TEST_ASSERT(inSuite, evp != NULL);
+
+        evp = nleventqueue_get_event_with_timeout(&test_queue, NLER_TIMEOUT_NOW);
+        NL_TEST_ASSERT(inSuite, evp != NULL);
+
+        status = nleventqueue_get_stats(&test_queue, &stats);
+        NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+        NL_TEST_ASSERT(inSuite, stats.mPosts == 3);
+        NL_TEST_ASSERT(inSuite, stats.mGets == 2);
+        NL_TEST_ASSERT(inSuite, stats.mRejections == 1);
+        NL_TEST_ASSERT(inSuite, stats.mPeakDepth == 3);
+
+        /* Every Received Event Has a Sojourn Time */
+
+        histogram_total = 0;
+
+        for (i = 0; i < NLER_EVENTQUEUE_SOJOURN_BUCKETS; i++)
+        {
+            histogram_total += stats.mSojournHistogram[i];
+        }
+
+        NL_TEST_ASSERT(inSuite, histogram_total == stats.mGets);
+
+        /* Long Sojourn Times Land in Higher Buckets */
+
+        nltask_sleep_ms(5);
+
+        evp = nleventqueue_get_event_with_timeout(&test_queue, NLER_TIMEOUT_NOW);
+        NL_TEST_ASSERT(inSuite, evp != NULL);
+
+        status = nleventqueue_get_stats(&test_queue, &stats);
+        NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+        histogram_total = 0;
+
+        for (i = 13; i < NLER_EVENTQUEUE_SOJOURN_BUCKETS; i++)
+        {
+            histogram_total += stats.mSojournHistogram[i];
+        }
+
+        NL_TEST_ASSERT(inSuite, histogram_total >= 1);
+    }
+
+    /*
+     * Destruction
+     */
+
+    nleventqueue_destroy(&test_queue);
+}
+
+static void TestGetEvents(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *test_queuemem[4];
+    nleventqueue_t          test_queue;
+    nl_event_test_t         test_events[6] = {
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x1 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x2 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x3 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x4 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x5 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x6 }
+    };
+    nl_event_t             *evps[4];
+    int                     status;
+    uint32_t                count;
+    size_t                  i;
+
+    /*
+     * Creation
+     */
+
+    status = nleventqueue_create(&test_queuemem[0], sizeof (test_queuemem), &test_queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    /*
+     * Get Events
+     */
+
+    /* Empty Queue, No Events Expected */
+
+    count = nleventqueue_get_events(&test_queue, &evps[0], 4, NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, count == 0);
+
+    /* Partial Batch */
+
+    for (i = 0; i < 3; i++)
+    {
+        status = nleventqueue_post_event(&test_queue, (nl_event_t *)&test_events[i]);
+        NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+    }
+
+    count = nleventqueue_get_events(&test_queue, &evps[0], 2, NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, count == 2);
+    NL_TEST_ASSERT(inSuite, ((nl_event_test_t *)evps[0])->mIdentifier == 0x1);
+    NL_TEST_ASSERT(inSuite, ((nl_event_test_t *)evps[1])->mIdentifier == 0x2);
+
+    count = nleventqueue_get_count(&test_queue);
+    NL_TEST_ASSERT(inSuite, count == 1);
+
+    /* Wrap Around the End of the Queue Memory */
+
+    for (i = 3; i < 6; i++)
+    {
+        status = nleventqueue_post_event(&test_queue, (nl_event_t *)&test_events[i]);
+        NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+    }
+
+    count = nleventqueue_get_count(&test_queue);
+    NL_TEST_ASSERT(inSuite, count == 4);
+
+    count = nleventqueue_get_events(&test_queue, &evps[0], 4, NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, count == 4);
+
+    for (i = 0; i < count; i++)
+    {
+        NL_TEST_ASSERT(inSuite, ((nl_event_test_t *)evps[i])->mIdentifier == i + 3);
+    }
+
+    count = nleventqueue_get_count(&test_queue);
+    NL_TEST_ASSERT(inSuite, count == 0);
+
+    /*
+     * Destruction
+     */
+
+    nleventqueue_destroy(&test_queue);
+}
+
+static void TestPostEvents(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *test_queuemem[4];
+    nleventqueue_t          test_queue;
+    nl_event_test_t         test_events[6] = {
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x1 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x2 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x3 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x4 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x5 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x6 }
+    };
+    const nl_event_t       *batch[6];
+    nl_event_t             *evps[4];
+    int                     status;
+    uint32_t                count;
+    size_t                  i;
+
+    for (i = 0; i < 6; i++)
+    {
+        batch[i] = (nl_event_t *)&test_events[i];
+    }
+
+    /*
+     * Creation
+     */
+
+    status = nleventqueue_create(&test_queuemem[0], sizeof (test_queuemem), &test_queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    /*
+     * Post Events
+     */
+
+    /* Empty Batch */
+
+    count = nleventqueue_post_events(&test_queue, &batch[0], 0);
+    NL_TEST_ASSERT(inSuite, count == 0);
+
+    count = nleventqueue_get_count(&test_queue);
+    NL_TEST_ASSERT(inSuite, count == 0);
+
+    /* Whole Batch Fits */
+
+    count = nleventqueue_post_events(&test_queue, &batch[0], 2);
+    NL_TEST_ASSERT(inSuite, count == 2);
+
+    count = nleventqueue_get_events(&test_queue, &evps[0], 4, NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, count == 2);
+    NL_TEST_ASSERT(inSuite, ((nl_event_test_t *)evps[0])->mIdentifier == 0x1);
+    NL_TEST_ASSERT(inSuite, ((nl_event_test_t *)evps[1])->mIdentifier == 0x2);
+
+    /* Batch Larger Than the Space Left, Wrapping Around the End of
+     * the Queue Memory
+     */
+
+    status = nleventqueue_post_event(&test_queue, (nl_event_t *)&test_events[0]);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    count = nleventqueue_post_events(&test_queue, &batch[1], 5);
+    NL_TEST_ASSERT(inSuite, count == 3);
+
+    count = nleventqueue_get_events(&test_queue, &evps[0], 4, NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, count == 4);
+
+    for (i = 0; i < count; i++)
+    {
+        NL_TEST_ASSERT(inSuite, ((nl_event_test_t *)evps[i])->mIdentifier == i + 1);
+    }
+
+    count = nleventqueue_get_count(&test_queue);
+    NL_TEST_ASSERT(inSuite, count == 0);
+
+    /*
+     * Destruction
+     */
+
+    nleventqueue_destroy(&test_queue);
+}
+
+typedef struct nl_test_poster_s
+{
+    nleventqueue_t         *mQueue;
+    nl_event_t             *mEvent;
+    nl_time_ms_t            mDelayMS;
+} nl_test_poster_t;
+
+static nltask_t sPosterTask;
+static DEFINE_STACK(sPosterStack, NLER_TASK_STACK_BASE + 96);
+
+static void PosterTaskEntry(void *aParams)
+{
+    nl_test_poster_t       *poster = (nl_test_poster_t *)aParams;
+
+    nltask_sleep_ms(poster->mDelayMS);
+
+    nleventqueue_post_event(poster->mQueue, poster->mEvent);
+}
+
+static void TestGetEventPostedWhileBlocked(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *test_queuemem[5];
+    nleventqueue_t          test_queue;
+    nl_event_test_t         test_event = {
+        NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x1
+    };
+    nl_test_poster_t        poster;
+    nl_event_test_t        *evp;
+    int                     status;
+    nl_time_native_t        start_time, end_time;
+    nl_time_ms_t            delay_time_ms, delta_time_ms;
+
+    /*
+     * Creation
+     */
+
+    status = nleventqueue_create(&test_queuemem[0], sizeof (test_queuemem), &test_queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    /*
+     * Get Event with Timeout
+     */
+
+    /* Event Expected from Another Task While Blocked
+     */
+
+    poster.mQueue   = &test_queue;
+    poster.mEvent   = (nl_event_t *)&test_event;
+    poster.mDelayMS = 53;
+
+    status = nltask_create(PosterTaskEntry, "poster", sPosterStack, sizeof (sPosterStack),
+                           NLER_TASK_PRIORITY_NORMAL, &poster, &sPosterTask);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    start_time = nl_get_time_native();
+    delay_time_ms = 1009;
+
+    evp = (nl_event_test_t *)nleventqueue_get_event_with_timeout(&test_queue, delay_time_ms);
+
+    end_time = nl_get_time_native();
+    delta_time_ms = nl_time_native_to_time_ms(end_time - start_time);
+
+    NL_TEST_ASSERT(inSuite, evp != NULL);
+    NL_TEST_ASSERT(inSuite, evp->mIdentifier == 0x1);
+    NL_TEST_ASSERT(inSuite, delay_time_ms > delta_time_ms);
+
+    /*
+     * Destruction
+     */
+
+    nleventqueue_destroy(&test_queue);
+}
+
+static void TestSelect(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *control_queuemem[2];
+    nl_event_t             *data_queuemem[2];
+    nleventqueue_t          control_queue;
+    nleventqueue_t          data_queue;
+    nleventqueue_t         *queues[2] = { &control_queue, &data_queue };
+    nl_event_test_t         test_events[2] = {
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x1 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x2 }
+    };
+    nl_test_poster_t        poster;
+    nl_event_test_t        *evp;
+    int                     status;
+    nl_time_native_t        start_time, end_time;
+    nl_time_ms_t            delay_time_ms, delta_time_ms;
+
+    /*
+     * Creation
+     */
+
+    status = nleventqueue_create(&control_queuemem[0], sizeof (control_queuemem), &control_queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    status = nleventqueue_create(&data_queuemem[0], sizeof (data_queuemem), &data_queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    /*
+     * Select
+     */
+
+    /* Failure Cases
+     */
+
+    status = nleventqueue_select(NULL, 2, NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_BAD_INPUT);
+
+    status = nleventqueue_select(queues, 0, NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_BAD_INPUT);
+
+    /* Zero Timeout, No Event Expected */
+
+    status = nleventqueue_select(queues, 2, NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_NO_RESOURCE);
+
+    /* Non-zero Timeout, No Event Expected */
+
+    start_time = nl_get_time_native();
+    delay_time_ms = 101;
+
+    status = nleventqueue_select(queues, 2, delay_time_ms);
+
+    end_time = nl_get_time_native();
+    delta_time_ms = nl_time_native_to_time_ms(end_time - start_time);
+
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_NO_RESOURCE);
+    NL_TEST_ASSERT(inSuite, delay_time_ms <= delta_time_ms);
+
+    /* Event Pending on the Second Queue */
+
+    status = nleventqueue_post_event(&data_queue, (nl_event_t *)&test_events[1]);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    status = nleventqueue_select(queues, 2, NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, status == 1);
+
+    /* Events Pending on Both Queues, the First Takes Precedence */
+
+    status = nleventqueue_post_event(&control_queue, (nl_event_t *)&test_events[0]);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    status = nleventqueue_select(queues, 2, NLER_TIMEOUT_NEVER);
+    NL_TEST_ASSERT(inSuite, status == 0);
+
+    evp = (nl_event_test_t *)nleventqueue_get_event_with_timeout(queues[status], NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, evp != NULL);
+    NL_TEST_ASSERT(inSuite, evp->mIdentifier == 0x1);
+
+    evp = (nl_event_test_t *)nleventqueue_get_event_with_timeout(&data_queue, NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, evp != NULL);
+    NL_TEST_ASSERT(inSuite, evp->mIdentifier == 0x2);
+
+    /* Event Expected from Another Task While Blocked */
+
+    poster.mQueue   = &data_queue;
+    poster.mEvent   = (nl_event_t *)&test_events[1];
+    poster.mDelayMS = 53;
+
+    status = nltask_create(PosterTaskEntry, "poster", sPosterStack, sizeof (sPosterStack),
+                           NLER_TASK_PRIORITY_NORMAL, &poster, &sPosterTask);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    start_time = nl_get_time_native();
+    delay_time_ms = 1009;
+
+    status = nleventqueue_select(queues, 2, delay_time_ms);
+
+    end_time = nl_get_time_native();
+    delta_time_ms = nl_time_native_to_time_ms(end_time - start_time);
+
+    NL_TEST_ASSERT(inSuite, status == 1);
+    NL_TEST_ASSERT(inSuite, delay_time_ms > delta_time_ms);
+
+    evp = (nl_event_test_t *)nleventqueue_get_event_with_timeout(&data_queue, NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, evp != NULL);
+    NL_TEST_ASSERT(inSuite, evp->mIdentifier == 0x2);
+
+    /*
+     * Destruction
+     */
+
+    nleventqueue_destroy(&data_queue);
+    nleventqueue_destroy(&control_queue);
+}
+
+static void GetterTaskEntry(void *aParams)
+{
+    nl_test_poster_t       *getter = (nl_test_poster_t *)aParams;
+
+    nltask_sleep_ms(getter->mDelayMS);
+
+    nleventqueue_get_event_with_timeout(getter->mQueue, NLER_TIMEOUT_NOW);
+}
+
+static void TestPostEventWithTimeout(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *test_queuemem[2];
+    nleventqueue_t          test_queue;
+    nl_event_test_t         test_events[3] = {
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x1 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x2 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x3 }
+    };
+    nl_test_poster_t        getter;
+    nl_event_test_t        *evp;
+    int                     status;
+    uint32_t                count;
+    nl_time_native_t        start_time, end_time;
+    nl_time_ms_t            delay_time_ms, delta_time_ms;
+
+    /*
+     * Creation
+     */
+
+    status = nleventqueue_create(&test_queuemem[0], sizeof (test_queuemem), &test_queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    /*
+     * Post Event with Timeout
+     */
+
+    /* Space Available, Posted Immediately */
+
+    status = nleventqueue_post_event_with_timeout(&test_queue, (nl_event_t *)&test_events[0], NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    status = nleventqueue_post_event_with_timeout(&test_queue, (nl_event_t *)&test_events[1], NLER_TIMEOUT_NEVER);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    /* Zero Timeout, Queue Full */
+
+    status = nleventqueue_post_event_with_timeout(&test_queue, (nl_event_t *)&test_events[2], NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_NO_RESOURCE);
+
+    /* Non-zero Timeout, Queue Stays Full */
+
+    start_time = nl_get_time_native();
+    delay_time_ms = 101;
+
+    status = nleventqueue_post_event_with_timeout(&test_queue, (nl_event_t *)&test_events[2], delay_time_ms);
+
+    end_time = nl_get_time_native();
+    delta_time_ms = nl_time_native_to_time_ms(end_time - start_time);
+
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_NO_RESOURCE);
+    NL_TEST_ASSERT(inSuite, delay_time_ms <= delta_time_ms);
+
+    count = nleventqueue_get_count(&test_queue);
+    NL_TEST_ASSERT(inSuite, count == 2);
+
+    /* Space Freed by Another Task While Blocked */
+
+    getter.mQueue   = &test_queue;
+    getter.mEvent   = NULL;
+    getter.mDelayMS = 53;
+
+    status = nltask_create(GetterTaskEntry, "getter", sPosterStack, sizeof (sPosterStack),
+                           NLER_TASK_PRIORITY_NORMAL, &getter, &sPosterTask);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    start_time = nl_get_time_native();
+    delay_time_ms = 1009;
+
+    status = nleventqueue_post_event_with_timeout(&test_queue, (nl_event_t *)&test_events[2], delay_time_ms);
+
+    end_time = nl_get_time_native();
+    delta_time_ms = nl_time_native_to_time_ms(end_time - start_time);
+
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+    NL_TEST_ASSERT(inSuite, delay_time_ms > delta_time_ms);
+
+    /* Remaining Events Arrive in Order */
+
+    evp = (nl_event_test_t *)nleventqueue_get_event_with_timeout(&test_queue, NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, evp != NULL);
+    NL_TEST_ASSERT(inSuite, evp->mIdentifier == 0x2);
+
+    evp = (nl_event_test_t *)nleventqueue_get_event_with_timeout(&test_queue, NLER_TIMEOUT_NOW);
+    NL_TEST_ASSERT(inSuite, evp != NULL);
+    NL_TEST_ASSERT(inSuite, evp->mIdentifier == 0x3);
+
+    /*
+     * Destruction
+     */
+
+    nleventqueue_destroy(&test_queue);
+}
+
+#define kProducerCount          4
+#define kEventsPerProducer      256
+
+typedef struct nl_test_producer_s
+{
+    nleventqueue_t         *mQueue;
+    nl_event_test_t         mEvents[kEventsPerProducer];
+} nl_test_producer_t;
+
+static nl_test_producer_t sProducers[kProducerCount];
+static nltask_t sProducerTasks[kProducerCount];
+static DEFINE_STACK(sProducerStacks[kProducerCount], NLER_TASK_STACK_BASE + 96);
+
+static void ProducerTaskEntry(void *aParams)
+{
+    nl_test_producer_t     *producer = (nl_test_producer_t *)aParams;
+    size_t                  i;
+
+    for (i = 0; i < kEventsPerProducer; i++)
+    {
+        nleventqueue_post_event(producer->mQueue, (nl_event_t *)&producer->mEvents[i]);
+    }
+}
+
+static void TestMultipleProducers(nlTestSuite *inSuite, void *inContext)
+{
+    static nl_event_t      *test_queuemem[kProducerCount * kEventsPerProducer];
+    nleventqueue_t          test_queue;
+    uint32_t                next_identifier[kProducerCount];
+    nl_event_test_t        *evp;
+    int                     status;
+    uint32_t                count;
+    size_t                  i, j;
+
+    /*
+     * Creation
+     */
+
+    status = nleventqueue_create(&test_queuemem[0], sizeof (test_queuemem), &test_queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    /*
+     * Post Events from Several Tasks Concurrently
+     */
+
+    for (i = 0; i < kProducerCount; i++)
+    {
+        sProducers[i].mQueue = &test_queue;
+
+        for (j = 0; j < kEventsPerProducer; j++)
+        {
+            sProducers[i].mEvents[j].mType        = NL_EVENT_T_TEST;
+            sProducers[i].mEvents[j].mIdentifier  = (uint32_t)((i << 16) | j);
+        }
+
+        next_identifier[i] = 0;
+    }
+
+    for (i = 0; i < kProducerCount; i++)
+    {
+        status = nltask_create(ProducerTaskEntry, "producer", sProducerStacks[i], sizeof (sProducerStacks[i]),
+                               NLER_TASK_PRIORITY_NORMAL, &sProducers[i], &sProducerTasks[i]);
+        NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+    }
+
+    /*
+     * Get Events
+     */
+
+    /* Every event arrives exactly once and in order per producer */
+
+    for (i = 0; i < (kProducerCount * kEventsPerProducer); i++)
+    {
+        evp = (nl_event_test_t *)nleventqueue_get_event_with_timeout(&test_queue, 1009);
+        NL_TEST_ASSERT(inSuite, evp != NULL);
+
+        if (evp == NULL)
+            break;
+
+        j = evp->mIdentifier >> 16;
+        NL_TEST_ASSERT(inSuite, j < kProducerCount);
+
+        if (j >= kProducerCount)
+            break;
+
+        NL_TEST_ASSERT(inSuite, (evp->mIdentifier & 0xffff) == next_identifier[j]);
+        next_identifier[j]++;
+    }
+
+    count = nleventqueue_get_count(&test_queue);
+    NL_TEST_ASSERT(inSuite, count == 0);
+
+    /*
+     * Destruction
+     */
+
+    nleventqueue_destroy(&test_queue);
+}
+
+#if defined(__linux__)
+static bool IsPollableFdReadable(int aFd)
+{
+    struct pollfd pfd = { aFd, POLLIN, 0 };
+
+    return ((poll(&pfd, 1, 0) == 1) && ((pfd.revents & POLLIN) != 0));
+}
+#endif
+
+static void TestGetPollableFd(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *test_queuemem[3];
+    nleventqueue_t          test_queue;
+    nl_event_test_t         test_events[2] = {
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x1 },
+        { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL), 0x2 }
+    };
+    nl_event_t             *evp;
+    int                     status;
+    int                     fd;
+
+    /*
+     * Creation
+     */
+
+    status = nleventqueue_create(&test_queuemem[0], sizeof (test_queuemem), &test_queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    /*
+     * Get Pollable Fd
+     */
+
+    /* Not Supported On All Platforms */
+
+    fd = nleventqueue_get_pollable_fd(&test_queue);
+    NL_TEST_ASSERT(inSuite, (fd >= 0) || (fd == NLER_ERROR_NOT_IMPLEMENTED));
+
+#if defined(__linux__)
+    if (fd >= 0)
+    {
+        /* Same Descriptor Each Time */
+
+        status = nleventqueue_get_pollable_fd(&test_queue);
+        NL_TEST_ASSERT(inSuite, status == fd);
+
+        /* Empty Queue */
+
+        NL_TEST_ASSERT(inSuite, !IsPollableFdReadable(fd));
+
+        /* Readable While Events Are Pending */
+
+        status = nleventqueue_post_event(&test_queue, (nl_event_t *)&test_events[0]);
+        NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+        NL_TEST_ASSERT(inSuite, IsPollableFdReadable(fd));
+
+        status = nleventqueue_post_event(&test_queue, (nl_event_t *)&test_events[1]);
+        NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+        evp = nleventqueue_get_event_with_timeout(&test_queue, NLER_TIMEOUT_NOW);
+        NL_TEST_ASSERT(inSuite, evp == (nl_event_t *)&test_events[0]);
+
+        NL_TEST_ASSERT(inSuite, IsPollableFdReadable(fd));
+
+        /* Not Readable Once Drained */
+
+        evp = nleventqueue_get_event_with_timeout(&test_queue, NLER_TIMEOUT_NOW);
+        NL_TEST_ASSERT(inSuite, evp == (nl_event_t *)&test_events[1]);
+
+        NL_TEST_ASSERT(inSuite, !IsPollableFdReadable(fd));
+    }
+#else
+    (void)test_events;
+    (void)evp;
+#endif
+
+    /*
+     * Destruction
+     */
+
+    nleventqueue_destroy(&test_queue);
+}
+
 static const nlTest sTests[] = {
     NL_TEST_DEF("create and destroy",      TestCreateAndDestroy),
     NL_TEST_DEF("get count"         ,      TestGetCount),
@@ -522,6 +1609,17 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("post event",              TestPostEvent),
     NL_TEST_DEF("get event",               TestGetEvent),
     NL_TEST_DEF("get event with timeout",  TestGetEventWithTimeout),
+    NL_TEST_DEF("get event posted while blocked", TestGetEventPostedWhileBlocked),
+    NL_TEST_DEF("post event urgent",       TestPostEventUrgent),
+    NL_TEST_DEF("get events",              TestGetEvents),
+    NL_TEST_DEF("post events",             TestPostEvents),
+    NL_TEST_DEF("multiple producers",      TestMultipleProducers),
+    NL_TEST_DEF("select",                  TestSelect),
+    NL_TEST_DEF("post event with timeout", TestPostEventWithTimeout),
+    NL_TEST_DEF("overflow policy",         TestOverflowPolicy),
+    NL_TEST_DEF("watermarks",              TestWatermarks),
+    NL_TEST_DEF("get stats",               TestGetStats),
+    NL_TEST_DEF("get pollable fd",         TestGetPollableFd),
     NL_TEST_SENTINEL()
 };
 
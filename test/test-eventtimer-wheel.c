@@ -0,0 +1,786 @@
+/*
+ *
+ *    Copyright (c) 2020 Project nler Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test for the expiry handling of the
+ *      NLER event timer task. Rather than running the timer task, the
+ *      test drives its passes directly against a time of its own, such
+ *      that every deadline is hit exactly.
+ *
+ */
+
+/* Batches small enough to be flushed within a pass, and, where the
+ * timer task may be sharded, two shards.
+ */
+#define NLER_TIMER_BATCH_SIZE                 4
+#if !NLER_FEATURE_SIMULATEABLE_TIME
+#define NLER_TIMER_SHARDS                     2
+#endif
+
+#define nl_get_time_native                    ut_nl_get_time_native
+#define nltask_create                         ut_nltask_create
+
+#include "../shared/nlerevent_timer.c"
+
+#if NLER_FEATURE_EVENT_TIMER && !NLER_FEATURE_TIMER_USING_SWTIMER
+
+#include <stdlib.h>
+
+#include <nlerinit.h>
+
+#include <nlunit-test.h>
+
+#define kPERIOD_MS           10
+#define kTIMERS              6
+#define kQUEUES              4
+#define kCANDIDATE_QUEUES    32
+
+static nl_time_native_t sNow;
+
+nl_time_native_t ut_nl_get_time_native(void)
+{
+    return sNow;
+}
+
+/* The timer tasks are never run; the test runs their passes itself.
+ */
+int ut_nltask_create(nltask_entry_point_t aEntry, const char *aName, void *aStack, size_t aStackSize,
+                     nltask_priority_t aPriority, void *aParams, nltask_t *aTask)
+{
+    (void)aEntry;
+    (void)aName;
+    (void)aStack;
+    (void)aStackSize;
+    (void)aPriority;
+    (void)aParams;
+    (void)aTask;
+
+    return NLER_SUCCESS;
+}
+
+/* Run a pass of every timer task at the current time: take what was
+ * posted to it, then handle the expiries as its timeout would.
+ */
+static void run_timer_tasks(void)
+{
+    nl_event_t *ev;
+    unsigned i;
+
+    for (i = 0; i < NLER_TIMER_SHARDS; i++)
+    {
+        while ((ev = nleventqueue_get_event_with_timeout(&sShards[i].mQueue, 0)) != NULL)
+        {
+            nl_timer_eventhandler(&sShards[i], ev);
+        }
+
+        nl_timer_eventhandler(&sShards[i], NULL);
+    }
+}
+
+static void advance_to(nl_time_ms_t aTimeMS)
+{
+    sNow = nl_time_ms_to_time_native(aTimeMS);
+
+    run_timer_tasks();
+}
+
+/* Pass the deadlines the timers were last cancelled ahead of, such
+ * that the timer tasks let go of them before their memory is reused.
+ */
+static void release_cancelled(void)
+{
+    advance_to(nl_time_native_to_time_ms(sNow) + kPERIOD_MS * 2);
+}
+
+/* Receive the next event on a queue, and check it is the timer's and
+ * valid, with the overruns given.
+ */
+static void receive_event(nlTestSuite *inSuite, nleventqueue_t *aQueue, nl_event_timer_t *aTimer, uint32_t aOverrun)
+{
+    nl_event_t *ev;
+
+    ev = nleventqueue_get_event_with_timeout(aQueue, 0);
+    NL_TEST_ASSERT(inSuite, ev == (nl_event_t *)aTimer);
+
+    if (ev == (nl_event_t *)aTimer)
+    {
+        NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(aTimer) == true);
+        NL_TEST_ASSERT(inSuite, nl_event_timer_get_overrun(aTimer) == aOverrun);
+    }
+}
+
+/* Likewise for the one event expected on a queue.
+ */
+static void check_event(nlTestSuite *inSuite, nleventqueue_t *aQueue, nl_event_timer_t *aTimer, uint32_t aOverrun)
+{
+    receive_event(inSuite, aQueue, aTimer, aOverrun);
+
+    NL_TEST_ASSERT(inSuite, nleventqueue_get_event_with_timeout(aQueue, 0) == NULL);
+}
+
+static void check_no_event(nlTestSuite *inSuite, nleventqueue_t *aQueue)
+{
+    NL_TEST_ASSERT(inSuite, nleventqueue_get_event_with_timeout(aQueue, 0) == NULL);
+}
+
+static int count_handler(nl_event_t *aEvent, void *aClosure)
+{
+    (void)aEvent;
+
+    (*(unsigned *)aClosure)++;
+
+    return NLER_SUCCESS;
+}
+
+static void TestNoDrift(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *queuemem[4];
+    nleventqueue_t          queue;
+    nl_event_timer_t        timer;
+
+    nleventqueue_create(&queuemem[0], sizeof (queuemem), &queue);
+
+    nl_event_timer_init(&timer, NULL, NULL, &queue);
+
+    advance_to(1000);
+
+    nl_event_timer_start_at(&timer, sNow + nl_time_ms_to_time_native(kPERIOD_MS), kPERIOD_MS, NL_EVENT_TIMER_REPEAT_SKIP);
+
+    advance_to(1000 + kPERIOD_MS - 1);
+    check_no_event(inSuite, &queue);
+
+    /* Handled late, the first expiry does not push back the next.
+     */
+
+    advance_to(1000 + kPERIOD_MS + 3);
+    check_event(inSuite, &queue, &timer, 0);
+
+    advance_to(1000 + kPERIOD_MS * 2 - 1);
+    check_no_event(inSuite, &queue);
+
+    advance_to(1000 + kPERIOD_MS * 2);
+    check_event(inSuite, &queue, &timer, 0);
+
+    advance_to(1000 + kPERIOD_MS * 3);
+    check_event(inSuite, &queue, &timer, 0);
+
+    nl_event_timer_cancel(&timer);
+
+    advance_to(1000 + kPERIOD_MS * 5);
+    check_no_event(inSuite, &queue);
+
+    nleventqueue_destroy(&queue);
+}
+
+static void TestSkipMissed(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *queuemem[4];
+    nleventqueue_t          queue;
+    nl_event_timer_t        timer;
+
+    nleventqueue_create(&queuemem[0], sizeof (queuemem), &queue);
+
+    nl_event_timer_init(&timer, NULL, NULL, &queue);
+
+    advance_to(2000);
+
+    nl_event_timer_start_at(&timer, sNow + nl_time_ms_to_time_native(kPERIOD_MS), kPERIOD_MS, NL_EVENT_TIMER_REPEAT_SKIP);
+
+    /* Three and a half periods late: one event, the deadlines 20, 30
+     * and 40 ms in counted as its overruns, and the next at 50 ms in.
+     */
+
+    advance_to(2000 + kPERIOD_MS * 4 + kPERIOD_MS / 2);
+    check_event(inSuite, &queue, &timer, 3);
+
+    advance_to(2000 + kPERIOD_MS * 5 - 1);
+    check_no_event(inSuite, &queue);
+
+    advance_to(2000 + kPERIOD_MS * 5);
+    check_event(inSuite, &queue, &timer, 0);
+
+    nl_event_timer_cancel(&timer);
+
+    release_cancelled();
+
+    nleventqueue_destroy(&queue);
+}
+
+static void TestCatchUp(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *queuemem[4];
+    nleventqueue_t          queue;
+    nl_event_timer_t        timer;
+    nl_event_timer_t        callback;
+    unsigned                count = 0;
+
+    nleventqueue_create(&queuemem[0], sizeof (queuemem), &queue);
+
+    nl_event_timer_init(&timer, NULL, NULL, &queue);
+    nl_event_timer_init_callback(&callback, count_handler, &count);
+
+    advance_to(3000);
+
+    nl_event_timer_start_at(&timer, sNow + nl_time_ms_to_time_native(kPERIOD_MS), kPERIOD_MS, NL_EVENT_TIMER_REPEAT_CATCH_UP);
+    nl_event_timer_start_at(&callback, sNow + nl_time_ms_to_time_native(kPERIOD_MS), kPERIOD_MS, NL_EVENT_TIMER_REPEAT_CATCH_UP);
+
+    /* Three and a half periods late, the callback timer is called for
+     * each of the four periods, while the queued timer, having one
+     * event at most, counts the three it missed as overruns.
+     */
+
+    advance_to(3000 + kPERIOD_MS * 4 + kPERIOD_MS / 2);
+    NL_TEST_ASSERT(inSuite, count == 4);
+    check_event(inSuite, &queue, &timer, 3);
+
+    /* Both carry on from the deadlines they caught up to.
+     */
+
+    advance_to(3000 + kPERIOD_MS * 5 - 1);
+    NL_TEST_ASSERT(inSuite, count == 4);
+    check_no_event(inSuite, &queue);
+
+    advance_to(3000 + kPERIOD_MS * 5);
+    NL_TEST_ASSERT(inSuite, count == 5);
+    check_event(inSuite, &queue, &timer, 0);
+
+    nl_event_timer_cancel(&timer);
+    nl_event_timer_cancel(&callback);
+
+    advance_to(3000 + kPERIOD_MS * 7);
+    NL_TEST_ASSERT(inSuite, count == 5);
+    check_no_event(inSuite, &queue);
+
+    nleventqueue_destroy(&queue);
+}
+
+static void TestStartAtPast(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *queuemem[4];
+    nleventqueue_t          queue;
+    nl_event_timer_t        oneshot;
+    nl_event_timer_t        repeating;
+
+    nleventqueue_create(&queuemem[0], sizeof (queuemem), &queue);
+
+    nl_event_timer_init(&oneshot, NULL, NULL, &queue);
+    nl_event_timer_init(&repeating, NULL, NULL, &queue);
+
+    advance_to(4000);
+
+    /* A deadline already past expires on the next tick, once.
+     */
+
+    nl_event_timer_start_at(&oneshot, sNow - nl_time_ms_to_time_native(kPERIOD_MS / 2), 0, NL_EVENT_TIMER_ONE_SHOT);
+
+    advance_to(4001);
+    check_event(inSuite, &queue, &oneshot, 0);
+
+    advance_to(4000 + kPERIOD_MS * 3);
+    check_no_event(inSuite, &queue);
+
+    /* A repeating timer whose first deadline, at 4025, is past also
+     * expires on the next tick, and carries on from its own deadlines.
+     */
+
+    nl_event_timer_start_at(&repeating, sNow - nl_time_ms_to_time_native(kPERIOD_MS / 2), kPERIOD_MS, NL_EVENT_TIMER_REPEAT_SKIP);
+
+    advance_to(4000 + kPERIOD_MS * 3 + 1);
+    check_event(inSuite, &queue, &repeating, 0);
+
+    advance_to(4000 + kPERIOD_MS * 3 + kPERIOD_MS / 2 - 1);
+    check_no_event(inSuite, &queue);
+
+    advance_to(4000 + kPERIOD_MS * 3 + kPERIOD_MS / 2);
+    check_event(inSuite, &queue, &repeating, 0);
+
+    nl_event_timer_cancel(&repeating);
+
+    release_cancelled();
+
+    nleventqueue_destroy(&queue);
+}
+
+static void TestAtMostOneQueued(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *queuemem[4];
+    nleventqueue_t          queue;
+    nl_event_timer_t        timer;
+
+    nleventqueue_create(&queuemem[0], sizeof (queuemem), &queue);
+
+    nl_event_timer_init(&timer, NULL, NULL, &queue);
+
+    advance_to(5000);
+
+    nl_event_timer_start_at(&timer, sNow + nl_time_ms_to_time_native(kPERIOD_MS), kPERIOD_MS, NL_EVENT_TIMER_REPEAT_SKIP);
+
+    /* Expiring on three passes with its event not yet received, the
+     * timer still has the one event queued, with the two later
+     * expiries as its overruns.
+     */
+
+    advance_to(5000 + kPERIOD_MS);
+    advance_to(5000 + kPERIOD_MS * 2);
+    advance_to(5000 + kPERIOD_MS * 3);
+    check_event(inSuite, &queue, &timer, 2);
+
+    advance_to(5000 + kPERIOD_MS * 4);
+    check_event(inSuite, &queue, &timer, 0);
+
+    nl_event_timer_cancel(&timer);
+
+    release_cancelled();
+
+    nleventqueue_destroy(&queue);
+}
+
+static void TestOverrunLatched(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *queuemem[4];
+    nleventqueue_t          queue;
+    nl_event_timer_t        timer;
+    nl_event_t             *ev;
+
+    nleventqueue_create(&queuemem[0], sizeof (queuemem), &queue);
+
+    nl_event_timer_init(&timer, NULL, NULL, &queue);
+
+    advance_to(6000);
+
+    nl_event_timer_start_at(&timer, sNow + nl_time_ms_to_time_native(kPERIOD_MS), kPERIOD_MS, NL_EVENT_TIMER_REPEAT_SKIP);
+
+    advance_to(6000 + kPERIOD_MS);
+    advance_to(6000 + kPERIOD_MS * 2);
+    advance_to(6000 + kPERIOD_MS * 3);
+
+    ev = nleventqueue_get_event_with_timeout(&queue, 0);
+    NL_TEST_ASSERT(inSuite, ev == (nl_event_t *)&timer);
+    NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer) == true);
+
+    /* The overruns of the event checked stay put while those of the
+     * next event pile up.
+     */
+
+    advance_to(6000 + kPERIOD_MS * 4);
+    advance_to(6000 + kPERIOD_MS * 5);
+    NL_TEST_ASSERT(inSuite, nl_event_timer_get_overrun(&timer) == 2);
+
+    check_event(inSuite, &queue, &timer, 1);
+
+    /* An event found invalid has none, whatever it had counted.
+     */
+
+    advance_to(6000 + kPERIOD_MS * 6);
+    advance_to(6000 + kPERIOD_MS * 7);
+
+    nl_event_timer_cancel(&timer);
+
+    ev = nleventqueue_get_event_with_timeout(&queue, 0);
+    NL_TEST_ASSERT(inSuite, ev == (nl_event_t *)&timer);
+    NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer) == false);
+    NL_TEST_ASSERT(inSuite, nl_event_timer_get_overrun(&timer) == 0);
+
+    check_no_event(inSuite, &queue);
+
+    release_cancelled();
+
+    nleventqueue_destroy(&queue);
+}
+
+static void TestOverrunFull(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *queuemem[1];
+    nleventqueue_t          queue;
+    nl_event_timer_t        first;
+    nl_event_timer_t        second;
+
+    nleventqueue_create(&queuemem[0], sizeof (queuemem), &queue);
+
+    nl_event_timer_init(&first, NULL, NULL, &queue);
+    nl_event_timer_init(&second, NULL, NULL, &queue);
+
+    advance_to(7000);
+
+    nl_event_timer_start_at(&first, sNow + nl_time_ms_to_time_native(kPERIOD_MS), 0, NL_EVENT_TIMER_ONE_SHOT);
+    nl_event_timer_start_at(&second, sNow + nl_time_ms_to_time_native(kPERIOD_MS + 1), kPERIOD_MS, NL_EVENT_TIMER_REPEAT_SKIP);
+
+    /* Both expire in one pass and are posted together to a queue with
+     * room for one. The expiry that did not fit comes with the next
+     * event of its timer as an overrun.
+     */
+
+    advance_to(7000 + kPERIOD_MS + kPERIOD_MS / 2);
+    check_event(inSuite, &queue, &first, 0);
+
+    advance_to(7000 + kPERIOD_MS * 2 + 1);
+    check_event(inSuite, &queue, &second, 1);
+
+    nl_event_timer_cancel(&second);
+
+    release_cancelled();
+
+    nleventqueue_destroy(&queue);
+}
+
+static void TestOverrunSaturates(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *queuemem[4];
+    nleventqueue_t          queue;
+    nl_event_timer_t        timer;
+
+    nleventqueue_create(&queuemem[0], sizeof (queuemem), &queue);
+
+    nl_event_timer_init(&timer, NULL, NULL, &queue);
+
+    advance_to(10000);
+
+    nl_event_timer_start_at(&timer, sNow + 1, 1, NL_EVENT_TIMER_REPEAT_SKIP);
+
+    /* More periods missed in one pass than the count holds.
+     */
+
+    advance_to(10000 + UINT16_MAX + 5000);
+    check_event(inSuite, &queue, &timer, UINT16_MAX);
+
+    advance_to(10000 + UINT16_MAX + 5001);
+    check_event(inSuite, &queue, &timer, 0);
+
+    nl_event_timer_cancel(&timer);
+
+    release_cancelled();
+
+    nleventqueue_destroy(&queue);
+}
+
+static void TestExpiryOrder(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *queuemem[kTIMERS + 2];
+    nleventqueue_t          queue;
+    nl_event_t             *othermem[2];
+    nleventqueue_t          other;
+    nl_event_timer_t        timers[kTIMERS];
+    nl_event_timer_t        interleaved;
+    int                     i;
+
+    nleventqueue_create(&queuemem[0], sizeof (queuemem), &queue);
+    nleventqueue_create(&othermem[0], sizeof (othermem), &other);
+
+    for (i = 0; i < kTIMERS; i++)
+    {
+        nl_event_timer_init(&timers[i], NULL, NULL, &queue);
+    }
+
+    nl_event_timer_init(&interleaved, NULL, NULL, &other);
+
+    advance_to(90000);
+
+    /* Started latest first, and with one for another queue amid them,
+     * timers all expiring in one pass, over more than one batch, are
+     * received in the order of their deadlines.
+     */
+
+    for (i = kTIMERS - 1; i >= 0; i--)
+    {
+        nl_event_timer_start_at(&timers[i], sNow + nl_time_ms_to_time_native(kPERIOD_MS + i), 0, NL_EVENT_TIMER_ONE_SHOT);
+    }
+
+    nl_event_timer_start_at(&interleaved, sNow + nl_time_ms_to_time_native(kPERIOD_MS + 1), 0, NL_EVENT_TIMER_ONE_SHOT);
+
+    advance_to(90000 + kPERIOD_MS * 2);
+
+    for (i = 0; i < kTIMERS; i++)
+    {
+        receive_event(inSuite, &queue, &timers[i], 0);
+    }
+
+    check_no_event(inSuite, &queue);
+
+    check_event(inSuite, &other, &interleaved, 0);
+
+    nleventqueue_destroy(&other);
+    nleventqueue_destroy(&queue);
+}
+
+static void TestOverrunFullBatches(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *queuemem[kTIMERS / 2];
+    nleventqueue_t          queue;
+    nl_event_timer_t        timers[kTIMERS];
+    int                     i;
+
+    nleventqueue_create(&queuemem[0], sizeof (queuemem), &queue);
+
+    for (i = 0; i < kTIMERS; i++)
+    {
+        nl_event_timer_init(&timers[i], NULL, NULL, &queue);
+    }
+
+    advance_to(95000);
+
+    for (i = 0; i < kTIMERS; i++)
+    {
+        nl_event_timer_start_at(&timers[i], sNow + nl_time_ms_to_time_native(kPERIOD_MS + i), kPERIOD_MS, NL_EVENT_TIMER_REPEAT_SKIP);
+    }
+
+    /* Of the expiries of one pass, posted over two batches, those that
+     * find the queue full, whether in the first batch or the whole of
+     * the second, are each counted as an overrun of their timer.
+     */
+
+    advance_to(95000 + kPERIOD_MS + kTIMERS);
+
+    for (i = 0; i < kTIMERS / 2; i++)
+    {
+        receive_event(inSuite, &queue, &timers[i], 0);
+
+        nl_event_timer_cancel(&timers[i]);
+    }
+
+    check_no_event(inSuite, &queue);
+
+    advance_to(95000 + kPERIOD_MS * 2 + kTIMERS);
+
+    for (i = kTIMERS / 2; i < kTIMERS; i++)
+    {
+        receive_event(inSuite, &queue, &timers[i], 1);
+
+        nl_event_timer_cancel(&timers[i]);
+    }
+
+    check_no_event(inSuite, &queue);
+
+    release_cancelled();
+
+    nleventqueue_destroy(&queue);
+}
+
+static void TestShards(nlTestSuite *inSuite, void *inContext)
+{
+    static nleventqueue_t   candidates[kCANDIDATE_QUEUES];
+    nl_event_t             *queuemem[kQUEUES][kTIMERS];
+    nleventqueue_t         *queues[kQUEUES];
+    nl_event_timer_t        timers[kQUEUES][kTIMERS];
+    nl_event_timer_internal_t probe;
+    bool                    used[NLER_TIMER_SHARDS] = { false };
+    unsigned                shards = 0;
+    int                     i;
+    int                     j;
+    int                     q;
+
+    /* Take queues hashing to each shard in turn, so that every shard
+     * serves some.
+     */
+
+    for (q = 0, i = 0; (q < kQUEUES) && (i < kCANDIDATE_QUEUES); i++)
+    {
+        probe.mReturnQueue = &candidates[i];
+
+        if (shard_for_timer(&probe) == &sShards[q % NLER_TIMER_SHARDS])
+        {
+            queues[q++] = &candidates[i];
+        }
+    }
+
+    NL_TEST_ASSERT(inSuite, q == kQUEUES);
+
+    if (q != kQUEUES)
+    {
+        return;
+    }
+
+    for (q = 0; q < kQUEUES; q++)
+    {
+        nleventqueue_create(&queuemem[q][0], sizeof (queuemem[q]), queues[q]);
+
+        for (j = 0; j < kTIMERS; j++)
+        {
+            nl_event_timer_init(&timers[q][j], NULL, NULL, queues[q]);
+        }
+
+        probe.mReturnQueue = queues[q];
+        i = (int)(shard_for_timer(&probe) - &sShards[0]);
+
+        if (!used[i])
+        {
+            used[i] = true;
+            shards++;
+        }
+    }
+
+    NL_TEST_ASSERT(inSuite, shards == ((NLER_TIMER_SHARDS > 1) ? 2 : 1));
+
+    advance_to(100000);
+
+    /* Started latest first, queue by queue, with every other timer
+     * cancelled, restarted with a later deadline, or both.
+     */
+
+    for (j = kTIMERS - 1; j >= 0; j--)
+    {
+        for (q = 0; q < kQUEUES; q++)
+        {
+            nl_event_timer_start_at(&timers[q][j], sNow + nl_time_ms_to_time_native(kPERIOD_MS + j), 0, NL_EVENT_TIMER_ONE_SHOT);
+        }
+    }
+
+    for (q = 0; q < kQUEUES; q++)
+    {
+        nl_event_timer_cancel(&timers[q][1]);
+
+        nl_event_timer_start_at(&timers[q][2], sNow + nl_time_ms_to_time_native(kPERIOD_MS + kTIMERS), 0, NL_EVENT_TIMER_ONE_SHOT);
+
+        nl_event_timer_cancel(&timers[q][4]);
+        nl_event_timer_start_at(&timers[q][4], sNow + nl_time_ms_to_time_native(kPERIOD_MS + kTIMERS + 1), 0, NL_EVENT_TIMER_ONE_SHOT);
+    }
+
+    advance_to(100000 + kPERIOD_MS * 2);
+
+    /* Each queue receives its own timers, in the order of their
+     * deadlines.
+     */
+
+    for (q = 0; q < kQUEUES; q++)
+    {
+        receive_event(inSuite, queues[q], &timers[q][0], 0);
+        receive_event(inSuite, queues[q], &timers[q][3], 0);
+        receive_event(inSuite, queues[q], &timers[q][5], 0);
+        receive_event(inSuite, queues[q], &timers[q][2], 0);
+        receive_event(inSuite, queues[q], &timers[q][4], 0);
+        check_no_event(inSuite, queues[q]);
+
+        nleventqueue_destroy(queues[q]);
+    }
+}
+
+static void TestCancelLeavesStale(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *queuemem[4];
+    nleventqueue_t          queue;
+    nl_event_timer_t        timer;
+    nl_timer_wheel_link_t  *link = &((nl_event_timer_internal_t *)&timer)->mWheelLink;
+
+    nleventqueue_create(&queuemem[0], sizeof (queuemem), &queue);
+
+    nl_event_timer_init(&timer, NULL, NULL, &queue);
+
+    advance_to(110000);
+
+    nl_event_timer_start_at(&timer, sNow + nl_time_ms_to_time_native(kPERIOD_MS), kPERIOD_MS, NL_EVENT_TIMER_REPEAT_SKIP);
+
+    advance_to(110000 + 1);
+    NL_TEST_ASSERT(inSuite, nl_timer_wheel_is_pending(link));
+
+    /* Cancelled with no pass of the timer task, the run stays in the
+     * wheel until its deadline is passed, and is then dropped as stale
+     * without an event.
+     */
+
+    nl_event_timer_cancel(&timer);
+    NL_TEST_ASSERT(inSuite, nl_timer_wheel_is_pending(link));
+
+    advance_to(110000 + kPERIOD_MS);
+    check_no_event(inSuite, &queue);
+    NL_TEST_ASSERT(inSuite, !nl_timer_wheel_is_pending(link));
+
+    /* Started again at once, before the timer task has passed the
+     * run cancelled, only the new run expires.
+     */
+
+    nl_event_timer_start_at(&timer, sNow + nl_time_ms_to_time_native(kPERIOD_MS), 0, NL_EVENT_TIMER_ONE_SHOT);
+
+    advance_to(110000 + kPERIOD_MS + 1);
+
+    nl_event_timer_cancel(&timer);
+    nl_event_timer_start_at(&timer, sNow + nl_time_ms_to_time_native(kPERIOD_MS * 2), 0, NL_EVENT_TIMER_ONE_SHOT);
+
+    advance_to(110000 + kPERIOD_MS * 2 + 1);
+    check_no_event(inSuite, &queue);
+
+    advance_to(110000 + kPERIOD_MS * 3 + 1);
+    check_event(inSuite, &queue, &timer, 0);
+    NL_TEST_ASSERT(inSuite, !nl_timer_wheel_is_pending(link));
+
+    nleventqueue_destroy(&queue);
+}
+
+static const nlTest sTests[] = {
+    NL_TEST_DEF("no drift",                   TestNoDrift),
+    NL_TEST_DEF("skip missed",                TestSkipMissed),
+    NL_TEST_DEF("catch up",                   TestCatchUp),
+    NL_TEST_DEF("start at past",              TestStartAtPast),
+    NL_TEST_DEF("at most one queued",         TestAtMostOneQueued),
+    NL_TEST_DEF("overrun latched",            TestOverrunLatched),
+    NL_TEST_DEF("overrun on full queue",      TestOverrunFull),
+    NL_TEST_DEF("overrun saturates",          TestOverrunSaturates),
+    NL_TEST_DEF("expiry order",               TestExpiryOrder),
+    NL_TEST_DEF("overrun on full batches",    TestOverrunFullBatches),
+    NL_TEST_DEF("shards",                     TestShards),
+    NL_TEST_DEF("cancel leaves stale run",    TestCancelLeavesStale),
+    NL_TEST_SENTINEL()
+};
+
+int nler_eventtimer_wheel_test(void)
+{
+    nlTestSuite theSuite = {
+        "nlereventtimer-wheel",
+        &sTests[0]
+    };
+
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+}
+
+int main(int argc, char **argv)
+{
+    int status;
+
+    nl_er_init();
+
+    NL_LOG_CRIT(lrTEST, "start main\n");
+
+    nl_er_start_running();
+
+    nl_timer_start(NLER_TASK_PRIORITY_HIGH);
+
+    status = nler_eventtimer_wheel_test();
+
+    nl_er_cleanup();
+
+    NL_LOG_CRIT(lrTEST, "end main\n");
+
+    return (status);
+}
+
+#else /* NLER_FEATURE_EVENT_TIMER && !NLER_FEATURE_TIMER_USING_SWTIMER */
+
+/* The swtimer implementation has no timer task to drive.
+ */
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    return 0;
+}
+
+#endif /* NLER_FEATURE_EVENT_TIMER && !NLER_FEATURE_TIMER_USING_SWTIMER */
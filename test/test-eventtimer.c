@@ -0,0 +1,447 @@
+/*
+ *
+ *    Copyright (c) 2020 Project nler Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test for starting, restarting and
+ *      cancelling NLER event timers, queued and callback, served by
+ *      the timer task.
+ *
+ */
+
+#include <nlerevent_timer.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef nlLOG_PRIORITY
+#undef nlLOG_PRIORITY
+#endif
+#define nlLOG_PRIORITY 1
+
+#include <nleratomicops.h>
+#include <nlererror.h>
+#include <nlerinit.h>
+#include <nlerlog.h>
+#include <nlertask.h>
+#if NLER_FEATURE_SIMULATEABLE_TIME
+#include <nlertimer_sim.h>
+#endif
+
+#include <nlunit-test.h>
+
+#define NL_EVENT_T_TEST (NL_EVENT_T_WM_USER + 1)
+
+/* Periods are kept well above a tick, such that a repeating timer
+ * leaves the other tasks time to run.
+ */
+#define kTIMEOUT_MS          10
+#define kWAIT_MS             200
+
+/* Long enough for a timer to have expired however loaded the machine.
+ */
+#define kEXPIRY_WAIT_MS      2000
+
+#define kRESTART_ROUNDS      64
+
+/* The tasks cancelling timers run above the timer task, such that
+ * their cancels and restarts never have the timer task's help.
+ */
+#define kCANCEL_PRIORITY     (NLER_TASK_PRIORITY_HIGH + 2)
+
+static nltask_t sCancelTask;
+static DEFINE_STACK(sCancelStack, NLER_TASK_STACK_BASE + 128);
+static nltask_t sRestartTask;
+static DEFINE_STACK(sRestartStack, NLER_TASK_STACK_BASE + 128);
+
+typedef struct cancel_context_s
+{
+    nl_event_timer_t   *mTimer;
+    nleventqueue_t     *mQueue;
+    nl_event_t          mDone;
+    int32_t             mReceived;
+} cancel_context_t;
+
+typedef struct restart_context_s
+{
+    nleventqueue_t     *mQueue;
+    nleventqueue_t     *mDoneQueue;
+    nl_event_t          mDone;
+    unsigned            mValid[2];
+    unsigned            mOther;
+} restart_context_t;
+
+static void cancel_task_entry(void *aParams)
+{
+    cancel_context_t *context = (cancel_context_t *)aParams;
+
+    /* Cancel once the timer has been seen running, however long the
+     * receiving task takes to get to it.
+     */
+
+    while (nl_er_atomic_add(&context->mReceived, 0) == 0)
+    {
+        nltask_sleep_ms(kTIMEOUT_MS);
+    }
+
+    nl_event_timer_cancel(context->mTimer);
+
+    nleventqueue_post_event(context->mQueue, &context->mDone);
+}
+
+static void restart_task_entry(void *aParams)
+{
+    restart_context_t *context = (restart_context_t *)aParams;
+    nl_event_timer_t timers[2];
+    nl_event_t *ev;
+    unsigned i;
+
+    /* Restarting timers at once after cancelling them must leave
+     * neither them nor the timers listed along with them behind on the
+     * timer task's list, nor any stale run in its wheel.
+     */
+
+    nl_event_timer_init(&timers[0], NULL, NULL, context->mQueue);
+    nl_event_timer_init(&timers[1], NULL, NULL, context->mQueue);
+
+    for (i = 0; i < kRESTART_ROUNDS; i++)
+    {
+        nl_event_timer_start(&timers[1], kTIMEOUT_MS, true);
+        nl_event_timer_start(&timers[0], kTIMEOUT_MS, true);
+
+        nl_event_timer_cancel(&timers[0]);
+        nl_event_timer_cancel(&timers[1]);
+    }
+
+    nl_event_timer_start(&timers[0], kTIMEOUT_MS, false);
+    nl_event_timer_start(&timers[1], kTIMEOUT_MS * 2, false);
+
+    while ((ev = nleventqueue_get_event_with_timeout(context->mQueue, kWAIT_MS)) != NULL)
+    {
+        if (((ev == (nl_event_t *)&timers[0]) || (ev == (nl_event_t *)&timers[1])) &&
+            nl_event_timer_is_valid((nl_event_timer_t *)ev))
+        {
+            context->mValid[(nl_event_timer_t *)ev - &timers[0]]++;
+        }
+        else
+        {
+            context->mOther++;
+        }
+    }
+
+    nleventqueue_post_event(context->mDoneQueue, &context->mDone);
+}
+
+typedef struct callback_context_s
+{
+    int32_t             mCount;
+    const nl_event_t   *mEvent;
+    bool                mOnTimerTask;
+} callback_context_t;
+
+static int callback_handler(nl_event_t *aEvent, void *aClosure)
+{
+    callback_context_t *context = (callback_context_t *)aClosure;
+
+    context->mEvent = aEvent;
+    context->mOnTimerTask = (strcmp(nltask_get_name(nltask_get_current()), "tmr") == 0);
+
+    nl_er_atomic_inc(&context->mCount);
+
+    return NLER_SUCCESS;
+}
+
+static void TestRestartInvalidatesQueued(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *queuemem[4];
+    nleventqueue_t          queue;
+    nleventqueue_t         *queues[1];
+    nl_event_timer_t        timer;
+    nl_event_t             *ev;
+    int                     status;
+
+    status = nleventqueue_create(&queuemem[0], sizeof (queuemem), &queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    queues[0] = &queue;
+
+    nl_event_timer_init(&timer, NULL, NULL, &queue);
+
+    /* Let the timer expire without receiving its event, then restart
+     * it: the queued event belongs to the old run.
+     */
+
+    nl_event_timer_start(&timer, kTIMEOUT_MS, false);
+
+    status = nleventqueue_select(queues, 1, kEXPIRY_WAIT_MS);
+    NL_TEST_ASSERT(inSuite, status == 0);
+
+    nl_event_timer_start(&timer, kTIMEOUT_MS, false);
+
+    ev = nleventqueue_get_event_with_timeout(&queue, 0);
+    NL_TEST_ASSERT(inSuite, ev == (nl_event_t *)&timer);
+    NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer) == false);
+    NL_TEST_ASSERT(inSuite, nl_event_timer_get_overrun(&timer) == 0);
+
+    /* The new run still delivers its own event.
+     */
+
+    ev = nleventqueue_get_event_with_timeout(&queue, kEXPIRY_WAIT_MS);
+    NL_TEST_ASSERT(inSuite, ev == (nl_event_t *)&timer);
+    NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer) == true);
+
+    ev = nleventqueue_get_event_with_timeout(&queue, kTIMEOUT_MS * 3);
+    NL_TEST_ASSERT(inSuite, ev == NULL);
+
+    nleventqueue_destroy(&queue);
+}
+
+static void TestCancelFromOtherTask(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *queuemem[4];
+    nleventqueue_t          queue;
+    nl_event_timer_t        timer;
+    cancel_context_t        context;
+    nl_event_t             *ev;
+    unsigned                valid = 0;
+    int                     status;
+
+    status = nleventqueue_create(&queuemem[0], sizeof (queuemem), &queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    nl_event_timer_init(&timer, NULL, NULL, &queue);
+
+    context.mTimer = &timer;
+    context.mQueue = &queue;
+    NL_INIT_EVENT(context.mDone, NL_EVENT_T_TEST, NULL, NULL);
+    context.mReceived = 0;
+
+    nl_event_timer_start(&timer, kTIMEOUT_MS, true);
+
+    nltask_create(cancel_task_entry, "C", sCancelStack, sizeof (sCancelStack), kCANCEL_PRIORITY, &context, &sCancelTask);
+
+    /* Receive the timer events until the other task says it has
+     * cancelled the timer.
+     */
+
+    while ((ev = nleventqueue_get_event_with_timeout(&queue, kWAIT_MS)) == (nl_event_t *)&timer)
+    {
+        if (nl_event_timer_is_valid(&timer))
+        {
+            valid++;
+
+            nl_er_atomic_set(&context.mReceived, 1);
+        }
+    }
+
+    NL_TEST_ASSERT(inSuite, ev == &context.mDone);
+    NL_TEST_ASSERT(inSuite, valid > 0);
+
+    /* An event still queued from before the cancel is stale, and none
+     * follows it.
+     */
+
+    while ((ev = nleventqueue_get_event_with_timeout(&queue, kTIMEOUT_MS * 3)) != NULL)
+    {
+        NL_TEST_ASSERT(inSuite, ev == (nl_event_t *)&timer);
+        NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer) == false);
+    }
+
+    nleventqueue_destroy(&queue);
+}
+
+static void TestCancelThenRestart(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *queuemem[4];
+    nleventqueue_t          queue;
+    nl_event_timer_t        timer;
+    nl_event_t             *ev;
+    int                     status;
+
+    status = nleventqueue_create(&queuemem[0], sizeof (queuemem), &queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    nl_event_timer_init(&timer, NULL, NULL, &queue);
+
+    /* Cancelled before it expired: no event for the first run.
+     */
+
+    nl_event_timer_start(&timer, kTIMEOUT_MS, true);
+    nl_event_timer_cancel(&timer);
+    nl_event_timer_start(&timer, kTIMEOUT_MS * 2, false);
+
+    ev = nleventqueue_get_event_with_timeout(&queue, kWAIT_MS);
+    NL_TEST_ASSERT(inSuite, ev == (nl_event_t *)&timer);
+    NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer) == true);
+
+    ev = nleventqueue_get_event_with_timeout(&queue, kTIMEOUT_MS * 3);
+    NL_TEST_ASSERT(inSuite, ev == NULL);
+
+    /* Cancelled after it expired: the queued event is stale and the
+     * restart delivers one of its own.
+     */
+
+    nl_event_timer_start(&timer, kTIMEOUT_MS, false);
+    nltask_sleep_ms(kTIMEOUT_MS * 3);
+    nl_event_timer_cancel(&timer);
+    nl_event_timer_start(&timer, kTIMEOUT_MS, false);
+
+    ev = nleventqueue_get_event_with_timeout(&queue, 0);
+    NL_TEST_ASSERT(inSuite, ev == (nl_event_t *)&timer);
+    NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer) == false);
+
+    ev = nleventqueue_get_event_with_timeout(&queue, kWAIT_MS);
+    NL_TEST_ASSERT(inSuite, ev == (nl_event_t *)&timer);
+    NL_TEST_ASSERT(inSuite, nl_event_timer_is_valid(&timer) == true);
+
+    nleventqueue_destroy(&queue);
+}
+
+static void TestRestartAfterCancel(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *queuemem[4];
+    nleventqueue_t          queue;
+    nl_event_t             *donequeuemem[2];
+    nleventqueue_t          donequeue;
+    restart_context_t        context;
+    nl_event_t             *ev;
+    int                     status;
+
+    status = nleventqueue_create(&queuemem[0], sizeof (queuemem), &queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    status = nleventqueue_create(&donequeuemem[0], sizeof (donequeuemem), &donequeue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    memset(&context, 0, sizeof (context));
+    context.mQueue = &queue;
+    context.mDoneQueue = &donequeue;
+    NL_INIT_EVENT(context.mDone, NL_EVENT_T_TEST, NULL, NULL);
+
+    nltask_create(restart_task_entry, "R", sRestartStack, sizeof (sRestartStack), kCANCEL_PRIORITY, &context, &sRestartTask);
+
+    ev = nleventqueue_get_event(&donequeue);
+    NL_TEST_ASSERT(inSuite, ev == &context.mDone);
+
+    /* Each timer delivered exactly its one event.
+     */
+
+    NL_TEST_ASSERT(inSuite, context.mValid[0] == 1);
+    NL_TEST_ASSERT(inSuite, context.mValid[1] == 1);
+    NL_TEST_ASSERT(inSuite, context.mOther == 0);
+
+    nleventqueue_destroy(&donequeue);
+    nleventqueue_destroy(&queue);
+}
+
+static void TestCallback(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_timer_t        timer;
+    callback_context_t      context;
+    int32_t                 count;
+
+    memset(&context, 0, sizeof (context));
+
+    nl_event_timer_init_callback(&timer, callback_handler, &context);
+
+    /* The handler runs on the timer task itself.
+     */
+
+    nl_event_timer_start(&timer, kTIMEOUT_MS, false);
+
+    nltask_sleep_ms(kTIMEOUT_MS * 5);
+
+    NL_TEST_ASSERT(inSuite, context.mCount == 1);
+    NL_TEST_ASSERT(inSuite, context.mEvent == (nl_event_t *)&timer);
+    NL_TEST_ASSERT(inSuite, context.mOnTimerTask);
+
+    /* Cancelled before it expired, it is never called.
+     */
+
+    nl_event_timer_start(&timer, kTIMEOUT_MS, true);
+    nl_event_timer_cancel(&timer);
+
+    nltask_sleep_ms(kTIMEOUT_MS * 5);
+
+    NL_TEST_ASSERT(inSuite, context.mCount == 1);
+
+    /* Cancelled while repeating, it is called no more.
+     */
+
+    nl_event_timer_start(&timer, kTIMEOUT_MS, true);
+
+    nltask_sleep_ms(kTIMEOUT_MS * 5 + kTIMEOUT_MS / 2);
+
+    nl_event_timer_cancel(&timer);
+
+    count = context.mCount;
+    NL_TEST_ASSERT(inSuite, count > 1);
+
+    nltask_sleep_ms(kTIMEOUT_MS * 5);
+
+    NL_TEST_ASSERT(inSuite, context.mCount == count);
+}
+
+static const nlTest sTests[] = {
+    NL_TEST_DEF("restart invalidates queued", TestRestartInvalidatesQueued),
+    NL_TEST_DEF("cancel from other task",     TestCancelFromOtherTask),
+    NL_TEST_DEF("cancel then restart",        TestCancelThenRestart),
+    NL_TEST_DEF("restart after cancel",       TestRestartAfterCancel),
+    NL_TEST_DEF("callback",                   TestCallback),
+    NL_TEST_SENTINEL()
+};
+
+int nler_eventtimer_test(void)
+{
+    nlTestSuite theSuite = {
+        "nlereventtimer",
+        &sTests[0]
+    };
+
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+}
+
+int main(int argc, char **argv)
+{
+    int status;
+
+    nl_er_init();
+
+#if NLER_FEATURE_SIMULATEABLE_TIME
+    nl_time_init_sim(false);
+#endif
+
+    NL_LOG_CRIT(lrTEST, "start main\n");
+
+    nl_timer_start(NLER_TASK_PRIORITY_HIGH + 1);
+
+    nl_er_start_running();
+
+    status = nler_eventtimer_test();
+
+    nl_er_cleanup();
+
+    NL_LOG_CRIT(lrTEST, "end main\n");
+
+    return (status);
+}
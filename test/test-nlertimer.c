@@ -30,6 +30,7 @@
 #define nleventqueue_post_event               ut_nl_eventqueue_post_event
 
 #include "../shared/nlertimer.c"
+#include "../shared/nlertimerwheel.c"
 #include "../shared/nlerlog.c"
 #include "../shared/nlerlogmanager.c"
 
@@ -648,19 +649,16 @@ nl_event_timer_t test9_events[] =
 
 static void reinit_stimer(void)
 {
-    size_t idx;
     _sCurTime = -1000;
 
     sQueue = (void*) 0x12345678;
     sTimeoutNative = nl_time_ms_to_delay_time_native(NLER_TIMEOUT_NEVER);
     sMinWakeTimeNative = NLER_TIMEOUT_NEVER;
-    sEnd = 0;
     sRunning = 1;
 
-    for (idx = 0; idx < sizeof(sTimers)/sizeof(sTimers[0]); idx++)
-    {
-        sTimers[idx] = (nl_event_timer_t *) 0xdeadbeef;
-    }
+    nl_timer_wheel_init(&sWheel, _sCurTime);
+    sWakeTimers.mNext = &sWakeTimers;
+    sWakeTimers.mPrev = &sWakeTimers;
 }
 
 int main(int argc, char **argv)
@@ -697,7 +695,7 @@ int main(int argc, char **argv)
     nl_timer_run_loop(NULL);
 
     assert_test(_sNumEvents == 2);
-    assert_test(sEnd == 0);
+    assert_test(sWheel.mCount == 0);
 
 
     NL_LOG_DEBUG(lrUTEST, "TEST 2 ----\n\n");
@@ -707,7 +705,7 @@ int main(int argc, char **argv)
     nl_timer_run_loop(NULL);
 
     assert_test(_sNumEvents == 2);
-    assert_test(sEnd == 0);
+    assert_test(sWheel.mCount == 0);
 
     NL_LOG_DEBUG(lrUTEST, "TEST 3 ----\n\n");
     _sCurEventHead = &test3_events[0];
@@ -716,7 +714,7 @@ int main(int argc, char **argv)
     nl_timer_run_loop(NULL);
 
     assert_test(_sNumEvents == 5);
-    assert_test(sEnd == 0);
+    assert_test(sWheel.mCount == 0);
 
     NL_LOG_DEBUG(lrUTEST, "TEST 4 ----\n\n");
     _sCurEventHead = &test4_events[0];
@@ -725,7 +723,7 @@ int main(int argc, char **argv)
     nl_timer_run_loop(NULL);
 
     assert_test(_sNumEvents == 5);
-    assert_test(sEnd == 0);
+    assert_test(sWheel.mCount == 0);
 
     NL_LOG_DEBUG(lrUTEST, "TEST 5 ----\n\n");
     _sCurEventHead = &test5_events[0];
@@ -734,7 +732,7 @@ int main(int argc, char **argv)
     nl_timer_run_loop(NULL);
 
     assert_test(_sNumEvents == 3);
-    assert_test(sEnd == 0);
+    assert_test(sWheel.mCount == 0);
 
     NL_LOG_DEBUG(lrUTEST, "TEST 6 ----\n\n");
     _sCurEventHead = &test6_events[0];
@@ -743,7 +741,7 @@ int main(int argc, char **argv)
     nl_timer_run_loop(NULL);
 
     assert_test(_sNumEvents == 4);
-    assert_test(sEnd == 2);
+    assert_test(sWheel.mCount == 2);
     
     nl_time_native_t wtime = nl_get_wake_time();
     assert_test(wtime == 1000);
@@ -755,7 +753,7 @@ int main(int argc, char **argv)
     nl_timer_run_loop(NULL);
 
     assert_test(_sNumEvents == 4);
-    assert_test(sEnd == 1);
+    assert_test(sWheel.mCount == 1);
     
     wtime = nl_get_wake_time();
     assert_test(wtime == 86399000);
@@ -767,14 +765,14 @@ int main(int argc, char **argv)
     nl_timer_run_loop(NULL);
 
     assert_test(_sNumEvents == 5);
-    assert_test(sEnd == 4);
+    assert_test(sWheel.mCount == 4);
 
     _sCurEventHead = &test9_events[0];
     sRunning = 1;
     nl_timer_run_loop(NULL);
 
     assert_test(_sNumEvents == 7);
-    assert_test(sEnd == 4);    
+    assert_test(sWheel.mCount == 4);    
 
     report_asserts();
 
@@ -69,6 +69,15 @@
 #define kTASK_A_ID_EXPECTED_RX_EVENTS  kTASK_A_ID_EXPECTED_TX_EVENTS
 #define kTASK_B_ID_EXPECTED_RX_EVENTS  kTASK_B_ID_EXPECTED_TX_EVENTS
 
+/**
+ *  Events in the pool shared by a task recycling them and one getting
+ *  them, few enough to all be cached by the former, and how many the
+ *  latter gets.
+ *
+ */
+#define kRECYCLED_EVENTS               8
+#define kRECYCLED_GETS                 500
+
 /*
  * Type Definitions
  */
@@ -101,6 +110,15 @@ typedef struct taskData_s
     bool                          mFailed;
 } taskData_t;
 
+typedef struct recyclerData_s
+{
+    nlevent_pool_t               *mEventPool;
+    nleventqueue_t                mQueue;
+    int32_t                       mMissed;
+    bool                          mGetterDone;
+    bool                          mRecyclerDone;
+} recyclerData_t;
+
 /*
  * Global Variables
  */
@@ -112,6 +130,25 @@ static DEFINE_STACK(stackB, NLER_TASK_STACK_BASE + 96);
 
 static uint8_t sPooledEvents[sizeof(nlevent_pooled_t) * 8];
 
+#define kSIZED_SMALL_EVENTS              4
+#define kSIZED_LARGE_EVENTS              2
+#define kSIZED_LARGE_EVENT_SIZE          128
+
+static uint8_t sSizedPooledEvents[(sizeof(nlevent_pooled_t) * kSIZED_SMALL_EVENTS) +
+                                  (kSIZED_LARGE_EVENT_SIZE * kSIZED_LARGE_EVENTS) + 16];
+
+#define kMULTICAST_EVENTS                2
+#define kMULTICAST_QUEUES                3
+
+static uint8_t sMulticastPooledEvents[(sizeof(nlevent_multicast_t) * kMULTICAST_EVENTS) + 16];
+
+static nltask_t sRecyclerTask;
+static nltask_t sGetterTask;
+static DEFINE_STACK(sRecyclerStack, NLER_TASK_STACK_BASE + 96);
+static DEFINE_STACK(sGetterStack, NLER_TASK_STACK_BASE + 96);
+
+static uint8_t sRecycledPooledEvents[(sizeof(nlevent_pooled_t) * kRECYCLED_EVENTS) + 16];
+
 static int nl_test_eventhandler(nl_event_t *aEvent, void *aClosure)
 {
     const nltask_t      *curtask = nltask_get_current();
@@ -162,6 +199,13 @@ static int nl_test_maybe_post_pooled_event(taskData_t *aData)
 
         if (ev != NULL)
         {
+            /* Pooled events are carved from the pool memory rather than
+             * allocated on the side.
+             */
+
+            NLER_ASSERT(((uint8_t *)ev >= sPooledEvents) &&
+                        (((uint8_t *)(ev + 1)) <= (sPooledEvents + sizeof(sPooledEvents))));
+
             NL_INIT_EVENT(*ev, NL_EVENT_T_POOLED, nl_test_eventhandler, (void *)aData);
             ev->mReturnQueue = &aData->mMyQueue;
             ev->mPayload = nltask_get_current();
@@ -272,6 +316,332 @@ static bool was_successful(volatile const taskData_t *aTaskA,
     return retval;
 }
 
+/**
+ *  Check that a pool with several size classes hands out events from
+ *  the smallest class that fits and has events left.
+ *
+ */
+static bool check_sized_event_pool(void)
+{
+    const nlevent_pool_size_class_t classes[2] = {
+        { sizeof(nlevent_pooled_t), kSIZED_SMALL_EVENTS },
+        { kSIZED_LARGE_EVENT_SIZE,  kSIZED_LARGE_EVENTS }
+    };
+    const nlevent_pool_size_class_t unordered[2] = { classes[1], classes[0] };
+    nlevent_pool_t        pool;
+    nlevent_pool_t        unordered_pool;
+    nlevent_pooled_t     *small[kSIZED_SMALL_EVENTS];
+    nlevent_pooled_t     *large[kSIZED_LARGE_EVENTS];
+    nlevent_pooled_t     *ev;
+    int                   status;
+    size_t                i;
+    bool                  retval = true;
+
+    status = nlevent_pool_create_sized(sSizedPooledEvents, sizeof(sSizedPooledEvents), classes, 2, &pool);
+
+    if (status == NLER_ERROR_NOT_IMPLEMENTED)
+        return true;
+    else if (status != NLER_SUCCESS)
+        return false;
+
+    status = nlevent_pool_create_sized(sSizedPooledEvents, sizeof(sSizedPooledEvents), unordered, 2, &unordered_pool);
+    if (status != NLER_ERROR_BAD_INPUT)
+        retval = false;
+
+    /* Larger than every class */
+
+    if (nlevent_pool_get_event_sized(&pool, kSIZED_LARGE_EVENT_SIZE + 1) != NULL)
+        retval = false;
+
+    /* Large events until that class runs out */
+
+    for (i = 0; i < kSIZED_LARGE_EVENTS; i++)
+    {
+        large[i] = nlevent_pool_get_event_sized(&pool, kSIZED_LARGE_EVENT_SIZE);
+        if (large[i] == NULL)
+            retval = false;
+    }
+
+    if (nlevent_pool_get_event_sized(&pool, sizeof(nlevent_pooled_t) + 1) != NULL)
+        retval = false;
+
+    /* Small events until that class runs out */
+
+    for (i = 0; i < kSIZED_SMALL_EVENTS; i++)
+    {
+        small[i] = nlevent_pool_get_event(&pool);
+        if ((small[i] == NULL) || (small[i] == large[0]) || (small[i] == large[1]))
+            retval = false;
+    }
+
+    /* Small events spill over into a larger class */
+
+    nlevent_pool_recycle_event(&pool, large[0]);
+
+    ev = nlevent_pool_get_event(&pool);
+    if (ev != large[0])
+        retval = false;
+
+    if (nlevent_pool_get_event(&pool) != NULL)
+        retval = false;
+
+    for (i = 0; i < kSIZED_SMALL_EVENTS; i++)
+        nlevent_pool_recycle_event(&pool, small[i]);
+
+    for (i = 0; i < kSIZED_LARGE_EVENTS; i++)
+        nlevent_pool_recycle_event(&pool, large[i]);
+
+    nlevent_pool_destroy(&pool);
+
+    return retval;
+}
+
+static int multicast_eventhandler(nl_event_t *aEvent, void *aClosure)
+{
+    int *count = (int *)aClosure;
+
+    (*count)++;
+
+    return NLER_SUCCESS;
+}
+
+static bool check_multicast_events(void)
+{
+    const nlevent_pool_size_class_t classes[1] = {
+        { sizeof(nlevent_multicast_t), kMULTICAST_EVENTS }
+    };
+    nl_event_t           *queuemem[kMULTICAST_QUEUES][2];
+    nleventqueue_t        queueobjs[kMULTICAST_QUEUES];
+    nleventqueue_t       *queues[kMULTICAST_QUEUES];
+    nl_event_t            filler = { NL_INIT_EVENT_STATIC(NL_EVENT_T_RUNTIME, NULL, NULL) };
+    nlevent_pool_t        pool;
+    nlevent_multicast_t  *ev;
+    nlevent_multicast_t  *other;
+    nl_event_t           *got;
+    int                   count = 0;
+    int                   status;
+    size_t                i;
+    bool                  retval = true;
+
+    status = nlevent_pool_create_sized(sMulticastPooledEvents, sizeof(sMulticastPooledEvents), classes, 1, &pool);
+
+    if (status == NLER_ERROR_NOT_IMPLEMENTED)
+        return true;
+    else if (status != NLER_SUCCESS)
+        return false;
+
+    for (i = 0; i < kMULTICAST_QUEUES; i++)
+    {
+        status = nleventqueue_create(queuemem[i], sizeof(queuemem[i]), &queueobjs[i]);
+        NLER_ASSERT(status == NLER_SUCCESS);
+
+        queues[i] = &queueobjs[i];
+    }
+
+    ev = nlevent_pool_get_multicast_event(&pool);
+    if ((ev == NULL) || (ev->mType != NL_EVENT_T_MULTICAST))
+        return false;
+
+    ev->mHandler        = multicast_eventhandler;
+    ev->mHandlerClosure = &count;
+
+    other = nlevent_pool_get_multicast_event(&pool);
+    if ((other == NULL) || (nlevent_pool_get_multicast_event(&pool) != NULL))
+        retval = false;
+
+    if (nlevent_multicast_post(ev, queues, 0) != NLER_ERROR_BAD_INPUT)
+        retval = false;
+
+    /* One event shared by every queue, back in the pool after the last */
+
+    status = nlevent_multicast_post(ev, queues, kMULTICAST_QUEUES);
+    if (status != NLER_SUCCESS)
+        retval = false;
+
+    for (i = 0; i < kMULTICAST_QUEUES; i++)
+    {
+        if (nlevent_pool_get_multicast_event(&pool) != NULL)
+            retval = false;
+
+        got = nleventqueue_get_event_with_timeout(queues[i], NLER_TIMEOUT_NOW);
+        if (got != (nl_event_t *)ev)
+            return false;
+
+        nl_dispatch_event(got, multicast_eventhandler, &count);
+    }
+
+    if (count != kMULTICAST_QUEUES)
+        retval = false;
+
+    ev = nlevent_pool_get_multicast_event(&pool);
+    if (ev == NULL)
+        return false;
+
+    /* A queue that refuses the event holds no reference to it */
+
+    while (nleventqueue_post_event(queues[0], &filler) == NLER_SUCCESS)
+        ;
+
+    status = nlevent_multicast_post(ev, queues, 2);
+    if (status == NLER_SUCCESS)
+        retval = false;
+
+    if (nleventqueue_get_event_with_timeout(queues[1], NLER_TIMEOUT_NOW) != (nl_event_t *)ev)
+        return false;
+
+    nl_dispatch_event((nl_event_t *)ev, multicast_eventhandler, &count);
+
+    if (count != (kMULTICAST_QUEUES + 1))
+        retval = false;
+
+    if (nlevent_pool_get_multicast_event(&pool) != ev)
+        retval = false;
+
+    /* Refused by every queue, the event goes straight back */
+
+    status = nlevent_multicast_post(ev, queues, 1);
+    if (status == NLER_SUCCESS)
+        retval = false;
+
+    if (nlevent_pool_get_multicast_event(&pool) != ev)
+        retval = false;
+
+    nlevent_pool_recycle_event(&pool, (nlevent_pooled_t *)ev);
+    nlevent_pool_recycle_event(&pool, (nlevent_pooled_t *)other);
+
+    for (i = 0; i < kMULTICAST_QUEUES; i++)
+        nleventqueue_destroy(queues[i]);
+
+    nlevent_pool_destroy(&pool);
+
+    return retval;
+}
+
+/**
+ *  Churn through events, and recycle those the getter is done with,
+ *  such that the free events end up cached by this task, whose cache
+ *  is often busy when the getter preempts it.
+ *
+ */
+static void recyclerEntry(void *aParams)
+{
+    volatile recyclerData_t  *data = (volatile recyclerData_t *)aParams;
+    nlevent_pooled_t         *ev;
+
+    while (!data->mGetterDone)
+    {
+        ev = nlevent_pool_get_event(data->mEventPool);
+        if (ev != NULL)
+            nlevent_pool_recycle_event(data->mEventPool, ev);
+
+        while ((ev = (nlevent_pooled_t *)nleventqueue_get_event_with_timeout((nleventqueue_t *)&data->mQueue, 0)) != NULL)
+            nlevent_pool_recycle_event(data->mEventPool, ev);
+    }
+
+    /* Whatever the getter handed over last */
+
+    while ((ev = (nlevent_pooled_t *)nleventqueue_get_event_with_timeout((nleventqueue_t *)&data->mQueue, 0)) != NULL)
+        nlevent_pool_recycle_event(data->mEventPool, ev);
+
+    data->mRecyclerDone = true;
+}
+
+static void getterEntry(void *aParams)
+{
+    volatile recyclerData_t  *data = (volatile recyclerData_t *)aParams;
+    nlevent_pooled_t         *ev;
+    size_t                    i;
+
+    for (i = 0; i < kRECYCLED_GETS; i++)
+    {
+        nltask_sleep_ms(1);
+
+        /* Those handed over are recycled first, however long the
+         * recycler is held off, such that all but the one it may be
+         * holding are free.
+         */
+
+        while (nleventqueue_get_count((nleventqueue_t *)&data->mQueue) > 0)
+            nltask_sleep_ms(1);
+
+        ev = nlevent_pool_get_event(data->mEventPool);
+
+        if (ev == NULL)
+            data->mMissed++;
+        else
+            nleventqueue_post_event((nleventqueue_t *)&data->mQueue, (nl_event_t *)ev);
+    }
+
+    data->mGetterDone = true;
+}
+
+/**
+ *  Check that events recycled by another task, and so cached by it,
+ *  can always be got: while that task is busy with its cache, and once
+ *  it is done, every one of them.
+ *
+ */
+static bool check_recycled_events(void)
+{
+    volatile recyclerData_t data;
+    nl_event_t           *queuemem[kRECYCLED_EVENTS];
+    nlevent_pooled_t     *events[kRECYCLED_EVENTS];
+    nlevent_pool_t        pool;
+    int                   status;
+    size_t                i;
+    size_t                j;
+    bool                  retval = true;
+
+    status = nlevent_pool_create(sRecycledPooledEvents, sizeof(sRecycledPooledEvents), &pool);
+    NLER_ASSERT(status == NLER_SUCCESS);
+
+    status = nleventqueue_create(queuemem, sizeof(queuemem), (nleventqueue_t *)&data.mQueue);
+    NLER_ASSERT(status == NLER_SUCCESS);
+
+    data.mEventPool = &pool;
+    data.mMissed = 0;
+    data.mGetterDone = false;
+    data.mRecyclerDone = false;
+
+    nltask_create(recyclerEntry, "R", sRecyclerStack, sizeof(sRecyclerStack), NLER_TASK_PRIORITY_NORMAL, (void *)&data, &sRecyclerTask);
+    nltask_create(getterEntry, "G", sGetterStack, sizeof(sGetterStack), NLER_TASK_PRIORITY_HIGH, (void *)&data, &sGetterTask);
+
+    while (!data.mRecyclerDone)
+        nltask_sleep_ms(kTHREAD_MAIN_SLEEP_MS);
+
+    if (data.mMissed != 0)
+    {
+        NL_LOG_CRIT(lrTEST, "missed %d of %d events\n", data.mMissed, kRECYCLED_GETS);
+        retval = false;
+    }
+
+    /* Every event, wherever it was cached */
+
+    for (i = 0; i < kRECYCLED_EVENTS; i++)
+    {
+        events[i] = nlevent_pool_get_event(&pool);
+        if (events[i] == NULL)
+            retval = false;
+
+        for (j = 0; j < i; j++)
+        {
+            if ((events[i] != NULL) && (events[i] == events[j]))
+                retval = false;
+        }
+    }
+
+    if (nlevent_pool_get_event(&pool) != NULL)
+        retval = false;
+
+    for (i = 0; i < kRECYCLED_EVENTS; i++)
+        nlevent_pool_recycle_event(&pool, events[i]);
+
+    nleventqueue_destroy((nleventqueue_t *)&data.mQueue);
+    nlevent_pool_destroy(&pool);
+
+    return retval;
+}
+
 bool nler_event_pool_test(void)
 {
     globalData_t          globalData;
@@ -323,7 +693,7 @@ bool nler_event_pool_test(void)
 
     nlevent_pool_destroy(&globalData.mEventPool);
 
-    retval = was_successful(&dataA, &dataB);
+    retval = was_successful(&dataA, &dataB) && check_sized_event_pool() && check_multicast_events() && check_recycled_events();
 
     return retval;
 }
@@ -0,0 +1,332 @@
+/*
+ *
+ *    Copyright (c) 2020 Project nler Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test for the NLER resendable timer
+ *      interfaces.
+ *
+ *      Two tasks each start, resend and receive a resendable timer of
+ *      their own, the two timers guarded by different locks, all at
+ *      once and from the very first use of the locks. Each task must
+ *      receive a timer for every one it sent, and find exactly one
+ *      valid for each round of sends.
+ *
+ *      The resendable timer is not built along with the event timer,
+ *      which resends of itself; there the tasks put event timers
+ *      through the same rounds instead, receiving until the one valid
+ *      timer of each round.
+ *
+ */
+
+#include <nlresendabletimer.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef nlLOG_PRIORITY
+#undef nlLOG_PRIORITY
+#endif
+#define nlLOG_PRIORITY 1
+
+#include <nlerassert.h>
+#include <nlercfg.h>
+#include <nlererror.h>
+#include <nlereventqueue.h>
+#include <nlerinit.h>
+#include <nlerlog.h>
+#include <nlermathutil.h>
+#include <nlertask.h>
+#include <nlertimer.h>
+#if NLER_FEATURE_SIMULATEABLE_TIME
+#include <nlertimer_sim.h>
+#endif
+
+/*
+ * Preprocessor Defitions
+ */
+
+#define kTHREAD_MAIN_SLEEP_MS            241
+
+#define kRESENDERS                       2
+#define kRESENDER_ROUNDS                 200
+#define kRESENDER_TIMEOUT_MS             1
+
+/**
+ *  Timers to pick the resenders' from, such that no two of those
+ *  picked share a lock.
+ *
+ */
+#define kCANDIDATE_TIMERS                32
+
+/*
+ * Type Definitions
+ */
+
+#if NLER_FEATURE_EVENT_TIMER
+typedef nl_event_timer_t resenderTimer_t;
+#else
+typedef nl_resendable_timer_t resenderTimer_t;
+#endif
+
+typedef struct resenderData_s
+{
+    resenderTimer_t              *mTimer;
+    nleventqueue_t                mQueue;
+    int32_t                       mValid;
+    int32_t                       mIgnored;
+    bool                          mFailed;
+    bool                          mDone;
+} resenderData_t;
+
+/*
+ * Global Variables
+ */
+
+static nltask_t sResenderTasks[kRESENDERS];
+static DEFINE_STACK(sResenderStacks[kRESENDERS], NLER_TASK_STACK_BASE + 96);
+
+static resenderTimer_t sTimers[kCANDIDATE_TIMERS];
+
+#if NLER_FEATURE_EVENT_TIMER
+/**
+ *  Start the timer, every other round start it again, then receive
+ *  timers until the one valid.
+ *
+ */
+static void resenderEntry(void *aParams)
+{
+    volatile resenderData_t  *data = (volatile resenderData_t *)aParams;
+    nl_event_t               *ev;
+    bool                      valid;
+    int                       round;
+
+    for (round = 0; (round < kRESENDER_ROUNDS) && !data->mFailed; round++)
+    {
+        nl_event_timer_start(data->mTimer, kRESENDER_TIMEOUT_MS, false);
+
+        if (round & 1)
+            nl_event_timer_start(data->mTimer, kRESENDER_TIMEOUT_MS, false);
+
+        do
+        {
+            ev = nleventqueue_get_event((nleventqueue_t *)&data->mQueue);
+
+            valid = false;
+
+            if (ev != (nl_event_t *)data->mTimer)
+                data->mFailed = true;
+            else if ((valid = nl_event_timer_is_valid(data->mTimer)))
+                data->mValid++;
+            else
+                data->mIgnored++;
+        } while (!valid && !data->mFailed);
+    }
+
+    data->mDone = true;
+}
+
+static bool timers_share_lock(resenderTimer_t *aFirst, resenderTimer_t *aSecond)
+{
+    (void)aFirst;
+    (void)aSecond;
+
+    return false;
+}
+#else
+/**
+ *  Start the timer, every other round resend it, then receive a timer
+ *  for every one sent.
+ *
+ */
+static void resenderEntry(void *aParams)
+{
+    volatile resenderData_t  *data = (volatile resenderData_t *)aParams;
+    nl_event_t               *ev;
+    int                       sent;
+    int                       round;
+
+    for (round = 0; (round < kRESENDER_ROUNDS) && !data->mFailed; round++)
+    {
+        sent = 0;
+
+        if (nl_resendable_timer_start(data->mTimer, kRESENDER_TIMEOUT_MS) == NLER_SUCCESS)
+            sent++;
+        else
+            data->mFailed = true;
+
+        if ((round & 1) && !data->mFailed)
+        {
+            if (nl_resendable_timer_start(data->mTimer, kRESENDER_TIMEOUT_MS) == NLER_SUCCESS)
+                sent++;
+            else
+                data->mFailed = true;
+        }
+
+        while (sent > 0)
+        {
+            ev = nleventqueue_get_event((nleventqueue_t *)&data->mQueue);
+
+            if (ev != (nl_event_t *)data->mTimer)
+                data->mFailed = true;
+            else if (nl_resendable_timer_receive(data->mTimer) == NLER_SUCCESS)
+                data->mValid++;
+            else
+                data->mIgnored++;
+
+            sent--;
+        }
+    }
+
+    data->mDone = true;
+}
+
+static bool timers_share_lock(resenderTimer_t *aFirst, resenderTimer_t *aSecond)
+{
+    return ((NLER_RESENDABLE_TIMER_LOCKS >= kRESENDERS) &&
+            (nl_hash_pointer(aFirst, NLER_RESENDABLE_TIMER_LOCKS) == nl_hash_pointer(aSecond, NLER_RESENDABLE_TIMER_LOCKS)));
+}
+#endif
+
+static bool nler_resendable_timer_test(void)
+{
+    volatile resenderData_t data[kRESENDERS];
+    nl_event_t           *queuemem[kRESENDERS][4];
+    size_t                picked;
+    size_t                i;
+    size_t                j;
+    int                   status;
+    bool                  retval = true;
+
+    /* Timers hashing to locks of their own, where there are enough */
+
+    picked = 0;
+
+    for (i = 0; (i < kCANDIDATE_TIMERS) && (picked < kRESENDERS); i++)
+    {
+        for (j = 0; j < picked; j++)
+        {
+            if (timers_share_lock(&sTimers[i], data[j].mTimer))
+                break;
+        }
+
+        if (j == picked)
+            data[picked++].mTimer = &sTimers[i];
+    }
+
+    if (picked != kRESENDERS)
+    {
+        NL_LOG_CRIT(lrTEST, "found no timers with locks of their own\n");
+        return false;
+    }
+
+    for (i = 0; i < kRESENDERS; i++)
+    {
+        status = nleventqueue_create(queuemem[i], sizeof(queuemem[i]), (nleventqueue_t *)&data[i].mQueue);
+        NLER_ASSERT(status == NLER_SUCCESS);
+
+#if NLER_FEATURE_EVENT_TIMER
+        nl_event_timer_init(data[i].mTimer, NULL, NULL, (nleventqueue_t *)&data[i].mQueue);
+#else
+        NL_INIT_RESENDABLE_TIMER(*data[i].mTimer, NULL, NULL, (nleventqueue_t *)&data[i].mQueue);
+#endif
+
+        data[i].mValid = 0;
+        data[i].mIgnored = 0;
+        data[i].mFailed = false;
+        data[i].mDone = false;
+    }
+
+    for (i = 0; i < kRESENDERS; i++)
+        nltask_create(resenderEntry, "R", sResenderStacks[i], sizeof(sResenderStacks[i]), NLER_TASK_PRIORITY_NORMAL, (void *)&data[i], &sResenderTasks[i]);
+
+    for (i = 0; i < kRESENDERS; i++)
+    {
+        while (!data[i].mDone)
+            nltask_sleep_ms(kTHREAD_MAIN_SLEEP_MS);
+
+        NL_LOG_CRIT(lrTEST, "resender %u: %d valid, %d ignored%s\n", (unsigned)i, data[i].mValid, data[i].mIgnored,
+                    data[i].mFailed ? ", failed" : "");
+
+        // an event timer started again before it expired leaves no
+        // event to ignore.
+
+        if (data[i].mFailed ||
+            (data[i].mValid != kRESENDER_ROUNDS) ||
+#if NLER_FEATURE_EVENT_TIMER
+            (data[i].mIgnored > (kRESENDER_ROUNDS / 2)))
+#else
+            (data[i].mIgnored != (kRESENDER_ROUNDS / 2)))
+#endif
+            retval = false;
+
+        nleventqueue_destroy((nleventqueue_t *)&data[i].mQueue);
+    }
+
+    return retval;
+}
+
+#if !NLER_FEATURE_EVENT_TIMER
+static void nler_test_timer_stop(nleventqueue_t *aTimerQueue)
+{
+    static const nl_event_timer_t sTimerStopEvent = { NL_INIT_EVENT_STATIC(NL_EVENT_T_EXIT, 0, 0) };
+
+    int status;
+
+    status = nleventqueue_post_event(aTimerQueue, (nl_event_t *)&sTimerStopEvent);
+    NLER_ASSERT(status == NLER_SUCCESS);
+}
+#endif
+
+int main(int argc, char **argv)
+{
+    bool             status;
+#if !NLER_FEATURE_EVENT_TIMER
+    nleventqueue_t  *queue;
+#endif
+
+    nl_er_init();
+
+#if NLER_FEATURE_SIMULATEABLE_TIME
+    nl_time_init_sim(false);
+#endif
+
+    NL_LOG_CRIT(lrTEST, "start main\n");
+
+#if NLER_FEATURE_EVENT_TIMER
+    nl_timer_start(NLER_TASK_PRIORITY_HIGH + 1);
+#else
+    queue = nl_timer_start(NLER_TASK_PRIORITY_HIGH + 1);
+    NLER_ASSERT(queue != NULL);
+#endif
+
+    nl_er_start_running();
+
+    status = nler_resendable_timer_test();
+
+#if !NLER_FEATURE_EVENT_TIMER
+    nler_test_timer_stop(queue);
+#endif
+
+    nl_er_cleanup();
+
+    NL_LOG_CRIT(lrTEST, "end main\n");
+
+    return (status ? EXIT_SUCCESS : EXIT_FAILURE);
+}
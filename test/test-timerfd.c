@@ -0,0 +1,218 @@
+/*
+ *
+ *    Copyright (c) 2026 Project nler Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test for the POSIX threads
+ *      (pthreads)-specific timerfd wait.
+ *
+ */
+
+#include <nlertimerfd.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef nlLOG_PRIORITY
+#undef nlLOG_PRIORITY
+#endif
+#define nlLOG_PRIORITY 1
+
+#include <nlererror.h>
+#include <nlerinit.h>
+#include <nlerlog.h>
+
+#include <nlunit-test.h>
+
+#define NL_EVENT_T_TEST (NL_EVENT_T_WM_USER + 1)
+
+static void TestInitAndDestroy(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *test_queuemem[4];
+    nleventqueue_t          test_queue;
+    nl_timerfd_t            test_timer;
+    int                     status;
+
+    status = nleventqueue_create(&test_queuemem[0], sizeof (test_queuemem), &test_queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    /*
+     * Initialization
+     */
+
+    /* Test known, positive failure cases
+     */
+
+    status = nl_timerfd_init(NULL, &test_queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_BAD_INPUT);
+
+    status = nl_timerfd_init(&test_timer, NULL);
+    NL_TEST_ASSERT(inSuite, status == NLER_ERROR_BAD_INPUT);
+
+    /* Test success case
+     */
+
+    status = nl_timerfd_init(&test_timer, &test_queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    /*
+     * Disarming Unarmed
+     */
+
+    status = nl_timerfd_disarm(&test_timer);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    /*
+     * Destruction
+     */
+
+    nl_timerfd_destroy(&test_timer);
+
+    nleventqueue_destroy(&test_queue);
+}
+
+static void TestWait(nlTestSuite *inSuite, void *inContext)
+{
+    nl_event_t             *test_queuemem[4];
+    nleventqueue_t          test_queue;
+    nl_timerfd_t            test_timer;
+    nl_event_t              test_event = { NL_INIT_EVENT_STATIC(NL_EVENT_T_TEST, NULL, NULL) };
+    nl_time_native_t        start;
+    nl_time_native_t        deadline;
+    nl_event_t             *ev;
+    int                     status;
+
+    status = nleventqueue_create(&test_queuemem[0], sizeof (test_queuemem), &test_queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    status = nl_timerfd_init(&test_timer, &test_queue);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    /*
+     * Deadline Already Reached
+     */
+
+    status = nl_timerfd_arm(&test_timer, nl_get_time_native() - 10);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    ev = nl_timerfd_get_event(&test_timer);
+    NL_TEST_ASSERT(inSuite, ev == NULL);
+
+    /*
+     * Future Deadline
+     */
+
+    start    = nl_get_time_native();
+    deadline = start + nl_time_ms_to_time_native(50);
+
+    status = nl_timerfd_arm(&test_timer, deadline);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    /* Arming again for the same deadline is idempotent
+     */
+
+    status = nl_timerfd_arm(&test_timer, deadline);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    ev = nl_timerfd_get_event(&test_timer);
+    NL_TEST_ASSERT(inSuite, ev == NULL);
+    NL_TEST_ASSERT(inSuite, (int32_t)(nl_get_time_native() - deadline) >= 0);
+
+    /* The same deadline once expired is armed anew
+     */
+
+    status = nl_timerfd_arm(&test_timer, deadline);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    ev = nl_timerfd_get_event(&test_timer);
+    NL_TEST_ASSERT(inSuite, ev == NULL);
+
+    /*
+     * Queued Event Ahead of the Deadline
+     */
+
+    status = nl_timerfd_arm(&test_timer, nl_get_time_native() + nl_time_ms_to_time_native(10000));
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    nleventqueue_post_event(&test_queue, &test_event);
+
+    ev = nl_timerfd_get_event(&test_timer);
+    NL_TEST_ASSERT(inSuite, ev == &test_event);
+
+    /*
+     * Disarmed
+     */
+
+    status = nl_timerfd_arm(&test_timer, nl_get_time_native() - 10);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    status = nl_timerfd_disarm(&test_timer);
+    NL_TEST_ASSERT(inSuite, status == NLER_SUCCESS);
+
+    nleventqueue_post_event(&test_queue, &test_event);
+
+    ev = nl_timerfd_get_event(&test_timer);
+    NL_TEST_ASSERT(inSuite, ev == &test_event);
+
+    /*
+     * Destruction
+     */
+
+    nl_timerfd_destroy(&test_timer);
+
+    nleventqueue_destroy(&test_queue);
+}
+
+static const nlTest sTests[] = {
+    NL_TEST_DEF("init and destroy",        TestInitAndDestroy),
+    NL_TEST_DEF("wait",                    TestWait),
+    NL_TEST_SENTINEL()
+};
+
+int nler_timerfd_test(void)
+{
+    nlTestSuite theSuite = {
+        "nlertimerfd",
+        &sTests[0]
+    };
+
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+}
+
+int main(int argc, char **argv)
+{
+    int status;
+
+    nl_er_init();
+
+    NL_LOG_CRIT(lrTEST, "start main\n");
+
+    nl_er_start_running();
+
+    status = nler_timerfd_test();
+
+    nl_er_cleanup();
+
+    NL_LOG_CRIT(lrTEST, "end main\n");
+
+    return (status);
+}
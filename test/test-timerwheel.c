@@ -0,0 +1,419 @@
+/*
+ *
+ *    Copyright (c) 2026 Project nler Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test for the NLER timer wheel
+ *      interfaces.
+ *
+ */
+
+#include <nlertimerwheel.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef nlLOG_PRIORITY
+#undef nlLOG_PRIORITY
+#endif
+#define nlLOG_PRIORITY 1
+
+#include <nlererror.h>
+#include <nlerinit.h>
+#include <nlerlog.h>
+
+#include <nlunit-test.h>
+
+#define kSTRESS_TIMERS      512
+#define kSTRESS_SPAN        (1UL << 20)
+
+typedef struct nl_test_timer_s
+{
+    nl_timer_wheel_link_t   mLink;
+    nl_time_native_t        mExpiredAt;
+    int                     mExpiredCount;
+    nl_time_native_t        mRepeat;
+} nl_test_timer_t;
+
+typedef struct nl_test_wheel_state_s
+{
+    nl_timer_wheel_t        *mWheel;
+    nl_time_native_t        mNow;
+    int                     mExpiredCount;
+    bool                    mEarly;
+} nl_test_wheel_state_t;
+
+static nl_timer_wheel_t sWheel;
+static nl_test_timer_t sTimers[kSTRESS_TIMERS];
+
+static void ExpireHandler(nl_timer_wheel_link_t *aLink, void *aClosure)
+{
+    nl_test_wheel_state_t   *state = (nl_test_wheel_state_t *)aClosure;
+    nl_test_timer_t         *timer = (nl_test_timer_t *)aLink;
+
+    if ((int32_t)(state->mNow - aLink->mExpires) < 0)
+    {
+        state->mEarly = true;
+    }
+
+    timer->mExpiredAt = state->mNow;
+    timer->mExpiredCount++;
+    state->mExpiredCount++;
+
+    if (timer->mRepeat != 0)
+    {
+        nl_timer_wheel_add(state->mWheel, aLink, aLink->mExpires + timer->mRepeat);
+    }
+}
+
+static void reset_timers(void)
+{
+    size_t i;
+
+    for (i = 0; i < kSTRESS_TIMERS; i++)
+    {
+        sTimers[i].mLink.mNext    = NULL;
+        sTimers[i].mLink.mPrev    = NULL;
+        sTimers[i].mExpiredAt     = 0;
+        sTimers[i].mExpiredCount  = 0;
+        sTimers[i].mRepeat        = 0;
+    }
+}
+
+/* advance one wheel-requested tick at a time up to and including aTo,
+ * the way a timer task sleeping until the next tick would.
+ */
+static void advance_to(nl_test_wheel_state_t *aState, nl_time_native_t aTo)
+{
+    nl_time_native_t next;
+
+    while (nl_timer_wheel_next(aState->mWheel, &next) && ((int32_t)(aTo - next) >= 0))
+    {
+        aState->mNow = next;
+
+        nl_timer_wheel_advance(aState->mWheel, next, ExpireHandler, aState);
+    }
+
+    aState->mNow = aTo;
+
+    nl_timer_wheel_advance(aState->mWheel, aTo, ExpireHandler, aState);
+}
+
+static void TestAddAndRemove(nlTestSuite *inSuite, void *inContext)
+{
+    nl_test_wheel_state_t   state = { &sWheel, 1000, 0, false };
+    nl_time_native_t        next;
+
+    reset_timers();
+    nl_timer_wheel_init(&sWheel, state.mNow);
+
+    NL_TEST_ASSERT(inSuite, !nl_timer_wheel_next(&sWheel, &next));
+
+    nl_timer_wheel_add(&sWheel, &sTimers[0].mLink, 1005);
+    nl_timer_wheel_add(&sWheel, &sTimers[1].mLink, 1010);
+    nl_timer_wheel_add(&sWheel, &sTimers[2].mLink, 1010);
+
+    NL_TEST_ASSERT(inSuite, nl_timer_wheel_is_pending(&sTimers[0].mLink));
+    NL_TEST_ASSERT(inSuite, sWheel.mCount == 3);
+
+    /* The next tick is the earliest expiry or, with timers further
+     * out than the lowest level covers, a cascade before it
+     */
+
+    NL_TEST_ASSERT(inSuite, nl_timer_wheel_next(&sWheel, &next));
+    NL_TEST_ASSERT(inSuite, (next > 1000) && (next <= 1005));
+
+    /* Nothing is due yet
+     */
+
+    state.mNow = 1004;
+    nl_timer_wheel_advance(&sWheel, state.mNow, ExpireHandler, &state);
+    NL_TEST_ASSERT(inSuite, state.mExpiredCount == 0);
+
+    state.mNow = 1005;
+    nl_timer_wheel_advance(&sWheel, state.mNow, ExpireHandler, &state);
+    NL_TEST_ASSERT(inSuite, state.mExpiredCount == 1);
+    NL_TEST_ASSERT(inSuite, sTimers[0].mExpiredAt == 1005);
+    NL_TEST_ASSERT(inSuite, !nl_timer_wheel_is_pending(&sTimers[0].mLink));
+
+    /* Removal, including of a timer no longer in the wheel
+     */
+
+    nl_timer_wheel_remove(&sWheel, &sTimers[1].mLink);
+    nl_timer_wheel_remove(&sWheel, &sTimers[1].mLink);
+    nl_timer_wheel_remove(&sWheel, &sTimers[0].mLink);
+    NL_TEST_ASSERT(inSuite, sWheel.mCount == 1);
+
+    /* Adding again moves the timer
+     */
+
+    nl_timer_wheel_add(&sWheel, &sTimers[2].mLink, 1020);
+    NL_TEST_ASSERT(inSuite, sWheel.mCount == 1);
+
+    state.mNow = 1015;
+    nl_timer_wheel_advance(&sWheel, state.mNow, ExpireHandler, &state);
+    NL_TEST_ASSERT(inSuite, state.mExpiredCount == 1);
+
+    NL_TEST_ASSERT(inSuite, nl_timer_wheel_next(&sWheel, &next));
+    NL_TEST_ASSERT(inSuite, (next > 1015) && (next <= 1020));
+
+    nl_timer_wheel_remove(&sWheel, &sTimers[2].mLink);
+    NL_TEST_ASSERT(inSuite, !nl_timer_wheel_next(&sWheel, &next));
+
+    /* Times already past expire with the next advance
+     */
+
+    nl_timer_wheel_add(&sWheel, &sTimers[3].mLink, 900);
+
+    state.mNow = 1016;
+    nl_timer_wheel_advance(&sWheel, state.mNow, ExpireHandler, &state);
+    NL_TEST_ASSERT(inSuite, sTimers[3].mExpiredCount == 1);
+    NL_TEST_ASSERT(inSuite, sTimers[3].mExpiredAt == 1016);
+
+    NL_TEST_ASSERT(inSuite, !state.mEarly);
+}
+
+static void TestCascade(nlTestSuite *inSuite, void *inContext)
+{
+    nl_test_wheel_state_t   state = { &sWheel, 0xfffff000, 0, false };
+    const uint32_t          delays[] = { 70, 4095, 4096, 300000, 0x00ffffff, 0x03000000 };
+    const size_t            count = sizeof (delays) / sizeof (delays[0]);
+    size_t                  i;
+
+    reset_timers();
+    nl_timer_wheel_init(&sWheel, state.mNow);
+
+    /* Timers in every level, one beyond the reach of the wheel, some
+     * expiring after the native time wraps
+     */
+
+    for (i = 0; i < count; i++)
+    {
+        nl_timer_wheel_add(&sWheel, &sTimers[i].mLink, state.mNow + delays[i]);
+    }
+
+    advance_to(&state, state.mNow + delays[count - 1]);
+
+    NL_TEST_ASSERT(inSuite, state.mExpiredCount == (int)count);
+    NL_TEST_ASSERT(inSuite, !state.mEarly);
+
+    for (i = 0; i < count; i++)
+    {
+        NL_TEST_ASSERT(inSuite, sTimers[i].mExpiredCount == 1);
+        NL_TEST_ASSERT(inSuite, sTimers[i].mExpiredAt == (nl_time_native_t)(0xfffff000 + delays[i]));
+    }
+
+    /* A single advance well past all of them expires them all
+     */
+
+    for (i = 0; i < count; i++)
+    {
+        nl_timer_wheel_add(&sWheel, &sTimers[i].mLink, state.mNow + delays[i]);
+    }
+
+    state.mNow += delays[count - 1];
+    nl_timer_wheel_advance(&sWheel, state.mNow, ExpireHandler, &state);
+
+    NL_TEST_ASSERT(inSuite, state.mExpiredCount == (int)(2 * count));
+    NL_TEST_ASSERT(inSuite, sWheel.mCount == 0);
+}
+
+static void TestRepeat(nlTestSuite *inSuite, void *inContext)
+{
+    nl_test_wheel_state_t   state = { &sWheel, 0, 0, false };
+
+    reset_timers();
+    nl_timer_wheel_init(&sWheel, state.mNow);
+
+    sTimers[0].mRepeat = 10;
+    sTimers[1].mRepeat = 1000;
+
+    nl_timer_wheel_add(&sWheel, &sTimers[0].mLink, 10);
+    nl_timer_wheel_add(&sWheel, &sTimers[1].mLink, 1000);
+
+    advance_to(&state, 10000);
+
+    NL_TEST_ASSERT(inSuite, sTimers[0].mExpiredCount == 1000);
+    NL_TEST_ASSERT(inSuite, sTimers[1].mExpiredCount == 10);
+    NL_TEST_ASSERT(inSuite, sTimers[0].mExpiredAt == 10000);
+    NL_TEST_ASSERT(inSuite, !state.mEarly);
+
+    nl_timer_wheel_remove(&sWheel, &sTimers[0].mLink);
+    nl_timer_wheel_remove(&sWheel, &sTimers[1].mLink);
+    NL_TEST_ASSERT(inSuite, sWheel.mCount == 0);
+}
+
+static void TestStress(nlTestSuite *inSuite, void *inContext)
+{
+    nl_test_wheel_state_t   state = { &sWheel, 0x12345678, 0, false };
+    nl_time_native_t        end;
+    nl_time_native_t        previous;
+    int                     expected = 0;
+    bool                    late = false;
+    size_t                  i;
+
+    reset_timers();
+    nl_timer_wheel_init(&sWheel, state.mNow);
+    srand(1);
+
+    for (i = 0; i < kSTRESS_TIMERS; i++)
+    {
+        nl_timer_wheel_add(&sWheel, &sTimers[i].mLink, state.mNow + ((uint32_t)rand() % kSTRESS_SPAN));
+    }
+
+    for (i = 0; i < kSTRESS_TIMERS; i += 3)
+    {
+        nl_timer_wheel_remove(&sWheel, &sTimers[i].mLink);
+    }
+
+    for (i = 0; i < kSTRESS_TIMERS; i++)
+    {
+        if (nl_timer_wheel_is_pending(&sTimers[i].mLink))
+        {
+            expected++;
+        }
+    }
+
+    /* Advance in irregular steps, checking each timer expires in the
+     * first advance at or after its expiry
+     */
+
+    end = state.mNow + kSTRESS_SPAN;
+
+    while ((int32_t)(end - state.mNow) > 0)
+    {
+        previous = state.mNow;
+        state.mNow += 1 + ((uint32_t)rand() % 5000);
+
+        nl_timer_wheel_advance(&sWheel, state.mNow, ExpireHandler, &state);
+
+        for (i = 0; i < kSTRESS_TIMERS; i++)
+        {
+            if (nl_timer_wheel_is_pending(&sTimers[i].mLink) &&
+                ((int32_t)(state.mNow - sTimers[i].mLink.mExpires) >= 0))
+            {
+                late = true;
+            }
+
+            if ((sTimers[i].mExpiredCount != 0) && (sTimers[i].mExpiredAt == state.mNow) &&
+                ((int32_t)(previous - sTimers[i].mLink.mExpires) >= 0))
+            {
+                late = true;
+            }
+        }
+    }
+
+    NL_TEST_ASSERT(inSuite, state.mExpiredCount == expected);
+    NL_TEST_ASSERT(inSuite, sWheel.mCount == 0);
+    NL_TEST_ASSERT(inSuite, !state.mEarly);
+    NL_TEST_ASSERT(inSuite, !late);
+}
+
+static void TestSlack(nlTestSuite *inSuite, void *inContext)
+{
+    nl_time_native_t        expires;
+    nl_time_native_t        slack;
+    nl_time_native_t        chosen;
+    bool                    outside = false;
+    size_t                  i;
+
+    /* No slack leaves the expiry alone
+     */
+
+    NL_TEST_ASSERT(inSuite, nl_timer_wheel_apply_slack(1003, 0) == 1003);
+
+    /* The time with the most trailing zeros is chosen
+     */
+
+    NL_TEST_ASSERT(inSuite, nl_timer_wheel_apply_slack(1003, 20) == 1008);
+    NL_TEST_ASSERT(inSuite, nl_timer_wheel_apply_slack(1000, 100) == 1024);
+
+    /* Overlapping windows coalesce
+     */
+
+    NL_TEST_ASSERT(inSuite, nl_timer_wheel_apply_slack(1001, 30) == 1024);
+    NL_TEST_ASSERT(inSuite, nl_timer_wheel_apply_slack(1010, 20) == 1024);
+
+    /* Windows spanning the wrap of native time
+     */
+
+    NL_TEST_ASSERT(inSuite, nl_timer_wheel_apply_slack(UINT32_MAX - 15, 32) == 0);
+
+    /* The chosen time always lies within the window
+     */
+
+    srand(1);
+
+    for (i = 0; i < 10000; i++)
+    {
+        expires = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+        slack   = (uint32_t)rand() % 100000;
+        chosen  = nl_timer_wheel_apply_slack(expires, slack);
+
+        if ((chosen - expires) > slack)
+        {
+            outside = true;
+        }
+    }
+
+    NL_TEST_ASSERT(inSuite, !outside);
+}
+
+static const nlTest sTests[] = {
+    NL_TEST_DEF("add and remove",          TestAddAndRemove),
+    NL_TEST_DEF("cascade",                 TestCascade),
+    NL_TEST_DEF("repeat",                  TestRepeat),
+    NL_TEST_DEF("stress",                  TestStress),
+    NL_TEST_DEF("slack",                   TestSlack),
+    NL_TEST_SENTINEL()
+};
+
+int nler_timerwheel_test(void)
+{
+    nlTestSuite theSuite = {
+        "nlertimerwheel",
+        &sTests[0]
+    };
+
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+}
+
+int main(int argc, char **argv)
+{
+    int status;
+
+    nl_er_init();
+
+    NL_LOG_CRIT(lrTEST, "start main\n");
+
+    nl_er_start_running();
+
+    status = nler_timerwheel_test();
+
+    nl_er_cleanup();
+
+    NL_LOG_CRIT(lrTEST, "end main\n");
+
+    return (status);
+}
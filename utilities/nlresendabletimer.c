@@ -30,35 +30,98 @@
 #else
 
 #include "nlerassert.h"
+#include "nleratomicops.h"
 #include "nlercfg.h"
 #include "nlererror.h"
 #include "nlerlock.h"
 #include "nlerlog.h"
 #include "nlermacros.h"
+#include "nlermathutil.h"
+#include "nlertask.h"
 #include "nlresendabletimer.h"
 
-static bool sLockCreated;
-static nllock_t sLock;
+#include <stddef.h>
+#include <stdint.h>
 
-static void lock_enter(void)
+#define LOCKS_UNCREATED     0
+#define LOCKS_CREATING      1
+#define LOCKS_CREATED       2
+
+static intptr_t sLocksState;
+static nllock_t sLocks[NLER_RESENDABLE_TIMER_LOCKS];
+
+/* The locks are created by the first task to need one. Any other task
+ * needing one meanwhile sleeps until they are, rather than spin while
+ * a creator of lower priority is kept from finishing.
+ */
+static void create_locks(void)
+{
+    intptr_t state;
+    size_t i;
+
+    state = nl_er_atomic_cas(&sLocksState, LOCKS_UNCREATED, LOCKS_CREATING);
+
+    if (state == LOCKS_UNCREATED)
+    {
+        for (i = 0; i < NLER_RESENDABLE_TIMER_LOCKS; i++)
+        {
+            nllock_create(&sLocks[i]);
+        }
+
+        nl_er_atomic_cas(&sLocksState, LOCKS_CREATING, LOCKS_CREATED);
+    }
+    else
+    {
+        while (state != LOCKS_CREATED)
+        {
+            nltask_sleep_ms(1);
+
+            state = nl_er_atomic_cas(&sLocksState, LOCKS_CREATED, LOCKS_CREATED);
+        }
+    }
+}
+
+/* Each timer is guarded by the lock its address hashes to, such that
+ * operations on unrelated timers, as in a storm of retransmissions,
+ * mostly proceed without serializing on one another.
+ */
+static nllock_t *lock_for_timer(const nl_resendable_timer_t *aTimer)
+{
+#if NLER_RESENDABLE_TIMER_LOCKS > 1
+    return &sLocks[nl_hash_pointer(aTimer, NLER_RESENDABLE_TIMER_LOCKS)];
+#else
+    (void)aTimer;
+
+    return &sLocks[0];
+#endif
+}
+
+static nllock_t *lock_enter(const nl_resendable_timer_t *aTimer)
 {
-    if (!sLockCreated)
+    nllock_t *lock;
+
+    // the ordered read also makes the creating task's writes to the
+    // locks visible to this one.
+    if (nl_er_atomic_cas(&sLocksState, LOCKS_CREATED, LOCKS_CREATED) != LOCKS_CREATED)
     {
-        nllock_create(&sLock);
-        sLockCreated = true;
+        create_locks();
     }
 
-    nllock_enter(&sLock);
+    lock = lock_for_timer(aTimer);
+
+    nllock_enter(lock);
+
+    return lock;
 }
 
-static void lock_exit(void)
+static void lock_exit(nllock_t *aLock)
 {
-    nllock_exit(&sLock);
+    nllock_exit(aLock);
 }
 
 /**
  * This function reads values from aTimer, and must be called between
- * lock_enter() and lock_exit().
+ * lock_enter() and lock_exit() for aTimer.
  */
 static bool is_valid(nl_resendable_timer_t *aTimer)
 {
@@ -78,9 +141,10 @@ static bool is_valid(nl_resendable_timer_t *aTimer)
 
 int nl_resendable_timer_start(nl_resendable_timer_t *aTimer, nl_time_ms_t aTimeoutMS)
 {
+    nllock_t *lock;
     int retval;
 
-    lock_enter();
+    lock = lock_enter(aTimer);
 
     /* to keep precise records of every armed, canceled or re-armed timers the
      * combination of flags (NLER_TIMER_FLAG_REPEAT | NLER_TIMER_FLAG_DISPLACE)
@@ -100,41 +164,45 @@ int nl_resendable_timer_start(nl_resendable_timer_t *aTimer, nl_time_ms_t aTimeo
         aTimer->mActiveTimers--;
     }
 
-    lock_exit();
+    lock_exit(lock);
 
     return retval;
 }
 
 void nl_resendable_timer_cancel(nl_resendable_timer_t *aTimer)
 {
-    lock_enter();
+    nllock_t *lock;
+
+    lock = lock_enter(aTimer);
 
     if (aTimer->mActiveTimers > 0)
     {
         aTimer->mEventTimer.mFlags |= NLER_TIMER_FLAG_CANCEL_ECHO;
     }
 
-    lock_exit();
+    lock_exit(lock);
 }
 
 bool nl_resendable_timer_is_valid(nl_resendable_timer_t *aTimer)
 {
+    nllock_t *lock;
     bool retval;
 
-    lock_enter();
+    lock = lock_enter(aTimer);
 
     retval = is_valid(aTimer);
 
-    lock_exit();
+    lock_exit(lock);
 
     return retval;
 }
 
 int nl_resendable_timer_receive(nl_resendable_timer_t *aTimer)
 {
+    nllock_t *lock;
     int  retval;
 
-    lock_enter();
+    lock = lock_enter(aTimer);
 
     /* combination of flags (NLER_TIMER_FLAG_REPEAT | NLER_TIMER_FLAG_DISPLACE)
      * is not allowed - see description in nl_resendable_timer_start()
@@ -153,7 +221,7 @@ int nl_resendable_timer_receive(nl_resendable_timer_t *aTimer)
         aTimer->mActiveTimers--;
     }
 
-    lock_exit();
+    lock_exit(lock);
 
     return retval;
 }